@@ -0,0 +1,509 @@
+#pragma once
+
+#include <Geode/Result.hpp>
+#include <Geode/loader/Loader.hpp>
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "executor.hpp"
+#include "geode.hpp"
+
+/**
+ * Coroutines for launcher calls. The JNI work of each awaited call runs on the executor,
+ * and the coroutine resumes on the main thread once it is done.
+ */
+namespace launcher_utils {
+	template <typename T>
+	class AsyncTask;
+
+	struct FramePoolStats {
+		std::uint64_t allocations{};
+
+		/**
+		 * Allocations served by a previously freed frame.
+		 */
+		std::uint64_t reused{};
+	};
+
+	/**
+	 * Frame allocations made on the calling thread. Coroutines are usually created on the main thread.
+	 */
+	FramePoolStats getFramePoolStats();
+
+	namespace detail {
+		/**
+		 * Allocates coroutine frames from per-thread freelists, bucketed by size.
+		 * Frames too large for any bucket come from the global heap.
+		 */
+		void* allocateFrame(std::size_t size);
+		void freeFrame(void* frame, std::size_t size);
+
+		template <typename T>
+		struct ResultTraits : std::false_type {};
+
+		template <typename T, typename E>
+		struct ResultTraits<geode::Result<T, E>> : std::true_type {
+			using Value = T;
+			using Error = E;
+		};
+
+		/**
+		 * Part of the promise shared by every AsyncTask.
+		 * Coroutines are only resumed on the main thread, so none of this state is atomic.
+		 */
+		class PromiseBase {
+		public:
+			/**
+			 * Called once the coroutine finishes. Returns the coroutine to run next.
+			 */
+			using Continuation = std::coroutine_handle<> (*)(void* context);
+
+		private:
+			Continuation m_continuation{};
+			void* m_context{};
+			bool m_finished{false};
+			bool m_detached{false};
+
+		public:
+			static void* operator new(std::size_t size) {
+				return allocateFrame(size);
+			}
+
+			static void operator delete(void* frame, std::size_t size) {
+				freeFrame(frame, size);
+			}
+
+			std::suspend_never initial_suspend() noexcept {
+				return {};
+			}
+
+			void unhandled_exception() noexcept {
+				std::terminate();
+			}
+
+			bool finished() const {
+				return m_finished;
+			}
+
+			void detach() {
+				m_detached = true;
+			}
+
+			void setContinuation(Continuation continuation, void* context) {
+				m_continuation = continuation;
+				m_context = context;
+			}
+
+			/**
+			 * Marks the coroutine as finished, either at its end or at a failed co_await.
+			 * A detached coroutine is freed here, so the promise must not be touched afterwards.
+			 */
+			std::coroutine_handle<> complete(std::coroutine_handle<> self) noexcept {
+				m_finished = true;
+
+				if (m_continuation) {
+					return m_continuation(m_context);
+				}
+
+				if (m_detached) {
+					self.destroy();
+				}
+
+				return std::noop_coroutine();
+			}
+		};
+
+		struct FinalAwaiter {
+			bool await_ready() const noexcept {
+				return false;
+			}
+
+			template <typename P>
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<P> self) noexcept {
+				return self.promise().complete(self);
+			}
+
+			void await_resume() const noexcept {}
+		};
+
+		/**
+		 * Finishes the awaiting coroutine with an error instead of resuming it.
+		 */
+		template <typename P, typename E>
+		std::coroutine_handle<> propagateError(std::coroutine_handle<> awaiting, E&& error) {
+			auto handle = std::coroutine_handle<P>::from_address(awaiting.address());
+
+			handle.promise().fail(std::forward<E>(error));
+			return handle.promise().complete(handle);
+		}
+
+		/**
+		 * Awaits a geode::Result that is already available: yields the value, or finishes the coroutine with the error.
+		 */
+		template <typename T, typename E>
+		struct ResultAwaiter {
+			geode::Result<T, E> result;
+
+			bool await_ready() const noexcept {
+				return result.isOk();
+			}
+
+			template <typename P>
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<P> awaiting) {
+				return propagateError<P>(awaiting, std::move(result).unwrapErr());
+			}
+
+			T await_resume() {
+				return std::move(result).unwrap();
+			}
+		};
+
+		template <typename T>
+		class Promise final : public PromiseBase {
+		public:
+			std::optional<geode::Result<T>> result{};
+
+			AsyncTask<T> get_return_object();
+
+			FinalAwaiter final_suspend() noexcept {
+				return {};
+			}
+
+			void return_value(geode::Result<T> value) {
+				result.emplace(std::move(value));
+			}
+
+			template <typename E>
+			void fail(E&& error) {
+				static_assert(std::is_convertible_v<E, std::string>, "AsyncTask errors must be convertible to std::string");
+				result.emplace(geode::Err(std::string(std::forward<E>(error))));
+			}
+
+			template <typename U, typename E>
+			ResultAwaiter<U, E> await_transform(geode::Result<U, E> value) {
+				return {std::move(value)};
+			}
+
+			template <typename A> requires (!ResultTraits<std::remove_cvref_t<A>>::value)
+			A&& await_transform(A&& awaitable) {
+				return std::forward<A>(awaitable);
+			}
+		};
+
+		/**
+		 * Awaits another AsyncTask. With `Propagate`, an error finishes the awaiting coroutine instead of being returned.
+		 */
+		template <typename T, bool Propagate>
+		class TaskAwaiter {
+			std::coroutine_handle<Promise<T>> m_task;
+			std::coroutine_handle<> m_awaiting{};
+			std::coroutine_handle<> (*m_propagate)(TaskAwaiter&) = nullptr;
+
+			template <typename P>
+			static std::coroutine_handle<> propagate(TaskAwaiter& self) {
+				return propagateError<P>(self.m_awaiting, std::move(*self.m_task.promise().result).unwrapErr());
+			}
+
+			static std::coroutine_handle<> resume(void* context) {
+				auto& self = *static_cast<TaskAwaiter*>(context);
+
+				if constexpr (Propagate) {
+					if (self.m_task.promise().result->isErr()) {
+						return self.m_propagate(self);
+					}
+				}
+
+				return self.m_awaiting;
+			}
+
+		public:
+			explicit TaskAwaiter(std::coroutine_handle<Promise<T>> task) : m_task(task) {}
+
+			TaskAwaiter(const TaskAwaiter&) = delete;
+			TaskAwaiter& operator=(const TaskAwaiter&) = delete;
+
+			~TaskAwaiter() {
+				auto& promise = m_task.promise();
+				if (promise.finished()) {
+					m_task.destroy();
+				} else {
+					promise.setContinuation(nullptr, nullptr);
+					promise.detach();
+				}
+			}
+
+			bool await_ready() const noexcept {
+				auto& promise = m_task.promise();
+				if (!promise.finished()) {
+					return false;
+				}
+
+				if constexpr (Propagate) {
+					return promise.result->isOk();
+				} else {
+					return true;
+				}
+			}
+
+			template <typename P>
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<P> awaiting) {
+				m_awaiting = awaiting;
+
+				if constexpr (Propagate) {
+					m_propagate = &propagate<P>;
+				}
+
+				if (m_task.promise().finished()) {
+					return resume(this);
+				}
+
+				m_task.promise().setContinuation(&resume, this);
+				return std::noop_coroutine();
+			}
+
+			std::conditional_t<Propagate, T, geode::Result<T>> await_resume() {
+				if constexpr (Propagate) {
+					return std::move(*m_task.promise().result).unwrap();
+				} else {
+					return std::move(*m_task.promise().result);
+				}
+			}
+		};
+	}
+
+	/**
+	 * A coroutine returning a geode::Result. It starts running as soon as it is called, and resumes on the main thread
+	 * after each awaited launcher call.
+	 *
+	 * Inside the coroutine, `co_await` on a launcher call, another AsyncTask or a geode::Result yields the value
+	 * and finishes the coroutine early with the error, like GEODE_UNWRAP. Use `asResult()` to get the Result instead.
+	 *
+	 * Dropping the task doesn't cancel it: the coroutine runs to completion on its own and then frees itself.
+	 */
+	template <typename T = void>
+	class AsyncTask final {
+	public:
+		using promise_type = detail::Promise<T>;
+
+	private:
+		std::coroutine_handle<promise_type> m_handle{};
+
+		std::coroutine_handle<promise_type> release() {
+			return std::exchange(m_handle, nullptr);
+		}
+
+	public:
+		AsyncTask() = default;
+		explicit AsyncTask(std::coroutine_handle<promise_type> handle) : m_handle(handle) {}
+
+		AsyncTask(AsyncTask&& other) noexcept : m_handle(other.release()) {}
+
+		AsyncTask& operator=(AsyncTask&& other) noexcept {
+			if (this != &other) {
+				detach();
+				m_handle = other.release();
+			}
+
+			return *this;
+		}
+
+		AsyncTask(const AsyncTask&) = delete;
+		AsyncTask& operator=(const AsyncTask&) = delete;
+
+		~AsyncTask() {
+			detach();
+		}
+
+		bool valid() const {
+			return static_cast<bool>(m_handle);
+		}
+
+		bool isReady() const {
+			return m_handle.promise().finished();
+		}
+
+		/**
+		 * Result of a finished task.
+		 */
+		geode::Result<T>& result() {
+			return *m_handle.promise().result;
+		}
+
+		/**
+		 * Lets the coroutine finish on its own. The task is empty afterwards.
+		 */
+		void detach() {
+			if (!m_handle) {
+				return;
+			}
+
+			if (m_handle.promise().finished()) {
+				m_handle.destroy();
+			} else {
+				m_handle.promise().detach();
+			}
+
+			m_handle = nullptr;
+		}
+
+		detail::TaskAwaiter<T, true> operator co_await() && {
+			return detail::TaskAwaiter<T, true>(release());
+		}
+
+		/**
+		 * Awaits the task without propagating its error: `co_await` yields the geode::Result.
+		 */
+		auto asResult() && {
+			struct Awaitable {
+				AsyncTask task;
+
+				detail::TaskAwaiter<T, false> operator co_await() && {
+					return detail::TaskAwaiter<T, false>(task.release());
+				}
+			};
+
+			return Awaitable{std::move(*this)};
+		}
+	};
+
+	template <typename T>
+	AsyncTask<T> detail::Promise<T>::get_return_object() {
+		return AsyncTask<T>(std::coroutine_handle<Promise>::from_promise(*this));
+	}
+}
+
+namespace launcher_utils::jni {
+	namespace detail {
+		/**
+		 * Runs the call on the executor, then resumes the awaiting coroutine on the main thread.
+		 * The awaiter lives in the suspended coroutine's frame, so the worker writes the result straight into it.
+		 */
+		template <typename F, bool Propagate>
+		class ExecutorAwaiter {
+			using R = std::invoke_result_t<F&, JNIEnv*>;
+			using Traits = launcher_utils::detail::ResultTraits<R>;
+
+			static_assert(Traits::value, "a call awaited from an AsyncTask must return a geode::Result");
+
+			F m_function;
+			std::optional<R> m_result{};
+			std::coroutine_handle<> m_awaiting{};
+			std::coroutine_handle<> (*m_propagate)(ExecutorAwaiter&) = nullptr;
+
+			template <typename P>
+			static std::coroutine_handle<> propagate(ExecutorAwaiter& self) {
+				return launcher_utils::detail::propagateError<P>(self.m_awaiting, std::move(*self.m_result).unwrapErr());
+			}
+
+			void resume() {
+				if constexpr (Propagate) {
+					if (m_result->isErr()) {
+						m_propagate(*this).resume();
+						return;
+					}
+				}
+
+				m_awaiting.resume();
+			}
+
+		public:
+			explicit ExecutorAwaiter(F&& function) : m_function(std::move(function)) {}
+
+			bool await_ready() const noexcept {
+				return false;
+			}
+
+			template <typename P>
+			void await_suspend(std::coroutine_handle<P> awaiting) {
+				m_awaiting = awaiting;
+
+				if constexpr (Propagate) {
+					m_propagate = &propagate<P>;
+				}
+
+				Executor::get().enqueue([this](geode::Result<JNIEnv*>& env) {
+					m_result.emplace(runTask<R>(m_function, env));
+
+					geode::Loader::get()->queueInMainThread([this] {
+						resume();
+					});
+				});
+			}
+
+			std::conditional_t<Propagate, typename Traits::Value, R> await_resume() {
+				if constexpr (Propagate) {
+					return std::move(*m_result).unwrap();
+				} else {
+					return std::move(*m_result);
+				}
+			}
+		};
+	}
+
+	/**
+	 * A call to run on the executor from an AsyncTask. `function` receives the worker's JNIEnv and returns a geode::Result.
+	 */
+	template <typename F, bool Propagate = true>
+	class ExecutorCall final {
+		F m_function;
+
+	public:
+		explicit ExecutorCall(F&& function) : m_function(std::move(function)) {}
+
+		detail::ExecutorAwaiter<F, Propagate> operator co_await() && {
+			return detail::ExecutorAwaiter<F, Propagate>(std::move(m_function));
+		}
+
+		/**
+		 * Awaits the call without propagating its error: `co_await` yields the geode::Result.
+		 */
+		ExecutorCall<F, false> asResult() && {
+			return ExecutorCall<F, false>(std::move(m_function));
+		}
+	};
+
+	/**
+	 * Creates a call to await. The launcher class is cached from the calling thread first, see prepareAsyncCall.
+	 */
+	template <typename F>
+	ExecutorCall<std::decay_t<F>> onExecutor(F&& function) {
+		launcher_utils::detail::prepareAsyncCall();
+		return ExecutorCall<std::decay_t<F>>(std::decay_t<F>(std::forward<F>(function)));
+	}
+}
+
+/**
+ * Awaitable versions of launcher calls.
+ */
+namespace launcher_utils::coro {
+	inline auto createInputDevice(int deviceId) {
+		return jni::onExecutor([deviceId](JNIEnv*) {
+			return InputDevice::create(deviceId);
+		});
+	}
+
+	inline auto getConnectedDevices() {
+		return jni::onExecutor([](JNIEnv*) {
+			return launcher_utils::getConnectedDevices();
+		});
+	}
+
+	inline auto getConnectedControllerCount() {
+		return jni::onExecutor([](JNIEnv*) {
+			return launcher_utils::getConnectedControllerCount();
+		});
+	}
+
+	inline auto vibrate(std::int64_t ms) {
+		return jni::onExecutor([ms](JNIEnv*) {
+			return launcher_utils::vibrate(ms);
+		});
+	}
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "geode.hpp"
+
+namespace launcher_utils {
+	struct BatteryState {
+		bool hasBattery{};
+		float capacity{};
+		InputDevice::BatteryStatus status{InputDevice::BatteryStatus::Unknown};
+
+		bool operator==(const BatteryState&) const = default;
+	};
+
+	/**
+	 * Caches the battery state of input devices.
+	 * A device's state is fetched again once it is older than the TTL; when that happens,
+	 * every other stale device is refreshed in the same batch.
+	 * A failed fetch keeps the previous state, and the device is fetched again on the next query.
+	 * Listeners are only notified when a device's known battery state changes, not when it is first fetched.
+	 */
+	class BatteryMonitor final {
+	public:
+		using Callback = std::function<void(int deviceId, const BatteryState& state)>;
+
+	private:
+		struct Entry {
+			int deviceId;
+			BatteryState state;
+
+			/**
+			 * When the state was last fetched successfully, or the epoch if it never was.
+			 */
+			std::chrono::steady_clock::time_point updated;
+		};
+
+		std::mutex m_mutex{};
+		std::vector<Entry> m_entries{};
+		std::vector<std::pair<std::size_t, Callback>> m_listeners{};
+		std::size_t m_nextListenerId{1};
+		std::chrono::steady_clock::duration m_ttl{std::chrono::seconds(30)};
+
+		BatteryMonitor() = default;
+
+		Entry& findEntry(int deviceId);
+		/**
+		 * Fetches every stale device. Returns the error of the given device's fetch if it failed.
+		 */
+		std::optional<jni::Error> refreshStale(
+			std::chrono::steady_clock::time_point now, std::vector<std::pair<int, BatteryState>>& changed, int deviceId = -1
+		);
+		void notify(const std::vector<std::pair<int, BatteryState>>& changed);
+
+	public:
+		static BatteryMonitor& get();
+
+		BatteryMonitor(const BatteryMonitor&) = delete;
+		BatteryMonitor& operator=(const BatteryMonitor&) = delete;
+
+		/**
+		 * Sets how long a fetched battery state is reused for. Defaults to 30 seconds.
+		 */
+		void setTTL(std::chrono::steady_clock::duration ttl);
+
+		/**
+		 * Returns the battery state of a device, refreshing stale devices first if needed.
+		 * If refreshing fails, the previous state is returned. Fails if the state was never fetched.
+		 */
+		geode::Result<BatteryState> getState(int deviceId);
+
+		/**
+		 * Like getState, with the default state if it was never fetched.
+		 */
+		float getBatteryCapacity(int deviceId) {
+			return getState(deviceId).unwrapOrDefault().capacity;
+		}
+
+		InputDevice::BatteryStatus getBatteryStatus(int deviceId) {
+			return getState(deviceId).unwrapOrDefault().status;
+		}
+
+		bool hasBattery(int deviceId) {
+			return getState(deviceId).unwrapOrDefault().hasBattery;
+		}
+
+		/**
+		 * Refreshes every device whose state is older than the TTL.
+		 */
+		void refresh();
+
+		/**
+		 * Stops tracking a device, for example once it is disconnected.
+		 */
+		void forget(int deviceId);
+
+		/**
+		 * Registers a callback that is invoked when a tracked device's battery state changes.
+		 * Returns an id that can be passed to removeListener.
+		 */
+		std::size_t addListener(Callback callback);
+		void removeListener(std::size_t id);
+	};
+}
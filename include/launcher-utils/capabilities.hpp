@@ -0,0 +1,102 @@
+#pragma once
+
+#include <Geode/Result.hpp>
+
+#include <atomic>
+#include <cstdint>
+
+#include "jni.hpp"
+
+namespace launcher_utils {
+	/**
+	 * Groups of launcher methods used by the wrappers in geode.hpp. Older launchers may lack some of them.
+	 */
+	enum class Capability : std::uint32_t {
+		/** vibrateSupported and vibrate */
+		Vibrate,
+		/** vibratePattern */
+		VibratePattern,
+		/** getConnectedDevices and getDevice, used by InputDevice::create */
+		ConnectedDevices,
+		/** controllersConnected */
+		ControllerCount,
+		/** deviceHasBattery, getDeviceBatteryCapacity and getDeviceBatteryStatus */
+		DeviceBattery,
+		/** getDeviceLightsCount, getLightType and setDeviceLightColor */
+		DeviceLights,
+		/** getDeviceHapticsCount and vibrateDevice */
+		DeviceVibration,
+
+		Count
+	};
+
+	namespace detail {
+		inline constexpr std::uint64_t s_capabilitiesProbed = std::uint64_t{1} << 31;
+
+		/**
+		 * Set when probing failed because the launcher classes couldn't be found from the main thread.
+		 */
+		inline constexpr std::uint64_t s_capabilitiesUnavailable = std::uint64_t{1} << 30;
+
+		inline constexpr std::uint64_t s_capabilityBits = s_capabilitiesUnavailable - 1;
+
+		/**
+		 * Capability bits in the lower half, with s_capabilitiesProbed or s_capabilitiesUnavailable set once probed.
+		 * The upper half holds the ID cache epoch of the probe, so changing the JavaVM probes again.
+		 * A failed probe on the main thread is kept for the epoch too, so it isn't repeated on every query.
+		 * Failures on other threads aren't kept, as those threads may not see the launcher's classes.
+		 */
+		inline std::atomic_uint64_t s_capabilities{0};
+
+		/**
+		 * Probes unless this epoch was already probed. A failed probe is only repeated if `retryFailed` is set.
+		 */
+		std::uint64_t probeCapabilities(bool retryFailed);
+
+		/**
+		 * Returns the probe state for the current epoch, probing first if that hasn't happened yet.
+		 */
+		inline std::uint64_t getCapabilityState() {
+			auto state = detail::s_capabilities.load(std::memory_order_acquire);
+			if (!(state & (s_capabilitiesProbed | s_capabilitiesUnavailable)) || (state >> 32) != jni::detail::s_cacheEpoch.load(std::memory_order_relaxed)) {
+				state = detail::probeCapabilities(false);
+			}
+
+			return state;
+		}
+	}
+
+	/**
+	 * Resolves every launcher method used by this library, recording which capabilities are complete.
+	 * Methods that are missing are cached as missing, so calling them later fails without another lookup.
+	 * The library probes on the main thread once the mod has loaded, so this is only needed to retry a probe
+	 * that failed. It should run on the main thread: other threads can't find the launcher's classes.
+	 */
+	geode::Result<> probeCapabilities();
+
+	/**
+	 * Returns the supported capabilities as a bitset, with bit n set for the capability with value n.
+	 * Probes first if that hasn't happened yet. Empty if the probe failed.
+	 */
+	inline std::uint32_t getCapabilities() {
+		return static_cast<std::uint32_t>(detail::getCapabilityState() & detail::s_capabilityBits);
+	}
+
+	/**
+	 * Returns whether the launcher provides every method of a capability.
+	 */
+	inline bool supports(Capability capability) {
+		return (getCapabilities() >> static_cast<std::uint32_t>(capability)) & 1;
+	}
+
+	namespace detail {
+		/**
+		 * Returns whether the probe found the launcher lacking a capability.
+		 * Unlike `!supports`, this is false when the probe failed, as the capability is unknown rather than missing.
+		 */
+		inline bool lacksCapability(Capability capability) {
+			auto state = getCapabilityState();
+			return (state & s_capabilitiesProbed) && !((state >> static_cast<std::uint32_t>(capability)) & 1);
+		}
+	}
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "geode.hpp"
+
+namespace launcher_utils {
+	/**
+	 * Keeps the connected input devices, so that listing them doesn't cost a JNI call each time.
+	 * The device list is fetched once on first use, then updated from AndroidInputDeviceEvents as devices are added,
+	 * changed or removed. Each device's snapshot is fetched as it is added, so iterating, looking up a device and
+	 * reading its snapshot make no JNI calls.
+	 *
+	 * Must only be used on the main thread. Events are applied on the main thread at the start of the next frame.
+	 */
+	class DeviceRegistry final {
+		/**
+		 * Sorted by device id.
+		 */
+		std::vector<InputDevice> m_devices{};
+		std::uint64_t m_version{0};
+		bool m_seeded{false};
+
+		DeviceRegistry() = default;
+
+		void ensureSeeded();
+		void insert(InputDevice&& device);
+
+	public:
+		static DeviceRegistry& get();
+
+		DeviceRegistry(const DeviceRegistry&) = delete;
+		DeviceRegistry& operator=(const DeviceRegistry&) = delete;
+
+		/**
+		 * Connected devices, ordered by id. Invalidated by the next change to the registry.
+		 */
+		std::span<InputDevice> devices();
+
+		/**
+		 * Returns the connected device with the given id, or nullptr.
+		 */
+		InputDevice* find(int deviceId);
+
+		std::size_t size();
+
+		/**
+		 * Number of connected devices that are gamepads or joysticks.
+		 */
+		std::size_t controllerCount();
+
+		/**
+		 * Increases every time the set of devices changes, so a cached view of it can tell when to update.
+		 */
+		std::uint64_t version() const {
+			return m_version;
+		}
+
+		/**
+		 * Fetches a device again after it is added or changed, removing it if it is no longer connected.
+		 * Called for each AndroidInputDeviceEvent, so it rarely needs to be called directly.
+		 */
+		geode::Result<> update(int deviceId);
+
+		/**
+		 * Drops a device after it is removed.
+		 */
+		void remove(int deviceId);
+
+		/**
+		 * Drops every device and fetches the list again on next use, such as after changing the JavaVM provider.
+		 */
+		void clear();
+	};
+}
@@ -0,0 +1,315 @@
+#pragma once
+
+#include <Geode/Result.hpp>
+#include <Geode/loader/Loader.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "jni.hpp"
+
+/**
+ * Runs JNI calls on a dedicated, attached worker thread, so that the calling thread (usually the main thread)
+ * only pays for queueing the call.
+ */
+namespace launcher_utils::jni {
+	namespace detail {
+		/**
+		 * A unit of work on the executor's queue. Tasks are linked into the queue directly, so the queue itself never allocates.
+		 */
+		struct Task {
+			std::atomic<Task*> next{nullptr};
+			std::chrono::steady_clock::time_point submitted{};
+
+			virtual ~Task() = default;
+
+			/**
+			 * Runs the task with the worker's environment, or the error from attaching the worker.
+			 */
+			virtual void run(geode::Result<JNIEnv*>&) {}
+
+			/**
+			 * Called by the worker once the task has run.
+			 */
+			virtual void destroy() {
+				delete this;
+			}
+		};
+
+		template <typename F>
+		struct FunctionTask final : Task {
+			F function;
+
+			template <typename G>
+			explicit FunctionTask(G&& function) : function(std::forward<G>(function)) {}
+
+			void run(geode::Result<JNIEnv*>& env) override {
+				function(env);
+			}
+		};
+
+		/**
+		 * Intrusive multi-producer, single-consumer queue (Vyukov's algorithm).
+		 * Pushing is wait-free. Popping may briefly report an empty queue while a push is halfway done.
+		 */
+		class TaskQueue final {
+			std::atomic<Task*> m_head;
+			Task* m_tail;
+			Task m_stub{};
+
+		public:
+			TaskQueue() : m_head(&m_stub), m_tail(&m_stub) {}
+
+			TaskQueue(const TaskQueue&) = delete;
+			TaskQueue& operator=(const TaskQueue&) = delete;
+
+			void push(Task* task);
+
+			/**
+			 * Removes the oldest task. Must only be called from the consuming thread.
+			 */
+			Task* pop();
+		};
+
+		/**
+		 * Result shared between a Future and its task, freed once both have released it.
+		 */
+		template <typename T>
+		class FutureState {
+			std::atomic_uint32_t m_refs{2};
+
+		public:
+			std::atomic_bool ready{false};
+			std::optional<T> value{};
+
+			virtual ~FutureState() = default;
+
+			void set(T&& result) {
+				value.emplace(std::move(result));
+				ready.store(true, std::memory_order_release);
+				ready.notify_all();
+			}
+
+			void release() {
+				if (m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+					delete this;
+				}
+			}
+		};
+
+		template <typename R, typename F>
+		R runTask(F& function, geode::Result<JNIEnv*>& env) {
+			if (!env) {
+				return geode::Err(env.unwrapErr());
+			}
+
+			return function(env.unwrap());
+		}
+
+		/**
+		 * A task and the state of its future in one allocation.
+		 */
+		template <typename R, typename F>
+		struct FutureTask final : Task, FutureState<R> {
+			F function;
+
+			template <typename G>
+			explicit FutureTask(G&& function) : function(std::forward<G>(function)) {}
+
+			void run(geode::Result<JNIEnv*>& env) override {
+				this->set(runTask<R>(function, env));
+			}
+
+			void destroy() override {
+				this->release();
+			}
+		};
+	}
+
+	/**
+	 * Result of a call queued on the Executor.
+	 * The state is allocated together with the queued task, and unlike std::future, checking for the result does not lock.
+	 * A future that is default constructed, moved from or already read has no state: it is never ready, doesn't wait,
+	 * and `get` returns an error.
+	 */
+	template <typename T>
+	class Future final {
+		detail::FutureState<T>* m_state{};
+
+	public:
+		Future() = default;
+		explicit Future(detail::FutureState<T>* state) : m_state(state) {}
+
+		Future(Future&& other) noexcept : m_state(std::exchange(other.m_state, nullptr)) {}
+
+		Future& operator=(Future&& other) noexcept {
+			if (this != &other) {
+				if (m_state) {
+					m_state->release();
+				}
+
+				m_state = std::exchange(other.m_state, nullptr);
+			}
+
+			return *this;
+		}
+
+		Future(const Future&) = delete;
+		Future& operator=(const Future&) = delete;
+
+		~Future() {
+			if (m_state) {
+				m_state->release();
+			}
+		}
+
+		bool valid() const {
+			return m_state != nullptr;
+		}
+
+		bool isReady() const {
+			return m_state && m_state->ready.load(std::memory_order_acquire);
+		}
+
+		void wait() const {
+			if (m_state) {
+				m_state->ready.wait(false, std::memory_order_acquire);
+			}
+		}
+
+		/**
+		 * Waits for the result and moves it out of the future. Can only be called once, after which the future is no longer valid.
+		 */
+		T get() {
+			if (!m_state) {
+				return geode::Err("Future::get: the future has no state");
+			}
+
+			wait();
+
+			auto r = std::move(*m_state->value);
+
+			m_state->release();
+			m_state = nullptr;
+
+			return r;
+		}
+	};
+
+	struct ExecutorStats {
+		std::uint64_t submitted{};
+		std::uint64_t completed{};
+
+		/**
+		 * Tasks waiting to run when the stats were taken, and the most that were waiting at once.
+		 */
+		std::size_t queueDepth{};
+		std::size_t maxQueueDepth{};
+
+		/**
+		 * Time from submitting a task until it started running.
+		 */
+		std::uint64_t totalWaitNanoseconds{};
+		std::uint64_t maxWaitNanoseconds{};
+
+		std::uint64_t totalRunNanoseconds{};
+		std::uint64_t maxRunNanoseconds{};
+	};
+
+	/**
+	 * A single worker thread running queued JNI calls in submission order.
+	 * The thread is started on the first submission and attached to the JVM for as long as it runs.
+	 * The executor is never destroyed, as joining its worker during static destruction could wait on a call into a JVM
+	 * that is shutting down. Call shutdown to stop the worker before then.
+	 */
+	class Executor final {
+		detail::TaskQueue m_queue{};
+		std::atomic_size_t m_depth{0};
+
+		std::thread m_thread{};
+		std::atomic_bool m_running{false};
+		std::atomic_bool m_sleeping{false};
+		bool m_stopping{false};
+		std::mutex m_mutex{};
+		std::condition_variable m_wake{};
+
+		std::atomic_uint64_t m_submitted{0};
+		std::atomic_uint64_t m_completed{0};
+		std::atomic_size_t m_maxDepth{0};
+		std::atomic_uint64_t m_totalWait{0};
+		std::atomic_uint64_t m_maxWait{0};
+		std::atomic_uint64_t m_totalRun{0};
+		std::atomic_uint64_t m_maxRun{0};
+
+		Executor() = default;
+
+		void push(detail::Task* task);
+		void start();
+		void run();
+
+	public:
+		static Executor& get();
+
+		Executor(const Executor&) = delete;
+		Executor& operator=(const Executor&) = delete;
+
+		/**
+		 * Queues a call. `function` receives the worker's JNIEnv and must return a geode::Result,
+		 * which is delivered through the returned future.
+		 */
+		template <typename F>
+		Future<std::invoke_result_t<F&, JNIEnv*>> submit(F&& function) {
+			using R = std::invoke_result_t<F&, JNIEnv*>;
+
+			auto task = new detail::FutureTask<R, std::decay_t<F>>(std::forward<F>(function));
+			push(task);
+
+			return Future<R>(task);
+		}
+
+		/**
+		 * Queues a task that receives the worker's environment, or the error from attaching the worker, and returns nothing.
+		 * The result is up to the task to deliver.
+		 */
+		template <typename F>
+		void enqueue(F&& task) {
+			push(new detail::FunctionTask<std::decay_t<F>>(std::forward<F>(task)));
+		}
+
+		/**
+		 * Queues a call, passing its result to `onComplete` on the main thread once it finishes.
+		 */
+		template <typename F, typename C>
+		void submit(F&& function, C&& onComplete) {
+			using R = std::invoke_result_t<F&, JNIEnv*>;
+
+			enqueue([function = std::forward<F>(function), onComplete = std::forward<C>(onComplete)](geode::Result<JNIEnv*>& env) mutable {
+				geode::Loader::get()->queueInMainThread([onComplete = std::move(onComplete), result = detail::runTask<R>(function, env)]() mutable {
+					onComplete(std::move(result));
+				});
+			});
+		}
+
+		/**
+		 * Blocks until every task submitted before this call has run.
+		 */
+		void drain();
+
+		/**
+		 * Runs the remaining tasks, then stops and detaches the worker thread. A later submission starts it again.
+		 * Must not be called while other threads are submitting.
+		 */
+		void shutdown();
+
+		ExecutorStats stats() const;
+		void resetStats();
+	};
+}
@@ -3,47 +3,110 @@
 #include <Geode/Result.hpp>
 
 #include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
 #include <vector>
 #include <span>
 
+#include "capabilities.hpp"
+#include "executor.hpp"
 #include "jni.hpp"
 
 namespace launcher_utils {
+	namespace detail {
+		/**
+		 * Total number of device change events received so far.
+		 */
+		std::uint64_t getDeviceChangeCount();
+
+		/**
+		 * Value of the change count when the given device last changed, or 0 if it never has.
+		 */
+		std::uint64_t getDeviceGeneration(int deviceId);
+
+		/**
+		 * Caches the launcher class from the calling thread before a call is queued on the executor.
+		 * FindClass on the executor's thread would use the system class loader, which can't see launcher classes.
+		 */
+		void prepareAsyncCall();
+
+		/**
+		 * Fails without calling into Java when the launcher lacks a capability, see lacksCapability.
+		 */
+		inline geode::Result<> requireCapability(Capability capability, const char* function) {
+			if (lacksCapability(capability)) {
+				return geode::Err(std::string(function) + ": not supported by this launcher");
+			}
+
+			return geode::Ok();
+		}
+	}
+
+	/**
+	 * Receives the result of an async launcher call on the main thread.
+	 */
+	using AsyncCallback = std::function<void(geode::Result<>)>;
+
+	class HapticsScheduler;
+
 	class InputDevice final {
+		friend class HapticsScheduler;
+
 	private:
 		int m_deviceId;
 		jni::GlobalRef m_inputDevice{};
+		std::uint64_t m_deviceGeneration{};
 
-		InputDevice(int deviceId, jni::GlobalRef&& inputDevice) : m_deviceId(deviceId), m_inputDevice(std::move(inputDevice)) {}
+		InputDevice(int deviceId, jni::GlobalRef&& inputDevice, std::uint64_t generation)
+			: m_deviceId(deviceId), m_inputDevice(std::move(inputDevice)), m_deviceGeneration(generation) {}
 
 	public:
+		/**
+		 * Returns an error for a device that isn't connected, rather than a device wrapping a null reference.
+		 */
 		static geode::Result<InputDevice> create(int deviceId) {
+			GEODE_UNWRAP(detail::requireCapability(Capability::ConnectedDevices, "InputDevice::create"));
 			GEODE_UNWRAP_INTO(auto env, jni::getEnv());
-			GEODE_UNWRAP_INTO(auto obj, jni::callStaticMethod<jobject>(env, "com/geode/launcher/utils/GeodeUtils", "getDevice", "(I)Landroid/view/InputDevice;", deviceId));
+
+			// read first, so a change that lands during the call is picked up by the next snapshot
+			auto generation = detail::getDeviceGeneration(deviceId);
+			GEODE_UNWRAP_INTO(auto obj, jni::callStaticMethod<jni::Object<"android/view/InputDevice">(jint), "com/geode/launcher/utils/GeodeUtils", "getDevice">(env, deviceId));
+			if (!obj) {
+				return geode::Err("InputDevice::create: device not connected");
+			}
 
 			auto ref = jni::GlobalRef(*obj);
 
-			return geode::Ok(std::move(InputDevice(deviceId, std::move(ref))));
+			return geode::Ok(std::move(InputDevice(deviceId, std::move(ref), generation)));
 		}
 
 		std::string getDescriptor() {
-			return jni::callMethod<std::string>("android/view/InputDevice", "getDescriptor", "()Ljava/lang/String;", *m_inputDevice).unwrapOrDefault();
+			return jni::invokeMethod<std::string(), "android/view/InputDevice", "getDescriptor">(*m_inputDevice).unwrapOrDefault();
 		}
 
 		std::string getName() {
-			return jni::callMethod<std::string>("android/view/InputDevice", "getName", "()Ljava/lang/String;", *m_inputDevice).unwrapOrDefault();
+			return jni::invokeMethod<std::string(), "android/view/InputDevice", "getName">(*m_inputDevice).unwrapOrDefault();
 		}
 
 		int getVendorId() {
-			return jni::callMethod<int>("android/view/InputDevice", "getVendorId", "()I", *m_inputDevice).unwrapOrDefault();
+			return jni::invokeMethod<jint(), "android/view/InputDevice", "getVendorId">(*m_inputDevice).unwrapOrDefault();
 		}
 
 		int getProductId() {
-			return jni::callMethod<int>("android/view/InputDevice", "getProductId", "()I", *m_inputDevice).unwrapOrDefault();
+			return jni::invokeMethod<jint(), "android/view/InputDevice", "getProductId">(*m_inputDevice).unwrapOrDefault();
 		}
 
+		/**
+		 * The battery getters call into the launcher on every call. Code that polls them, such as a battery indicator
+		 * updated each frame, should use BatteryMonitor from battery.hpp instead, which caches the state and batches refreshes.
+		 */
 		float getBatteryCapacity() {
-			return jni::callStaticMethod<float>("com/geode/launcher/utils/GeodeUtils", "getDeviceBatteryCapacity", "(I)F", m_deviceId).unwrapOrDefault();
+			if (detail::lacksCapability(Capability::DeviceBattery)) {
+				return 0.0f;
+			}
+
+			return jni::invokeStaticMethod<jfloat(jint), "com/geode/launcher/utils/GeodeUtils", "getDeviceBatteryCapacity">(m_deviceId).unwrapOrDefault();
 		}
 
 		enum class BatteryStatus {
@@ -55,13 +118,21 @@ namespace launcher_utils {
 		};
 
 		BatteryStatus getBatteryStatus() {
+			if (detail::lacksCapability(Capability::DeviceBattery)) {
+				return BatteryStatus::Unknown;
+			}
+
 			return static_cast<BatteryStatus>(
-				jni::callStaticMethod<int>("com/geode/launcher/utils/GeodeUtils", "getDeviceBatteryStatus", "(I)I", m_deviceId).unwrapOr(1)
+				jni::invokeStaticMethod<jint(jint), "com/geode/launcher/utils/GeodeUtils", "getDeviceBatteryStatus">(m_deviceId).unwrapOr(1)
 			);
 		}
 
 		bool hasBattery() {
-			return jni::callStaticMethod<bool>("com/geode/launcher/utils/GeodeUtils", "deviceHasBattery", "(I)Z", m_deviceId).unwrapOrDefault();
+			if (detail::lacksCapability(Capability::DeviceBattery)) {
+				return false;
+			}
+
+			return jni::invokeStaticMethod<bool(jint), "com/geode/launcher/utils/GeodeUtils", "deviceHasBattery">(m_deviceId).unwrapOrDefault();
 		}
 
 		enum class Source {
@@ -83,7 +154,7 @@ namespace launcher_utils {
 
 		Source getSources() {
 			return static_cast<Source>(
-				jni::callMethod<int>("android/view/InputDevice", "getSources", "()I", *m_inputDevice).unwrapOrDefault()
+				jni::invokeMethod<jint(), "android/view/InputDevice", "getSources">(*m_inputDevice).unwrapOrDefault()
 			);
 		}
 
@@ -95,30 +166,118 @@ namespace launcher_utils {
 		};
 
 		int getLightCount() {
-			return jni::callStaticMethod<int>("com/geode/launcher/utils/GeodeUtils", "getDeviceLightsCount", "(I)I", m_deviceId).unwrapOrDefault();
+			if (detail::lacksCapability(Capability::DeviceLights)) {
+				return 0;
+			}
+
+			return jni::invokeStaticMethod<jint(jint), "com/geode/launcher/utils/GeodeUtils", "getDeviceLightsCount">(m_deviceId).unwrapOrDefault();
 		}
 
 		ControllerLightType getLightType() {
+			if (detail::lacksCapability(Capability::DeviceLights)) {
+				return ControllerLightType::None;
+			}
+
 			return static_cast<ControllerLightType>(
-				jni::callStaticMethod<int>("com/geode/launcher/utils/GeodeUtils", "getLightType", "(I)I", m_deviceId).unwrapOrDefault()
+				jni::invokeStaticMethod<jint(jint), "com/geode/launcher/utils/GeodeUtils", "getLightType">(m_deviceId).unwrapOrDefault()
 			);
 		}
 
 		geode::Result<> setLights(ControllerLightType type, std::uint32_t color) {
-			GEODE_UNWRAP_INTO(auto r, jni::callStaticMethod<bool>("com/geode/launcher/utils/GeodeUtils", "setDeviceLightColor", "(III)Z", m_deviceId, static_cast<jint>(color), static_cast<jint>(type)));
-			if (!r) {
-				return geode::Err("call failed");
-			}
-
-			return geode::Ok();
+			GEODE_UNWRAP_INTO(auto env, jni::getEnv());
+			return performSetLights(env, m_deviceId, type, color);
 		}
 
+		/**
+		 * Queues setLights on the JNI executor, so the calling thread doesn't wait for it.
+		 */
+		jni::Future<geode::Result<>> setLightsAsync(ControllerLightType type, std::uint32_t color);
+
+		/**
+		 * Queues setLights on the JNI executor, then passes its result to `onComplete` on the main thread.
+		 */
+		void setLightsAsync(ControllerLightType type, std::uint32_t color, AsyncCallback onComplete);
+
 		int getMotorCount() {
-			return jni::callStaticMethod<int>("com/geode/launcher/utils/GeodeUtils", "getDeviceHapticsCount", "(I)I", m_deviceId).unwrapOrDefault();
+			if (detail::lacksCapability(Capability::DeviceVibration)) {
+				return 0;
+			}
+
+			return jni::invokeStaticMethod<jint(jint), "com/geode/launcher/utils/GeodeUtils", "getDeviceHapticsCount">(m_deviceId).unwrapOrDefault();
 		}
 
 		geode::Result<> vibrateDevice(std::int64_t durationMs, int intensity, int motorIdx = -1) {
-			GEODE_UNWRAP_INTO(auto r, jni::callStaticMethod<bool>("com/geode/launcher/utils/GeodeUtils", "vibrateDevice", "(IJII)Z", m_deviceId, durationMs, intensity, motorIdx));
+			GEODE_UNWRAP_INTO(auto env, jni::getEnv());
+			return performVibrateDevice(env, m_deviceId, durationMs, intensity, motorIdx);
+		}
+
+		/**
+		 * Queues vibrateDevice on the JNI executor, so the calling thread doesn't wait for it.
+		 */
+		jni::Future<geode::Result<>> vibrateDeviceAsync(std::int64_t durationMs, int intensity, int motorIdx = -1);
+
+		/**
+		 * Queues vibrateDevice on the JNI executor, then passes its result to `onComplete` on the main thread.
+		 */
+		void vibrateDeviceAsync(std::int64_t durationMs, int intensity, int motorIdx, AsyncCallback onComplete);
+
+		int getDeviceId() const {
+			return m_deviceId;
+		}
+
+		/**
+		 * Properties of a device that only change when the device is reconfigured.
+		 */
+		struct Info {
+			std::string descriptor{};
+			std::string name{};
+			int vendorId{};
+			int productId{};
+			Source sources{};
+			int lightCount{};
+			ControllerLightType lightType{};
+			int motorCount{};
+		};
+
+		/**
+		 * Returns the device's properties, fetched together in one pass.
+		 * The result is kept until an AndroidInputDeviceEvent reports that this device changed. As Android's
+		 * InputDevice objects never change, the device is then fetched again as well.
+		 */
+		const Info& snapshot() {
+			auto changes = detail::getDeviceChangeCount();
+			if (m_info && m_infoChangeCount == changes) {
+				return *m_info;
+			}
+
+			auto generation = detail::getDeviceGeneration(m_deviceId);
+			if (!m_info || m_infoGeneration != generation) {
+				m_info = fetchInfo(generation);
+				m_infoGeneration = generation;
+			}
+
+			m_infoChangeCount = changes;
+
+			return *m_info;
+		}
+
+		/**
+		 * Forces the next call to snapshot to fetch the device's properties again.
+		 */
+		void invalidateSnapshot() {
+			m_info.reset();
+		}
+
+	private:
+		std::optional<Info> m_info{};
+		std::uint64_t m_infoGeneration{};
+		std::uint64_t m_infoChangeCount{};
+
+		Info fetchInfo(std::uint64_t generation);
+
+		static geode::Result<> performSetLights(JNIEnv* env, int deviceId, ControllerLightType type, std::uint32_t color) {
+			GEODE_UNWRAP(detail::requireCapability(Capability::DeviceLights, "InputDevice::setLights"));
+			GEODE_UNWRAP_INTO(auto r, jni::callStaticMethod<bool(jint, jint, jint), "com/geode/launcher/utils/GeodeUtils", "setDeviceLightColor">(env, deviceId, static_cast<jint>(color), static_cast<jint>(type)));
 			if (!r) {
 				return geode::Err("call failed");
 			}
@@ -126,8 +285,14 @@ namespace launcher_utils {
 			return geode::Ok();
 		}
 
-		int getDeviceId() const {
-			return m_deviceId;
+		static geode::Result<> performVibrateDevice(JNIEnv* env, int deviceId, std::int64_t durationMs, int intensity, int motorIdx) {
+			GEODE_UNWRAP(detail::requireCapability(Capability::DeviceVibration, "InputDevice::vibrateDevice"));
+			GEODE_UNWRAP_INTO(auto r, jni::callStaticMethod<bool(jint, jlong, jint, jint), "com/geode/launcher/utils/GeodeUtils", "vibrateDevice">(env, deviceId, durationMs, intensity, motorIdx));
+			if (!r) {
+				return geode::Err("call failed");
+			}
+
+			return geode::Ok();
 		}
 	};
 
@@ -142,8 +307,22 @@ namespace launcher_utils {
 	geode::Result<int> getConnectedControllerCount();
 	geode::Result<std::vector<int>> getConnectedDevices();
 
+	/**
+	 * Writes the connected device ids into `out`, reusing its capacity.
+	 */
+	geode::Result<> getConnectedDevices(std::vector<int>& out);
+
 	geode::Result<bool> vibrateSupported();
 	geode::Result<> vibrate(std::int64_t ms);
 	geode::Result<> vibratePattern(std::span<std::int64_t> pattern, int repeat);
+
+	/**
+	 * Async versions of vibrate and vibratePattern, run on the JNI executor.
+	 * The callback overloads deliver the result on the main thread.
+	 */
+	jni::Future<geode::Result<>> vibrateAsync(std::int64_t ms);
+	void vibrateAsync(std::int64_t ms, AsyncCallback onComplete);
+	jni::Future<geode::Result<>> vibratePatternAsync(std::vector<std::int64_t> pattern, int repeat);
+	void vibratePatternAsync(std::vector<std::int64_t> pattern, int repeat, AsyncCallback onComplete);
 };
 
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "geode.hpp"
+
+namespace launcher_utils {
+	struct HapticsStats {
+		std::uint64_t requests{};
+
+		/**
+		 * Launcher calls sent. Every request after the first on a device within a frame is merged into the same call.
+		 */
+		std::uint64_t calls{};
+
+		/**
+		 * Flushes that held a device back because its last call was too recent.
+		 */
+		std::uint64_t rateLimited{};
+
+		std::uint64_t failedCalls{};
+	};
+
+	/**
+	 * Collects vibration requests over a frame and sends them as one launcher call per device and motor.
+	 * Each launcher call cancels the vibration before it, so requests that overlap are merged:
+	 * the merged vibration lasts as long as their union and uses the highest intensity.
+	 * A call for one motor also cancels a vibration of all motors, so once a device gets requests for single motors,
+	 * its all-motors requests are merged into each of its motors.
+	 *
+	 * A flush is queued on the main thread with the first request of a frame, and the calls run on the JNI executor.
+	 * Calls to a device are also limited to a maximum rate; requests that arrive sooner wait for a later frame.
+	 */
+	class HapticsScheduler final {
+	public:
+		/**
+		 * Device id of the phone's own vibrator.
+		 */
+		static constexpr int s_phone = -1;
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		struct Pulse {
+			Clock::time_point start;
+			Clock::time_point end;
+			int intensity;
+
+			/**
+			 * Order of the request, to tell whether it came before a cancel on another channel.
+			 */
+			std::uint64_t sequence{};
+		};
+
+		struct Channel {
+			int deviceId;
+			int motorIdx;
+
+			std::vector<Pulse> pending{};
+
+			/**
+			 * Vibration sent by the last call, which the next call replaces.
+			 */
+			std::vector<Pulse> playing{};
+
+			bool cancel{false};
+			std::uint64_t cancelSequence{};
+
+			/**
+			 * Motors of the device, only known for all-motors channels.
+			 */
+			int motorCount{};
+		};
+
+		struct MotorCount {
+			int deviceId;
+			std::uint64_t generation;
+			int count;
+		};
+
+		struct Call {
+			int deviceId;
+			int motorIdx;
+			int intensity;
+			std::int64_t durationMs;
+
+			/**
+			 * Off/on timings, only used for the phone's vibrator.
+			 */
+			std::vector<std::int64_t> pattern{};
+		};
+
+		mutable std::mutex m_mutex{};
+		std::vector<Channel> m_channels{};
+		std::vector<std::pair<int, Clock::time_point>> m_lastCalls{};
+		std::vector<MotorCount> m_motorCounts{};
+		Clock::duration m_minInterval{std::chrono::milliseconds(50)};
+		bool m_flushQueued{false};
+		std::uint64_t m_sequence{0};
+
+		HapticsStats m_stats{};
+		std::atomic_uint64_t m_failedCalls{0};
+
+		HapticsScheduler() = default;
+
+		Channel& findChannel(int deviceId, int motorIdx);
+		int lookupMotorCount(int deviceId);
+		void request(int deviceId, int motorIdx, std::int64_t durationMs, int intensity, std::int64_t delayMs);
+		void queueFlush();
+		void mergeMotorChannels();
+		bool compile(Channel& channel, Clock::time_point now, std::vector<Call>& calls);
+		void send(std::vector<Call>&& calls);
+
+	public:
+		static HapticsScheduler& get();
+
+		HapticsScheduler(const HapticsScheduler&) = delete;
+		HapticsScheduler& operator=(const HapticsScheduler&) = delete;
+
+		/**
+		 * Vibrates the phone, starting after `delayMs`. A duration of 0 cancels the vibration.
+		 */
+		void vibrate(std::int64_t durationMs, std::int64_t delayMs = 0);
+
+		/**
+		 * Vibrates a motor of an input device, or all of them with `motorIdx` -1, starting after `delayMs`.
+		 * A duration or intensity of 0 cancels the vibration. For all motors, the device's motor count is fetched
+		 * on the calling thread the first time, and again after the device changes.
+		 */
+		void vibrateDevice(int deviceId, std::int64_t durationMs, int intensity, int motorIdx = -1, std::int64_t delayMs = 0);
+
+		/**
+		 * Sets how many calls a single device may receive per second. Defaults to 20.
+		 */
+		void setMaxCallRate(double callsPerSecond);
+
+		/**
+		 * Sends the requests collected so far. This happens on its own once per frame, so calling it is only
+		 * needed to send requests sooner. Must be called on the main thread.
+		 */
+		void flush();
+		void flush(Clock::time_point now);
+
+		/**
+		 * Drops the pending requests of a device, for example once it is disconnected.
+		 */
+		void forget(int deviceId);
+
+		HapticsStats stats() const;
+		void resetStats();
+	};
+}
@@ -3,38 +3,124 @@
 #include <Geode/Result.hpp>
 #include <Geode/cocos/platform/android/jni/JniHelper.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ranges>
 #include <vector>
 #include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <variant>
 
 namespace launcher_utils::jni {
 	/**
 	 * Pulls the JNIEnv from cocos2d's JniHelper.
-	 * Unlike cocos2d's JniHelper, this function will not automatically move the environment to the calling thread.
+	 * Unlike cocos2d's JniHelper, this function will not automatically move the environment to the calling thread,
+	 * unless automatic attachment is enabled through setAutoAttach.
 	 */
 	geode::Result<JNIEnv*> getEnv();
 
+	using JavaVMProvider = JavaVM* (*)();
+
+	/**
+	 * Replaces where getEnv gets its JavaVM from. Passing nullptr restores cocos2d's JniHelper.
+	 * Cached class and method IDs belong to the previous VM, so the ID cache is reset.
+	 * This must not be called while other threads are using JNI.
+	 */
+	void setJavaVMProvider(JavaVMProvider provider);
+
+	/**
+	 * Returns the JavaVM used by getEnv.
+	 */
+	JavaVM* getJavaVM();
+
+	/**
+	 * Enables or disables automatic thread attachment in getEnv (disabled by default).
+	 * When enabled, a thread without an environment is attached once, and is detached again when the thread exits.
+	 * Note that FindClass on an attached thread uses the system class loader, so launcher classes must already be cached.
+	 */
+	void setAutoAttach(bool enabled);
+
+	struct AttachStats {
+		std::uint64_t attached{};
+		std::uint64_t detached{};
+	};
+
+	/**
+	 * Returns how many threads getEnv has attached and detached.
+	 */
+	AttachStats getAttachStats();
+
+	namespace detail {
+		/**
+		 * Like getEnv, but attaches the calling thread even if automatic attachment is disabled.
+		 */
+		geode::Result<JNIEnv*> attachCurrentThread();
+
+		/**
+		 * Returns whether getEnv attached the calling thread, which can't see the launcher's classes.
+		 */
+		bool isAttachedThread();
+
+		/**
+		 * Number of LocalFrames active on the current thread.
+		 */
+		inline thread_local int s_localFrameDepth = 0;
+
+		/**
+		 * Incremented whenever the ID cache is reset. MethodInfos from an older epoch must be looked up again.
+		 */
+		inline std::atomic_uint32_t s_cacheEpoch{0};
+	}
+
 	/**
 	 * Stores a local reference to an object.
 	 * This class does not create a new local reference, but will destroy the given reference once out of scope.
 	 * You should not store a LocalRef for longer than a single frame. Use a GlobalRef for long-term storage.
+	 * References wrapped with `created` while a LocalFrame is active are left for the frame to release.
 	 */
 	class LocalRef final {
 		jobject m_obj{};
+		bool m_framed{};
+
+		LocalRef(jobject obj, bool framed) : m_obj(obj), m_framed(framed) {}
 
 	public:
 		LocalRef() : m_obj(nullptr) {}
 
+		/**
+		 * Takes ownership of a reference, deleting it once out of scope even inside a LocalFrame,
+		 * as the reference may have been created outside of the frame.
+		 */
 		LocalRef(jobject obj) : m_obj(obj) {}
 
+		/**
+		 * Wraps a reference that was just returned by JNI on this thread, so it belongs to the innermost LocalFrame
+		 * if one is active, and is left for that frame to release.
+		 */
+		static LocalRef created(jobject obj) {
+			return LocalRef(obj, detail::s_localFrameDepth > 0);
+		}
+
 		LocalRef(const LocalRef&) = delete;
 		LocalRef& operator=(const LocalRef&) = delete;
 
 		LocalRef(LocalRef&& x) {
 			std::swap(x.m_obj, m_obj);
+			std::swap(x.m_framed, m_framed);
 		}
 
 		LocalRef& operator=(LocalRef&& x) {
 			std::swap(x.m_obj, m_obj);
+			std::swap(x.m_framed, m_framed);
 			return *this;
 		}
 
@@ -51,8 +137,15 @@ namespace launcher_utils::jni {
 			return static_cast<T>(m_obj);
 		}
 
+		/**
+		 * Gives up ownership of the reference without deleting it.
+		 */
+		jobject release() {
+			return std::exchange(m_obj, nullptr);
+		}
+
 		~LocalRef() {
-			if (m_obj) {
+			if (m_obj && !m_framed) {
 				if (auto env = getEnv()) {
 					(*env)->DeleteLocalRef(m_obj);
 				}
@@ -60,6 +153,66 @@ namespace launcher_utils::jni {
 		}
 	};
 
+	/**
+	 * Scoped JNI local reference frame.
+	 * Capacity for the given number of local references is reserved when the frame is pushed,
+	 * and every local reference created inside the frame is released by a single PopLocalFrame once it ends.
+	 * LocalRefs wrapped with `LocalRef::created` inside the frame skip their individual DeleteLocalRef, so they must not outlive it.
+	 * Other LocalRefs are still deleted individually.
+	 */
+	class LocalFrame final {
+		JNIEnv* m_env{};
+
+		explicit LocalFrame(JNIEnv* env) : m_env(env) {
+			detail::s_localFrameDepth++;
+		}
+
+	public:
+		static geode::Result<LocalFrame> push(JNIEnv* env, jint capacity) {
+			if (env->PushLocalFrame(capacity) != JNI_OK) {
+				env->ExceptionClear();
+				return geode::Err("LocalFrame: PushLocalFrame failed");
+			}
+
+			return geode::Ok(LocalFrame(env));
+		}
+
+		static geode::Result<LocalFrame> push(jint capacity) {
+			GEODE_UNWRAP_INTO(auto env, getEnv());
+			return push(env, capacity);
+		}
+
+		LocalFrame(const LocalFrame&) = delete;
+		LocalFrame& operator=(const LocalFrame&) = delete;
+
+		LocalFrame(LocalFrame&& x) : m_env(std::exchange(x.m_env, nullptr)) {}
+
+		LocalFrame& operator=(LocalFrame&&) = delete;
+
+		/**
+		 * Ends the frame early, moving `result` into the enclosing frame.
+		 * The returned reference is valid after the frame is gone.
+		 */
+		LocalRef pop(jobject result = nullptr) {
+			if (!m_env) {
+				return LocalRef();
+			}
+
+			auto env = std::exchange(m_env, nullptr);
+			detail::s_localFrameDepth--;
+
+			return LocalRef::created(env->PopLocalFrame(result));
+		}
+
+		LocalRef pop(LocalRef&& result) {
+			return pop(result.release());
+		}
+
+		~LocalFrame() {
+			pop();
+		}
+	};
+
 	/**
 	 * Stores a global reference to a jobject.
 	 * When this object is copied, it will create a new global reference.
@@ -131,16 +284,114 @@ namespace launcher_utils::jni {
 		}
 	};
 
+	/**
+	 * Number of buckets in a method's latency histogram.
+	 * Bucket 0 counts calls that took under 1ns, bucket i counts calls that took [2^(i-1), 2^i) ns. The last bucket is open ended.
+	 */
+	inline constexpr std::size_t s_latencyBucketCount = 32;
+
+	namespace detail {
+#ifdef LAUNCHER_UTILS_INSTRUMENTATION
+		/**
+		 * Call statistics of a single method. All counters are updated without locking.
+		 */
+		struct MethodCounters {
+			std::atomic_uint64_t calls{0};
+			std::atomic_uint64_t exceptions{0};
+			std::atomic_uint64_t totalNanoseconds{0};
+			std::array<std::atomic_uint64_t, s_latencyBucketCount> latency{};
+
+			void record(std::uint64_t nanoseconds) {
+				auto bucket = std::min<std::size_t>(std::bit_width(nanoseconds), s_latencyBucketCount - 1);
+
+				calls.fetch_add(1, std::memory_order_relaxed);
+				totalNanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+				latency[bucket].fetch_add(1, std::memory_order_relaxed);
+			}
+
+			void reset() {
+				calls.store(0, std::memory_order_relaxed);
+				exceptions.store(0, std::memory_order_relaxed);
+				totalNanoseconds.store(0, std::memory_order_relaxed);
+				for (auto& bucket : latency) {
+					bucket.store(0, std::memory_order_relaxed);
+				}
+			}
+		};
+#endif
+	}
+
+	namespace detail {
+		/**
+		 * Packs the parameter types of a signature, defined with the other signature helpers below.
+		 */
+		constexpr std::uint64_t packParameterKinds(std::string_view signature);
+	}
+
 	/**
 	 * JNI method storage helper.
 	 */
 	class MethodInfo final {
 		GlobalRef& m_classId;
 		jmethodID m_methodId;
+		std::uint32_t m_epoch;
+		std::string_view m_className;
+		std::string_view m_methodName;
+		std::string_view m_signature;
+		std::string_view m_missing;
+		std::uint64_t m_parameterKinds;
+
+#ifdef LAUNCHER_UTILS_INSTRUMENTATION
+		detail::MethodCounters m_counters{};
+#endif
 
 	public:
-		MethodInfo(GlobalRef& classId, jmethodID methodId)
-			: m_classId(classId), m_methodId(methodId) {}
+		MethodInfo(
+			GlobalRef& classId, jmethodID methodId, std::string_view className = {}, std::string_view methodName = {},
+			std::string_view signature = {}, std::string_view missing = {}
+		) : m_classId(classId), m_methodId(methodId), m_epoch(detail::s_cacheEpoch.load(std::memory_order_relaxed)),
+			m_className(className), m_methodName(methodName), m_signature(signature), m_missing(missing),
+			m_parameterKinds(detail::packParameterKinds(signature)) {}
+
+		std::string_view className() const {
+			return m_className;
+		}
+
+		std::string_view methodName() const {
+			return m_methodName;
+		}
+
+		std::string_view signature() const {
+			return m_signature;
+		}
+
+		/**
+		 * Parameter types of the signature, parsed once as the method is looked up. See detail::packParameterKinds.
+		 */
+		std::uint64_t parameterKinds() const {
+			return m_parameterKinds;
+		}
+
+		/**
+		 * Error of a method that doesn't exist, empty otherwise.
+		 * Cached misses have a MethodInfo too, so call-site handles can keep them like any other method.
+		 */
+		std::string_view missing() const {
+			return m_missing;
+		}
+
+#ifdef LAUNCHER_UTILS_INSTRUMENTATION
+		detail::MethodCounters& counters() {
+			return m_counters;
+		}
+#endif
+
+		/**
+		 * Returns false if the ID cache was reset after this method was looked up.
+		 */
+		bool isCurrent() const {
+			return m_epoch == detail::s_cacheEpoch.load(std::memory_order_relaxed);
+		}
 
 		jclass classID() const {
 			return m_classId.get<jclass>();
@@ -151,7 +402,375 @@ namespace launcher_utils::jni {
 		}
 	};
 
-	geode::Result<> checkForExceptions(JNIEnv* env);
+	/**
+	 * JNI field storage helper.
+	 */
+	class FieldInfo final {
+		GlobalRef& m_classId;
+		jfieldID m_fieldId;
+		std::uint32_t m_epoch;
+		bool m_isStatic;
+
+	public:
+		FieldInfo(GlobalRef& classId, jfieldID fieldId, bool isStatic)
+			: m_classId(classId), m_fieldId(fieldId), m_epoch(detail::s_cacheEpoch.load(std::memory_order_relaxed)), m_isStatic(isStatic) {}
+
+		/**
+		 * Returns false if the ID cache was reset after this field was looked up.
+		 */
+		bool isCurrent() const {
+			return m_epoch == detail::s_cacheEpoch.load(std::memory_order_relaxed);
+		}
+
+		bool isStatic() const {
+			return m_isStatic;
+		}
+
+		jclass classID() const {
+			return m_classId.get<jclass>();
+		}
+
+		jfieldID fieldID() const {
+			return m_fieldId;
+		}
+	};
+
+	/**
+	 * A Java exception, cleared from the environment that threw it.
+	 * Only a reference to the throwable is kept, and its details are fetched from Java when they are asked for.
+	 */
+	class Exception final {
+		GlobalRef m_throwable{};
+
+	public:
+		explicit Exception(GlobalRef&& throwable) : m_throwable(std::move(throwable)) {}
+
+		jthrowable get() const {
+			return m_throwable.get<jthrowable>();
+		}
+
+		/**
+		 * Name of the exception's class, such as `java.lang.RuntimeException`.
+		 */
+		std::string className() const;
+
+		std::string message() const;
+
+		/**
+		 * The exception and its message, formatted like Throwable.toString.
+		 */
+		std::string toString() const;
+
+		/**
+		 * The exception with its stack trace and causes.
+		 */
+		std::string stackTrace() const;
+	};
+
+	/**
+	 * Clears a pending exception and returns it. When there is none, this costs a single ExceptionCheck.
+	 */
+	geode::Result<void, Exception> checkException(JNIEnv* env);
+
+	/**
+	 * Why a call through the call layer failed: either the exception it threw, or a description of why it couldn't be made.
+	 * An exception is only described when `message` is called, so callers that discard the error never call into Java for it.
+	 */
+	class Error final {
+		std::variant<std::string, std::string_view, Exception> m_value;
+
+	public:
+		Error(std::string description) : m_value(std::move(description)) {}
+		Error(const char* description) : m_value(std::string(description)) {}
+		Error(Exception&& exception) : m_value(std::move(exception)) {}
+
+		/**
+		 * Refers to a description that outlives the error, such as the message of a cached miss, without copying it.
+		 */
+		explicit Error(std::string_view description) : m_value(description) {}
+
+		/**
+		 * The exception thrown by the call, or null if it failed before reaching Java.
+		 */
+		const Exception* exception() const {
+			return std::get_if<Exception>(&m_value);
+		}
+
+		/**
+		 * The exception's message, as returned by Throwable.getMessage, or the description of the failure.
+		 */
+		std::string message() const;
+	};
+
+	namespace detail {
+		geode::Result<> exceptionToError(JNIEnv* env);
+	}
+
+	/**
+	 * Like checkException, with the exception's message as the error.
+	 */
+	inline geode::Result<> checkForExceptions(JNIEnv* env) {
+		if (env->ExceptionCheck() != JNI_TRUE) {
+			return geode::Ok();
+		}
+
+		return detail::exceptionToError(env);
+	}
+
+	namespace detail {
+#ifdef LAUNCHER_UTILS_TRACING
+		inline std::atomic_bool s_tracing{false};
+
+		/**
+		 * Appends a call event to the calling thread's trace buffer.
+		 */
+		void traceCall(const MethodInfo& info, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end);
+#endif
+
+		/**
+		 * Times a call through a MethodInfo, for call statistics and tracing.
+		 * Does nothing unless built with LAUNCHER_UTILS_INSTRUMENTATION or LAUNCHER_UTILS_TRACING.
+		 */
+		class CallRecorder final {
+#if defined(LAUNCHER_UTILS_INSTRUMENTATION) || defined(LAUNCHER_UTILS_TRACING)
+			MethodInfo& m_info;
+			std::chrono::steady_clock::time_point m_begin{};
+			bool m_tracing{};
+
+			bool timed() const {
+#ifdef LAUNCHER_UTILS_INSTRUMENTATION
+				return true;
+#else
+				return m_tracing;
+#endif
+			}
+
+		public:
+			explicit CallRecorder(MethodInfo& info) : m_info(info) {
+#ifdef LAUNCHER_UTILS_TRACING
+				m_tracing = s_tracing.load(std::memory_order_relaxed);
+#endif
+
+				if (timed()) {
+					m_begin = std::chrono::steady_clock::now();
+				}
+			}
+
+			~CallRecorder() {
+				if (!timed()) {
+					return;
+				}
+
+				auto end = std::chrono::steady_clock::now();
+
+#ifdef LAUNCHER_UTILS_INSTRUMENTATION
+				auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(end - m_begin);
+				m_info.counters().record(static_cast<std::uint64_t>(elapsed.count()));
+#endif
+
+#ifdef LAUNCHER_UTILS_TRACING
+				if (m_tracing) {
+					traceCall(m_info, m_begin, end);
+				}
+#endif
+			}
+#else
+		public:
+			explicit CallRecorder(MethodInfo&) {}
+#endif
+
+			CallRecorder(const CallRecorder&) = delete;
+			CallRecorder& operator=(const CallRecorder&) = delete;
+		};
+
+		/**
+		 * checkException for a call through the call layer, additionally counting the exception against the called method.
+		 */
+		inline geode::Result<void, Error> checkCallException(JNIEnv* env, [[maybe_unused]] MethodInfo& info) {
+			if (env->ExceptionCheck() != JNI_TRUE) {
+				return geode::Ok();
+			}
+
+#ifdef LAUNCHER_UTILS_INSTRUMENTATION
+			info.counters().exceptions.fetch_add(1, std::memory_order_relaxed);
+#endif
+
+			return geode::Err(Error(checkException(env).unwrapErr()));
+		}
+
+		/**
+		 * getEnv, with its error as a call error.
+		 */
+		inline geode::Result<JNIEnv*, Error> getCallEnv() {
+			auto env = getEnv();
+			if (!env) {
+				return geode::Err(Error(std::move(env).unwrapErr()));
+			}
+
+			return geode::Ok(env.unwrap());
+		}
+
+		/**
+		 * Converts a call error into the error message used by the string-error API.
+		 */
+		template <typename T>
+		geode::Result<T> toStringError(geode::Result<T, Error>&& result) {
+			return std::move(result).mapErr([](const Error& error) {
+				return error.message();
+			});
+		}
+
+		template <typename T>
+		geode::Result<T, Error> toCallError(geode::Result<T>&& result) {
+			return std::move(result).mapErr([](std::string error) {
+				return Error(std::move(error));
+			});
+		}
+	}
+
+	/**
+	 * Statistics of a single cached method, see getCallStats.
+	 */
+	struct MethodCallStats {
+		std::string_view className{};
+		std::string_view methodName{};
+		std::string_view signature{};
+		bool isStatic{};
+
+		std::uint64_t calls{};
+		std::uint64_t exceptions{};
+		std::uint64_t totalNanoseconds{};
+		std::array<std::uint64_t, s_latencyBucketCount> latency{};
+
+		/**
+		 * Estimates the given latency percentile (0 to 1) from the histogram, as the upper bound of its bucket in ns.
+		 */
+		std::uint64_t percentile(double p) const;
+	};
+
+	struct CallStats {
+		/**
+		 * False if the library was built without LAUNCHER_UTILS_INSTRUMENTATION. All other fields are empty in that case.
+		 */
+		bool enabled{};
+
+		/**
+		 * Lookups through getClassId and the method and field fetchers.
+		 * Call-site handles only look a method up once, so their calls are not counted here.
+		 */
+		std::uint64_t classCacheHits{};
+		std::uint64_t classCacheMisses{};
+		std::uint64_t methodCacheHits{};
+		std::uint64_t methodCacheMisses{};
+		std::uint64_t fieldCacheHits{};
+		std::uint64_t fieldCacheMisses{};
+
+		std::vector<MethodCallStats> methods{};
+	};
+
+	/**
+	 * Takes a snapshot of the call statistics of every cached method.
+	 * Counters are read individually, so a snapshot taken during calls may be slightly inconsistent.
+	 */
+	CallStats getCallStats();
+
+	/**
+	 * Clears all call statistics.
+	 */
+	void resetCallStats();
+
+	/**
+	 * Formats call statistics as a table, sorted by total time spent in each method.
+	 */
+	std::string formatCallStats(const CallStats& stats);
+
+	/**
+	 * Size and layout information for the class/method ID cache.
+	 */
+	struct CacheStats {
+		std::size_t entries{};
+		std::size_t capacity{};
+		std::size_t tableBytes{};
+		std::size_t retiredTableBytes{};
+		std::size_t arenaReservedBytes{};
+		std::size_t arenaUsedBytes{};
+		std::size_t maxProbeLength{};
+		double averageProbeLength{};
+	};
+
+	/**
+	 * Returns statistics about the ID cache shared by getClassId, getStaticMethodInfo and getMethodInfo.
+	 * The cache may be used from any thread; lookups of already cached IDs do not lock.
+	 */
+	CacheStats getCacheStats();
+
+	namespace detail {
+		enum class EntryKind : std::uint8_t {
+			Class,
+			StaticMethod,
+			Method,
+			StaticField,
+			Field
+		};
+
+		/**
+		 * FNV-1a over the key parts, hashed in sequence so no combined key string is ever built.
+		 */
+		constexpr std::uint64_t hashKey(EntryKind kind, std::string_view className, std::string_view memberName, std::string_view paramSignature) {
+			std::uint64_t hash = 0xcbf29ce484222325ull;
+			auto feed = [&hash](char c) {
+				hash ^= static_cast<std::uint8_t>(c);
+				hash *= 0x100000001b3ull;
+			};
+
+			feed(static_cast<char>(kind));
+			for (auto c : className) feed(c);
+			feed('.');
+			for (auto c : memberName) feed(c);
+			for (auto c : paramSignature) feed(c);
+
+			return hash;
+		}
+
+		/**
+		 * Lookup key for the ID cache. The strings are not owned by the key.
+		 * Member name and signature are empty for class entries.
+		 * A key built in a constant expression, such as in a static method handle, has its hash computed at compile time.
+		 */
+		struct CacheKey {
+			EntryKind kind;
+			std::string_view className;
+			std::string_view memberName;
+			std::string_view paramSignature;
+			std::uint64_t hash;
+
+			constexpr CacheKey(EntryKind kind, std::string_view className, std::string_view memberName = {}, std::string_view paramSignature = {})
+				: kind(kind), className(className), memberName(memberName), paramSignature(paramSignature),
+				  hash(hashKey(kind, className, memberName, paramSignature)) {}
+
+			bool operator==(const CacheKey& other) const {
+				return hash == other.hash
+					&& kind == other.kind
+					&& className == other.className
+					&& memberName == other.memberName
+					&& paramSignature == other.paramSignature;
+			}
+		};
+
+		/**
+		 * Cached fetchers taking a prebuilt key. The strings of the key must be null terminated.
+		 * The method and field fetchers look up a static or non-static member depending on the kind of the key.
+		 */
+		geode::Result<GlobalRef&> getClassId(JNIEnv* env, const CacheKey& key);
+		geode::Result<MethodInfo&> getMethodInfo(JNIEnv* env, const CacheKey& key);
+
+		/**
+		 * Like getMethodInfo, but returns the MethodInfo of a cached miss instead of its error.
+		 * Only misses that can't be cached are returned as an error.
+		 */
+		geode::Result<MethodInfo&> lookupMethodInfo(JNIEnv* env, const CacheKey& key);
+		geode::Result<FieldInfo&> getFieldInfo(JNIEnv* env, const CacheKey& key);
+	}
 
 	/**
 	 * Cached fetcher for a JNI class.
@@ -169,6 +788,16 @@ namespace launcher_utils::jni {
 	 */
 	geode::Result<MethodInfo&> getMethodInfo(JNIEnv* env, const char* className, const char* methodName, const char* paramSignature);
 
+	/**
+	 * Cached fetcher for a static JNI field.
+	 */
+	geode::Result<FieldInfo&> getStaticFieldInfo(JNIEnv* env, const char* className, const char* fieldName, const char* signature);
+
+	/**
+	 * Cached fetcher for a non-static JNI field.
+	 */
+	geode::Result<FieldInfo&> getFieldInfo(JNIEnv* env, const char* className, const char* fieldName, const char* signature);
+
 	/**
 	 * Converts a long C array to a Java array.
 	 * The returned local ref is not automatically freed.
@@ -181,114 +810,1329 @@ namespace launcher_utils::jni {
 	 */
 	geode::Result<std::vector<int>> extractArray(JNIEnv* env, jintArray array);
 
-	geode::Result<std::string> toString(JNIEnv* env, jstring string);
-
-	geode::Result<LocalRef> toJString(JNIEnv* env, std::string_view string);
+	/**
+	 * Maps a JNI primitive type to its Java array type and array accessors.
+	 */
+	template <typename T>
+	struct ArrayTraits;
 
-	template <typename T, typename... Args> requires std::same_as<T, void>
-	geode::Result<> performStaticMethodCall(JNIEnv* env, MethodInfo& info, Args... args) {
-		env->CallStaticVoidMethod(info.classID(), info.methodID(), args...);
-		GEODE_UNWRAP(checkForExceptions(env));
-		return geode::Ok();
-	}
+#define LAUNCHER_UTILS_ARRAY_TRAITS(Type, Name, Signature) \
+	template <> \
+	struct ArrayTraits<Type> { \
+		using ArrayType = Type##Array; \
+		static constexpr char signature = Signature; \
+		static ArrayType newArray(JNIEnv* env, jsize len) { \
+			return env->New##Name##Array(len); \
+		} \
+		static void getRegion(JNIEnv* env, ArrayType array, jsize start, jsize len, Type* buf) { \
+			env->Get##Name##ArrayRegion(array, start, len, buf); \
+		} \
+		static void setRegion(JNIEnv* env, ArrayType array, jsize start, jsize len, const Type* buf) { \
+			env->Set##Name##ArrayRegion(array, start, len, buf); \
+		} \
+	};
 
-	template <typename T, typename... Args> requires std::same_as<T, bool>
-	geode::Result<bool> performStaticMethodCall(JNIEnv* env, MethodInfo& info, Args... args) {
-		auto r = env->CallStaticBooleanMethod(info.classID(), info.methodID(), args...);
-		GEODE_UNWRAP(checkForExceptions(env));
-		return geode::Ok(r);
-	}
+	LAUNCHER_UTILS_ARRAY_TRAITS(jboolean, Boolean, 'Z')
+	LAUNCHER_UTILS_ARRAY_TRAITS(jbyte, Byte, 'B')
+	LAUNCHER_UTILS_ARRAY_TRAITS(jchar, Char, 'C')
+	LAUNCHER_UTILS_ARRAY_TRAITS(jshort, Short, 'S')
+	LAUNCHER_UTILS_ARRAY_TRAITS(jint, Int, 'I')
+	LAUNCHER_UTILS_ARRAY_TRAITS(jlong, Long, 'J')
+	LAUNCHER_UTILS_ARRAY_TRAITS(jfloat, Float, 'F')
+	LAUNCHER_UTILS_ARRAY_TRAITS(jdouble, Double, 'D')
 
-	template <typename T, typename... Args> requires std::same_as<T, int>
-	geode::Result<int> performStaticMethodCall(JNIEnv* env, MethodInfo& info, Args... args) {
-		auto r = env->CallStaticIntMethod(info.classID(), info.methodID(), args...);
-		GEODE_UNWRAP(checkForExceptions(env));
-		return geode::Ok(r);
-	}
+#undef LAUNCHER_UTILS_ARRAY_TRAITS
 
-	template <typename T, typename... Args> requires std::same_as<T, float>
-	geode::Result<float> performStaticMethodCall(JNIEnv* env, MethodInfo& info, Args... args) {
-		auto r = env->CallStaticFloatMethod(info.classID(), info.methodID(), args...);
-		GEODE_UNWRAP(checkForExceptions(env));
-		return geode::Ok(r);
-	}
+	/**
+	 * Maps a JNI type to its field accessors.
+	 */
+	template <typename T>
+	struct FieldTraits;
 
-	template <typename T, typename... Args> requires std::same_as<T, std::vector<int>>
-	geode::Result<std::vector<int>> performStaticMethodCall(JNIEnv* env, MethodInfo& info, Args... args) {
-			auto array = LocalRef(env->CallStaticObjectMethod(info.classID(), info.methodID(), args...));
-			GEODE_UNWRAP(checkForExceptions(env));
+#define LAUNCHER_UTILS_FIELD_TRAITS(Type, Name) \
+	template <> \
+	struct FieldTraits<Type> { \
+		static Type get(JNIEnv* env, jobject obj, jfieldID id) { \
+			return env->Get##Name##Field(obj, id); \
+		} \
+		static Type getStatic(JNIEnv* env, jclass cls, jfieldID id) { \
+			return env->GetStatic##Name##Field(cls, id); \
+		} \
+		static void set(JNIEnv* env, jobject obj, jfieldID id, Type value) { \
+			env->Set##Name##Field(obj, id, value); \
+		} \
+		static void setStatic(JNIEnv* env, jclass cls, jfieldID id, Type value) { \
+			env->SetStatic##Name##Field(cls, id, value); \
+		} \
+	};
 
-			return extractArray(env, array.get<jintArray>());
-	}
+	LAUNCHER_UTILS_FIELD_TRAITS(jobject, Object)
+	LAUNCHER_UTILS_FIELD_TRAITS(jboolean, Boolean)
+	LAUNCHER_UTILS_FIELD_TRAITS(jbyte, Byte)
+	LAUNCHER_UTILS_FIELD_TRAITS(jchar, Char)
+	LAUNCHER_UTILS_FIELD_TRAITS(jshort, Short)
+	LAUNCHER_UTILS_FIELD_TRAITS(jint, Int)
+	LAUNCHER_UTILS_FIELD_TRAITS(jlong, Long)
+	LAUNCHER_UTILS_FIELD_TRAITS(jfloat, Float)
+	LAUNCHER_UTILS_FIELD_TRAITS(jdouble, Double)
 
-	template <typename T, typename... Args> requires std::same_as<T, std::string>
-	geode::Result<std::string> performStaticMethodCall(JNIEnv* env, MethodInfo& info, Args... args) {
-		auto s = LocalRef(env->CallStaticObjectMethod(info.classID(), info.methodID(), args...));
-		GEODE_UNWRAP(checkForExceptions(env));
+#undef LAUNCHER_UTILS_FIELD_TRAITS
 
-		return toString(env, s.get<jstring>());
-	}
+	/**
+	 * A JNI primitive type that can be stored in a Java array.
+	 */
+	template <typename T>
+	concept Primitive = requires {
+		typename ArrayTraits<T>::ArrayType;
+	};
 
-	template <typename T, typename... Args> requires std::same_as<T, jobject>
-	geode::Result<LocalRef> performStaticMethodCall(JNIEnv* env, MethodInfo& info, Args... args) {
-		auto r = LocalRef(env->CallStaticObjectMethod(info.classID(), info.methodID(), args...));
-		GEODE_UNWRAP(checkForExceptions(env));
+	template <typename T>
+	concept PrimitiveVector = requires {
+		typename T::value_type;
+	} && Primitive<typename T::value_type> && std::same_as<T, std::vector<typename T::value_type>>;
 
-		return geode::Ok(std::move(r));
-	}
+	template <Primitive T>
+	using ArrayType = typename ArrayTraits<T>::ArrayType;
 
 	/**
-	 * Calls a static JNI method with the given signature and arguments.
-	 * This version accepts an env pointer, which may be faster if you're already using it for other purposes.
+	 * Creates a Java array from any contiguous range of a primitive type.
 	 */
-	template <typename T, typename... Args>
-	std::invoke_result_t<decltype(performStaticMethodCall<T>), JNIEnv*, MethodInfo&> callStaticMethod(JNIEnv* env, const char* className, const char* methodName, const char* parameterSignature, Args... args) {
-		GEODE_UNWRAP_INTO(auto& info, getStaticMethodInfo(env, className, methodName, parameterSignature));
+	template <std::ranges::contiguous_range R> requires Primitive<std::ranges::range_value_t<R>>
+	LocalRef toJavaArray(JNIEnv* env, const R& range) {
+		using T = std::ranges::range_value_t<R>;
 
-		return performStaticMethodCall<T>(env, info, args...);
+		auto len = static_cast<jsize>(std::ranges::size(range));
+		auto array = ArrayTraits<T>::newArray(env, len);
+		if (array != nullptr) {
+			ArrayTraits<T>::setRegion(env, array, 0, len, std::ranges::data(range));
+		}
+
+		return LocalRef::created(array);
 	}
 
 	/**
-	 * Calls a static JNI method with the given signature and arguments.
+	 * Copies a Java array into the given vector, reusing its capacity.
 	 */
-	template <typename T, typename... Args>
-	geode::Result<T> callStaticMethod(const char* className, const char* methodName, const char* parameterSignature, Args... args) {
-		GEODE_UNWRAP_INTO(auto env, getEnv());
-		return callStaticMethod<T>(env, className, methodName, parameterSignature, args...);
-	}
-
-	template <typename T, typename... Args> requires std::same_as<T, std::string>
-	geode::Result<std::string> performMethodCall(JNIEnv* env, MethodInfo& info, jobject obj, Args... args) {
-		auto s = LocalRef(env->CallObjectMethod(obj, info.methodID(), args...));
-		GEODE_UNWRAP(checkForExceptions(env));
-
-		return toString(env, s.get<jstring>());
-	}
+	template <Primitive T>
+	geode::Result<> extractArray(JNIEnv* env, ArrayType<T> array, std::vector<T>& out) {
+		if (array == nullptr) {
+			return geode::Err("extractArray: null array");
+		}
 
-	template <typename T, typename... Args> requires std::same_as<T, int>
-	geode::Result<int> performMethodCall(JNIEnv* env, MethodInfo& info, jobject obj, Args... args) {
-		auto r = env->CallIntMethod(obj, info.methodID(), args...);
-		GEODE_UNWRAP(checkForExceptions(env));
+		auto len = env->GetArrayLength(array);
+		out.resize(len);
+		ArrayTraits<T>::getRegion(env, array, 0, len, out.data());
 
-		return geode::Ok(r);
+		return geode::Ok();
 	}
 
 	/**
-	 * Calls a static JNI method with the given signature and arguments.
-	 * This version accepts an env pointer, which may be faster if you're already using it for other purposes.
+	 * Copies a Java array into a new vector.
 	 */
-	template <typename T, typename... Args>
-	geode::Result<T> callMethod(JNIEnv* env, const char* className, const char* methodName, const char* parameterSignature, jobject obj, Args... args) {
-		GEODE_UNWRAP_INTO(auto& info, getMethodInfo(env, className, methodName, parameterSignature));
-		return performMethodCall<T>(env, info, obj, args...);
+	template <Primitive T>
+	geode::Result<std::vector<T>> extractArray(JNIEnv* env, ArrayType<T> array) {
+		std::vector<T> r{};
+		GEODE_UNWRAP(extractArray<T>(env, array, r));
+		return geode::Ok(std::move(r));
 	}
 
 	/**
-	 * Calls a static JNI method with the given signature and arguments.
+	 * Direct view of a Java array's contents, through GetPrimitiveArrayCritical.
+	 * No copy is made when the VM supports it. While the view exists, no other JNI calls may be made
+	 * and the thread must not block, so keep its lifetime as short as possible.
 	 */
-	template <typename T, typename... Args>
-	geode::Result<T> callMethod(const char* className, const char* methodName, const char* parameterSignature, jobject obj, Args... args) {
-		GEODE_UNWRAP_INTO(auto env, getEnv());
-		return callMethod<T>(env, className, methodName, parameterSignature, obj, args...);
-	}
+	template <Primitive T>
+	class CriticalArrayView final {
+		JNIEnv* m_env{};
+		jarray m_array{};
+		T* m_data{};
+		jsize m_size{};
+		jint m_releaseMode{};
+
+		CriticalArrayView(JNIEnv* env, jarray array, T* data, jsize size, jint releaseMode)
+			: m_env(env), m_array(array), m_data(data), m_size(size), m_releaseMode(releaseMode) {}
+
+	public:
+		/**
+		 * Creates a view of the array. If readOnly is set, changes made through the view are not written back.
+		 */
+		static geode::Result<CriticalArrayView> create(JNIEnv* env, ArrayType<T> array, bool readOnly = false) {
+			if (array == nullptr) {
+				return geode::Err("CriticalArrayView: null array");
+			}
+
+			auto size = env->GetArrayLength(array);
+			auto data = static_cast<T*>(env->GetPrimitiveArrayCritical(array, nullptr));
+			if (data == nullptr) {
+				env->ExceptionClear();
+				return geode::Err("CriticalArrayView: GetPrimitiveArrayCritical failed");
+			}
+
+			return geode::Ok(CriticalArrayView(env, array, data, size, readOnly ? JNI_ABORT : 0));
+		}
+
+		CriticalArrayView(const CriticalArrayView&) = delete;
+		CriticalArrayView& operator=(const CriticalArrayView&) = delete;
+
+		CriticalArrayView(CriticalArrayView&& x)
+			: m_env(x.m_env), m_array(x.m_array), m_data(std::exchange(x.m_data, nullptr)),
+			  m_size(x.m_size), m_releaseMode(x.m_releaseMode) {}
+
+		CriticalArrayView& operator=(CriticalArrayView&&) = delete;
+
+		std::span<T> span() const {
+			return {m_data, static_cast<std::size_t>(m_size)};
+		}
+
+		T* data() const {
+			return m_data;
+		}
+
+		std::size_t size() const {
+			return m_size;
+		}
+
+		T* begin() const {
+			return m_data;
+		}
+
+		T* end() const {
+			return m_data + m_size;
+		}
+
+		/**
+		 * Releases the view early. The view is empty afterwards.
+		 */
+		void release() {
+			if (auto data = std::exchange(m_data, nullptr)) {
+				m_env->ReleasePrimitiveArrayCritical(m_array, data, m_releaseMode);
+			}
+		}
+
+		~CriticalArrayView() {
+			release();
+		}
+	};
+
+	geode::Result<std::string> toString(JNIEnv* env, jstring string);
+
+	/**
+	 * Converts a Java string into `out`, reusing its capacity.
+	 */
+	geode::Result<> toString(JNIEnv* env, jstring string, std::string& out);
+
+	geode::Result<LocalRef> toJString(JNIEnv* env, std::string_view string);
+
+	/**
+	 * Like the string_view overload. The string is null terminated, so ASCII of any length is passed to the JVM without a copy.
+	 */
+	geode::Result<LocalRef> toJString(JNIEnv* env, const char* string);
+
+	geode::Result<LocalRef> toJString(JNIEnv* env, const std::string& string);
+
+	namespace detail {
+		/**
+		 * Signature character of a C++ argument type, with all object types reduced to 'L'.
+		 * Returns 0 for types that cannot be passed to Java.
+		 */
+		template <typename T>
+		consteval char argumentSignature() {
+			if constexpr (std::same_as<T, bool>) {
+				return 'Z';
+			} else if constexpr (Primitive<T>) {
+				return ArrayTraits<T>::signature;
+			} else if constexpr (std::convertible_to<T, jobject>) {
+				return 'L';
+			} else {
+				return 0;
+			}
+		}
+
+		template <typename T>
+		jvalue toJValue(T arg) {
+			constexpr auto type = argumentSignature<T>();
+			static_assert(type != 0, "unsupported JNI argument type, pass a jboolean, jbyte, jchar, jshort, jint, jlong, jfloat, jdouble or jobject");
+
+			jvalue value{};
+			if constexpr (type == 'Z') {
+				value.z = static_cast<jboolean>(arg);
+			} else if constexpr (type == 'B') {
+				value.b = arg;
+			} else if constexpr (type == 'C') {
+				value.c = arg;
+			} else if constexpr (type == 'S') {
+				value.s = arg;
+			} else if constexpr (type == 'I') {
+				value.i = arg;
+			} else if constexpr (type == 'J') {
+				value.j = arg;
+			} else if constexpr (type == 'F') {
+				value.f = arg;
+			} else if constexpr (type == 'D') {
+				value.d = arg;
+			} else if constexpr (type == 'L') {
+				value.l = arg;
+			}
+
+			return value;
+		}
+
+		/**
+		 * Packs call arguments for the `Call...MethodA` functions, using the union member matching each argument's type.
+		 */
+		template <typename... Args>
+		std::array<jvalue, sizeof...(Args)> packArguments(Args... args) {
+			return {toJValue(args)...};
+		}
+
+		/**
+		 * Returns the position after the type starting at `pos` in a signature, or npos if no valid type starts there.
+		 */
+		constexpr std::size_t skipType(std::string_view signature, std::size_t pos) {
+			while (pos < signature.size() && signature[pos] == '[') {
+				pos++;
+			}
+
+			if (pos >= signature.size()) {
+				return std::string_view::npos;
+			}
+
+			switch (signature[pos]) {
+				case 'Z': case 'B': case 'C': case 'S': case 'I': case 'J': case 'F': case 'D':
+					return pos + 1;
+				case 'L':
+					while (pos < signature.size()) {
+						if (signature[pos++] == ';') {
+							return pos;
+						}
+					}
+
+					return std::string_view::npos;
+				default:
+					return std::string_view::npos;
+			}
+		}
+
+		constexpr bool isValidSignature(std::string_view signature) {
+			if (!signature.starts_with('(')) {
+				return false;
+			}
+
+			std::size_t pos = 1;
+			while (pos < signature.size() && signature[pos] != ')') {
+				pos = skipType(signature, pos);
+				if (pos == std::string_view::npos) {
+					return false;
+				}
+			}
+
+			if (pos >= signature.size()) {
+				return false;
+			}
+
+			auto returnType = signature.substr(pos + 1);
+			return returnType == "V" || skipType(returnType, 0) == returnType.size();
+		}
+
+		/**
+		 * Parameter types of a valid signature, with object and array types reduced to 'L'.
+		 */
+		template <std::size_t N>
+		constexpr std::array<char, N> parameterTypes(std::string_view signature) {
+			std::array<char, N> types{};
+
+			std::size_t pos = 1;
+			for (std::size_t i = 0; i < N && pos < signature.size() && signature[pos] != ')'; i++) {
+				types[i] = signature[pos] == '[' ? 'L' : signature[pos];
+				pos = skipType(signature, pos);
+			}
+
+			return types;
+		}
+
+		constexpr std::size_t parameterCount(std::string_view signature) {
+			std::size_t count = 0;
+			for (std::size_t pos = 1; pos < signature.size() && signature[pos] != ')'; pos = skipType(signature, pos)) {
+				count++;
+			}
+
+			return count;
+		}
+
+		template <typename... Args>
+		constexpr bool argumentsMatch(std::string_view signature) {
+			constexpr std::array<char, sizeof...(Args)> arguments{argumentSignature<Args>()...};
+			return parameterTypes<sizeof...(Args)>(signature) == arguments;
+		}
+
+		inline constexpr std::size_t s_maxPackedParameters = 16;
+		inline constexpr std::uint64_t s_unpackedParameters = ~std::uint64_t{0};
+
+		/**
+		 * Four bit code of a parameter type, with object and array types reduced to 'L'. Never 0 for a valid type,
+		 * so that the number of parameters is part of the packed value.
+		 */
+		constexpr std::uint64_t parameterKind(char type) {
+			constexpr std::string_view kinds = "ZBCSIJFDL";
+			return kinds.find(type == '[' ? 'L' : type) + 1;
+		}
+
+		/**
+		 * Parameter types of a signature, four bits each, so a call's arguments can be checked against a signature
+		 * without parsing it again. Invalid signatures, and ones with more than s_maxPackedParameters parameters,
+		 * pack to s_unpackedParameters.
+		 */
+		constexpr std::uint64_t packParameterKinds(std::string_view signature) {
+			if (!signature.starts_with('(')) {
+				return s_unpackedParameters;
+			}
+
+			std::uint64_t kinds = 0;
+			std::size_t count = 0;
+			for (std::size_t pos = 1; pos < signature.size() && signature[pos] != ')'; count++) {
+				auto next = skipType(signature, pos);
+				if (next == std::string_view::npos || count == s_maxPackedParameters) {
+					return s_unpackedParameters;
+				}
+
+				kinds |= parameterKind(signature[pos]) << (count * 4);
+				pos = next;
+			}
+
+			return kinds;
+		}
+
+		/**
+		 * Argument types packed like packParameterKinds.
+		 */
+		template <typename... Args>
+		constexpr std::uint64_t packArgumentKinds() {
+			std::uint64_t kinds = 0;
+			std::size_t count = 0;
+			((kinds |= parameterKind(argumentSignature<Args>()) << (count++ * 4)), ...);
+
+			return kinds;
+		}
+
+		/**
+		 * Checks that a call's result type can hold the return type of a signature.
+		 */
+		template <typename T>
+		constexpr bool returnMatches(std::string_view signature) {
+			std::size_t pos = 1;
+			while (signature[pos] != ')') {
+				pos = skipType(signature, pos);
+			}
+
+			auto returnType = signature.substr(pos + 1);
+
+			if constexpr (std::same_as<T, void>) {
+				return returnType == "V";
+			} else if constexpr (std::same_as<T, bool>) {
+				return returnType == "Z";
+			} else if constexpr (std::same_as<T, int>) {
+				return returnType == "I";
+			} else if constexpr (std::same_as<T, float>) {
+				return returnType == "F";
+			} else if constexpr (std::same_as<T, std::string>) {
+				return returnType == "Ljava/lang/String;";
+			} else if constexpr (PrimitiveVector<T>) {
+				return returnType.size() == 2 && returnType[0] == '[' && returnType[1] == ArrayTraits<typename T::value_type>::signature;
+			} else if constexpr (std::same_as<T, jobject>) {
+				return returnType.starts_with('L') || returnType.starts_with('[');
+			} else {
+				return false;
+			}
+		}
+	}
+
+	namespace detail {
+		/**
+		 * Result of a call returning T. Objects are returned as a LocalRef.
+		 */
+		template <typename T>
+		using CallResult = std::conditional_t<std::same_as<T, jobject>, LocalRef, T>;
+
+		template <typename T>
+		concept CallResultType = std::same_as<T, void> || std::same_as<T, bool> || std::same_as<T, int> || std::same_as<T, float>
+			|| std::same_as<T, std::string> || std::same_as<T, jobject> || PrimitiveVector<T>;
+
+		/**
+		 * Converts the object returned by a call into its result type.
+		 */
+		template <typename T>
+		geode::Result<CallResult<T>, Error> convertObjectResult(JNIEnv* env, LocalRef&& object) {
+			if constexpr (std::same_as<T, jobject>) {
+				return geode::Ok(std::move(object));
+			} else if constexpr (std::same_as<T, std::string>) {
+				return toCallError(toString(env, object.get<jstring>()));
+			} else {
+				return toCallError(extractArray<typename T::value_type>(env, object.get<ArrayType<typename T::value_type>>()));
+			}
+		}
+	}
+
+	namespace detail {
+		/**
+		 * Checks call arguments against a signature that is only known at runtime, since an argument of the wrong type
+		 * would be read from the wrong jvalue member (an `int` passed for `J` leaves the upper half undefined).
+		 * The signature was parsed when the method was looked up, so this only compares the packed types.
+		 */
+		template <typename... Args>
+		geode::Result<> checkArguments(const MethodInfo& info) {
+			if constexpr (sizeof...(Args) <= s_maxPackedParameters) {
+				if (info.parameterKinds() == packArgumentKinds<Args...>()) {
+					return geode::Ok();
+				}
+			} else if (parameterCount(info.signature()) == sizeof...(Args) && argumentsMatch<Args...>(info.signature())) {
+				return geode::Ok();
+			}
+
+			return geode::Err(
+				std::string(info.methodName()) + ": arguments do not match the signature " + std::string(info.signature())
+			);
+		}
+	}
+
+	/**
+	 * Calls a static method through a MethodInfo, keeping a thrown exception in the error instead of formatting it.
+	 * Arguments are packed into a jvalue array by their C++ type, so each one must have the exact JNI type
+	 * of its parameter (`jlong` for `J`, not `int`). The other call functions check this against the signature,
+	 * at compile time for the template-string overloads and before the call for runtime strings.
+	 */
+	template <detail::CallResultType T, typename... Args>
+	geode::Result<detail::CallResult<T>, Error> invokeStaticMethod(JNIEnv* env, MethodInfo& info, Args... args) {
+		auto values = detail::packArguments(args...);
+		detail::CallRecorder recorder(info);
+
+		if constexpr (std::same_as<T, void>) {
+			env->CallStaticVoidMethodA(info.classID(), info.methodID(), values.data());
+			GEODE_UNWRAP(detail::checkCallException(env, info));
+			return geode::Ok();
+		} else if constexpr (std::same_as<T, bool>) {
+			auto r = env->CallStaticBooleanMethodA(info.classID(), info.methodID(), values.data());
+			GEODE_UNWRAP(detail::checkCallException(env, info));
+			return geode::Ok(r == JNI_TRUE);
+		} else if constexpr (std::same_as<T, int>) {
+			auto r = env->CallStaticIntMethodA(info.classID(), info.methodID(), values.data());
+			GEODE_UNWRAP(detail::checkCallException(env, info));
+			return geode::Ok(static_cast<int>(r));
+		} else if constexpr (std::same_as<T, float>) {
+			auto r = env->CallStaticFloatMethodA(info.classID(), info.methodID(), values.data());
+			GEODE_UNWRAP(detail::checkCallException(env, info));
+			return geode::Ok(static_cast<float>(r));
+		} else {
+			auto r = LocalRef::created(env->CallStaticObjectMethodA(info.classID(), info.methodID(), values.data()));
+			GEODE_UNWRAP(detail::checkCallException(env, info));
+			return detail::convertObjectResult<T>(env, std::move(r));
+		}
+	}
+
+	/**
+	 * Calls a static method through a MethodInfo, with a thrown exception's message as the error. See invokeStaticMethod.
+	 */
+	template <detail::CallResultType T, typename... Args>
+	geode::Result<detail::CallResult<T>> performStaticMethodCall(JNIEnv* env, MethodInfo& info, Args... args) {
+		return detail::toStringError(invokeStaticMethod<T>(env, info, args...));
+	}
+
+	/**
+	 * Calls a static JNI method with the given signature and arguments.
+	 * This version accepts an env pointer, which may be faster if you're already using it for other purposes.
+	 */
+	template <typename T, typename... Args>
+	geode::Result<detail::CallResult<T>> callStaticMethod(JNIEnv* env, const char* className, const char* methodName, const char* parameterSignature, Args... args) {
+		GEODE_UNWRAP_INTO(auto& info, getStaticMethodInfo(env, className, methodName, parameterSignature));
+		GEODE_UNWRAP(detail::checkArguments<Args...>(info));
+
+		return performStaticMethodCall<T>(env, info, args...);
+	}
+
+	/**
+	 * Calls a static JNI method with the given signature and arguments.
+	 */
+	template <typename T, typename... Args>
+	geode::Result<detail::CallResult<T>> callStaticMethod(const char* className, const char* methodName, const char* parameterSignature, Args... args) {
+		GEODE_UNWRAP_INTO(auto env, getEnv());
+		return callStaticMethod<T>(env, className, methodName, parameterSignature, args...);
+	}
+
+	/**
+	 * Calls a non-static method through a MethodInfo. See invokeStaticMethod.
+	 */
+	template <detail::CallResultType T, typename... Args>
+	geode::Result<detail::CallResult<T>, Error> invokeMethod(JNIEnv* env, MethodInfo& info, jobject obj, Args... args) {
+		auto values = detail::packArguments(args...);
+		detail::CallRecorder recorder(info);
+
+		if constexpr (std::same_as<T, void>) {
+			env->CallVoidMethodA(obj, info.methodID(), values.data());
+			GEODE_UNWRAP(detail::checkCallException(env, info));
+			return geode::Ok();
+		} else if constexpr (std::same_as<T, bool>) {
+			auto r = env->CallBooleanMethodA(obj, info.methodID(), values.data());
+			GEODE_UNWRAP(detail::checkCallException(env, info));
+			return geode::Ok(r == JNI_TRUE);
+		} else if constexpr (std::same_as<T, int>) {
+			auto r = env->CallIntMethodA(obj, info.methodID(), values.data());
+			GEODE_UNWRAP(detail::checkCallException(env, info));
+			return geode::Ok(static_cast<int>(r));
+		} else if constexpr (std::same_as<T, float>) {
+			auto r = env->CallFloatMethodA(obj, info.methodID(), values.data());
+			GEODE_UNWRAP(detail::checkCallException(env, info));
+			return geode::Ok(static_cast<float>(r));
+		} else {
+			auto r = LocalRef::created(env->CallObjectMethodA(obj, info.methodID(), values.data()));
+			GEODE_UNWRAP(detail::checkCallException(env, info));
+			return detail::convertObjectResult<T>(env, std::move(r));
+		}
+	}
+
+	/**
+	 * Calls a non-static method through a MethodInfo, with a thrown exception's message as the error. See invokeStaticMethod.
+	 */
+	template <detail::CallResultType T, typename... Args>
+	geode::Result<detail::CallResult<T>> performMethodCall(JNIEnv* env, MethodInfo& info, jobject obj, Args... args) {
+		return detail::toStringError(invokeMethod<T>(env, info, obj, args...));
+	}
+
+	/**
+	 * Calls a static JNI method with the given signature and arguments.
+	 * This version accepts an env pointer, which may be faster if you're already using it for other purposes.
+	 */
+	template <typename T, typename... Args>
+	geode::Result<detail::CallResult<T>> callMethod(JNIEnv* env, const char* className, const char* methodName, const char* parameterSignature, jobject obj, Args... args) {
+		GEODE_UNWRAP_INTO(auto& info, getMethodInfo(env, className, methodName, parameterSignature));
+		GEODE_UNWRAP(detail::checkArguments<Args...>(info));
+		return performMethodCall<T>(env, info, obj, args...);
+	}
+
+	/**
+	 * Calls a static JNI method with the given signature and arguments.
+	 */
+	template <typename T, typename... Args>
+	geode::Result<detail::CallResult<T>> callMethod(const char* className, const char* methodName, const char* parameterSignature, jobject obj, Args... args) {
+		GEODE_UNWRAP_INTO(auto env, getEnv());
+		return callMethod<T>(env, className, methodName, parameterSignature, obj, args...);
+	}
+
+	/**
+	 * String literal wrapper, allowing strings to be used as template arguments.
+	 */
+	template <std::size_t N>
+	struct StringLiteral {
+		char value[N];
+
+		consteval StringLiteral(const char (&str)[N]) {
+			std::copy_n(str, N, value);
+		}
+	};
+
+	namespace detail {
+		/**
+		 * Rejects calls whose arguments or result type do not match the method signature.
+		 */
+		template <typename T, StringLiteral Signature, typename... Args>
+		consteval void checkSignature() {
+			constexpr std::string_view signature{Signature.value};
+
+			static_assert(isValidSignature(signature), "malformed JNI method signature");
+			static_assert(parameterCount(signature) == sizeof...(Args), "argument count does not match the JNI method signature");
+			static_assert(argumentsMatch<Args...>(signature), "argument types do not match the JNI method signature");
+			static_assert(returnMatches<T>(signature), "result type does not match the JNI method signature");
+		}
+	}
+
+	/**
+	 * Call-site cache for a static JNI method.
+	 * The method is looked up once, after which calls go directly to the cached MethodInfo.
+	 * Handles should be stored as `static` so that the lookup is shared between calls.
+	 */
+	class StaticMethodHandle final {
+		detail::CacheKey m_key;
+		std::atomic<MethodInfo*> m_info{nullptr};
+
+	public:
+		constexpr StaticMethodHandle(const char* className, const char* methodName, const char* paramSignature)
+			: m_key(detail::EntryKind::StaticMethod, className, methodName, paramSignature) {}
+
+		StaticMethodHandle(const StaticMethodHandle&) = delete;
+		StaticMethodHandle& operator=(const StaticMethodHandle&) = delete;
+
+		/**
+		 * Returns the cached method. A method that doesn't exist is kept too, and its error refers to the cached message.
+		 */
+		geode::Result<MethodInfo&, Error> resolve(JNIEnv* env) {
+			auto info = m_info.load(std::memory_order_acquire);
+			if (!info || !info->isCurrent()) {
+				auto found = detail::lookupMethodInfo(env, m_key);
+				if (!found) {
+					return geode::Err(Error(std::move(found).unwrapErr()));
+				}
+
+				info = &found.unwrap();
+				m_info.store(info, std::memory_order_release);
+			}
+
+			if (!info->missing().empty()) {
+				return geode::Err(Error(info->missing()));
+			}
+
+			return geode::Ok(*info);
+		}
+
+		/**
+		 * Calls the method, keeping a thrown exception in the error. See invokeStaticMethod.
+		 */
+		template <typename T, typename... Args>
+		geode::Result<detail::CallResult<T>, Error> invoke(JNIEnv* env, Args... args) {
+			GEODE_UNWRAP_INTO(auto& info, resolve(env));
+			return invokeStaticMethod<T>(env, info, args...);
+		}
+
+		template <typename T, typename... Args>
+		geode::Result<detail::CallResult<T>> call(JNIEnv* env, Args... args) {
+			return detail::toStringError(invoke<T>(env, args...));
+		}
+
+		template <typename T, typename... Args>
+		geode::Result<detail::CallResult<T>> call(Args... args) {
+			GEODE_UNWRAP_INTO(auto env, getEnv());
+			return call<T>(env, args...);
+		}
+	};
+
+	/**
+	 * Call-site cache for a non-static JNI method.
+	 * See StaticMethodHandle.
+	 */
+	class MethodHandle final {
+		detail::CacheKey m_key;
+		std::atomic<MethodInfo*> m_info{nullptr};
+
+	public:
+		constexpr MethodHandle(const char* className, const char* methodName, const char* paramSignature)
+			: m_key(detail::EntryKind::Method, className, methodName, paramSignature) {}
+
+		MethodHandle(const MethodHandle&) = delete;
+		MethodHandle& operator=(const MethodHandle&) = delete;
+
+		/**
+		 * See StaticMethodHandle::resolve.
+		 */
+		geode::Result<MethodInfo&, Error> resolve(JNIEnv* env) {
+			auto info = m_info.load(std::memory_order_acquire);
+			if (!info || !info->isCurrent()) {
+				auto found = detail::lookupMethodInfo(env, m_key);
+				if (!found) {
+					return geode::Err(Error(std::move(found).unwrapErr()));
+				}
+
+				info = &found.unwrap();
+				m_info.store(info, std::memory_order_release);
+			}
+
+			if (!info->missing().empty()) {
+				return geode::Err(Error(info->missing()));
+			}
+
+			return geode::Ok(*info);
+		}
+
+		/**
+		 * Calls the method, keeping a thrown exception in the error. See invokeStaticMethod.
+		 */
+		template <typename T, typename... Args>
+		geode::Result<detail::CallResult<T>, Error> invoke(JNIEnv* env, jobject obj, Args... args) {
+			GEODE_UNWRAP_INTO(auto& info, resolve(env));
+			return invokeMethod<T>(env, info, obj, args...);
+		}
+
+		template <typename T, typename... Args>
+		geode::Result<detail::CallResult<T>> call(JNIEnv* env, jobject obj, Args... args) {
+			return detail::toStringError(invoke<T>(env, obj, args...));
+		}
+
+		template <typename T, typename... Args>
+		geode::Result<detail::CallResult<T>> call(jobject obj, Args... args) {
+			GEODE_UNWRAP_INTO(auto env, getEnv());
+			return call<T>(env, obj, args...);
+		}
+	};
+
+	/**
+	 * Names a Java class in a method type, such as `Object<"android/view/InputDevice">(jint)`.
+	 * Passed as a jobject, and returned as a LocalRef.
+	 */
+	template <StringLiteral ClassName>
+	struct Object {};
+
+	namespace detail {
+		/**
+		 * Joins strings into a null terminated string at compile time.
+		 */
+		template <const std::string_view&... Parts>
+		struct JoinStrings {
+			static constexpr auto storage = [] {
+				std::array<char, (Parts.size() + ... + 0) + 1> r{};
+
+				auto it = r.begin();
+				((it = std::ranges::copy(Parts, it).out), ...);
+
+				return r;
+			}();
+
+			static constexpr std::string_view value{storage.data(), storage.size() - 1};
+		};
+
+		inline constexpr std::string_view s_signatureArray = "[";
+		inline constexpr std::string_view s_signatureClassBegin = "L";
+		inline constexpr std::string_view s_signatureClassEnd = ";";
+		inline constexpr std::string_view s_signatureParamsBegin = "(";
+		inline constexpr std::string_view s_signatureParamsEnd = ")";
+
+		/**
+		 * Maps a C++ type in a method type to its Java signature,
+		 * the type its arguments are passed as, and the result type of a call returning it.
+		 */
+		template <typename T>
+		struct JavaType;
+
+		template <>
+		struct JavaType<void> {
+			static constexpr std::string_view signature = "V";
+			using Result = void;
+		};
+
+		template <>
+		struct JavaType<bool> {
+			static constexpr std::string_view signature = "Z";
+			using Parameter = bool;
+			using Result = bool;
+		};
+
+		template <Primitive T>
+		struct JavaType<T> {
+			static constexpr char storage[] = {ArrayTraits<T>::signature, '\0'};
+			static constexpr std::string_view signature{storage, 1};
+			using Parameter = T;
+			using Result = T;
+		};
+
+		template <>
+		struct JavaType<std::string> {
+			static constexpr std::string_view signature = "Ljava/lang/String;";
+			using Parameter = jstring;
+			using Result = std::string;
+		};
+
+		template <StringLiteral ClassName>
+		struct JavaType<Object<ClassName>> {
+			static constexpr std::string_view className{ClassName.value};
+			static constexpr std::string_view signature = JoinStrings<s_signatureClassBegin, className, s_signatureClassEnd>::value;
+			using Parameter = jobject;
+			using Result = jobject;
+		};
+
+		template <Primitive T>
+		struct JavaType<std::vector<T>> {
+			static constexpr std::string_view signature = JoinStrings<s_signatureArray, JavaType<T>::signature>::value;
+			using Parameter = ArrayType<T>;
+			using Result = std::vector<T>;
+		};
+
+		// std::vector<bool> is left out, as it would need a jbooleanArray. Use std::vector<jboolean> instead
+		template <typename T> requires (!Primitive<T> && !std::same_as<T, bool>)
+		struct JavaType<std::vector<T>> {
+			static constexpr std::string_view signature = JoinStrings<s_signatureArray, JavaType<T>::signature>::value;
+			using Parameter = jobjectArray;
+			using Result = jobject;
+		};
+
+		template <typename From, typename To>
+		concept ConvertsWithoutNarrowing = requires (From arg) {
+			To{arg};
+		};
+
+		/**
+		 * Signature of a C++ function type, see signatureOf.
+		 */
+		template <typename F>
+		struct MethodType;
+
+		template <typename R, typename... Params>
+		struct MethodType<R(Params...)> {
+			static constexpr std::string_view signature = JoinStrings<
+				s_signatureParamsBegin, JavaType<Params>::signature..., s_signatureParamsEnd, JavaType<R>::signature
+			>::value;
+
+			using Result = typename JavaType<R>::Result;
+
+			/**
+			 * Whether the arguments convert to the parameter types without narrowing.
+			 */
+			template <typename... Args>
+			static constexpr bool accepts() {
+				if constexpr (sizeof...(Args) != sizeof...(Params)) {
+					return false;
+				} else {
+					return (ConvertsWithoutNarrowing<Args, typename JavaType<Params>::Parameter> && ...);
+				}
+			}
+
+			template <typename... Args>
+			static auto invokeStatic(StaticMethodHandle& handle, JNIEnv* env, Args... args) {
+				return handle.invoke<Result>(env, typename JavaType<Params>::Parameter{args}...);
+			}
+
+			template <typename... Args>
+			static auto invoke(MethodHandle& handle, JNIEnv* env, jobject obj, Args... args) {
+				return handle.invoke<Result>(env, obj, typename JavaType<Params>::Parameter{args}...);
+			}
+		};
+	}
+
+	/**
+	 * JNI signature of a C++ function type, generated at compile time. For example, `bool(jint, jlong)` is `(IJ)Z`.
+	 * Supported types are void, bool, the JNI primitives, std::string, Object, and std::vector of any of these for arrays.
+	 * The signature is null terminated.
+	 */
+	template <typename F>
+	inline constexpr std::string_view signatureOf = detail::MethodType<F>::signature;
+
+	/**
+	 * Calls a static JNI method, with the signature generated from a C++ function type and the lookup cached at the call site.
+	 * A thrown exception is kept in the error, and only described if its message is asked for.
+	 * Usage: `invokeStaticMethod<jint(jint), "java/lang/Math", "abs">(env, -5)`
+	 * Arguments are converted to the parameter types, and conversions that could narrow are rejected at compile time.
+	 */
+	template <typename F, StringLiteral ClassName, StringLiteral MethodName, typename... Args>
+	requires std::is_function_v<F> && (detail::MethodType<F>::template accepts<Args...>())
+	auto invokeStaticMethod(JNIEnv* env, Args... args) {
+		static StaticMethodHandle s_handle{ClassName.value, MethodName.value, signatureOf<F>.data()};
+		return detail::MethodType<F>::invokeStatic(s_handle, env, args...);
+	}
+
+	template <typename F, StringLiteral ClassName, StringLiteral MethodName, typename... Args>
+	requires std::is_function_v<F> && (detail::MethodType<F>::template accepts<Args...>())
+	decltype(invokeStaticMethod<F, ClassName, MethodName>(std::declval<JNIEnv*>(), std::declval<Args>()...)) invokeStaticMethod(Args... args) {
+		GEODE_UNWRAP_INTO(auto env, detail::getCallEnv());
+		return invokeStaticMethod<F, ClassName, MethodName>(env, args...);
+	}
+
+	/**
+	 * Like invokeStaticMethod, with a thrown exception's message as the error.
+	 * Usage: `callStaticMethod<jint(jint), "java/lang/Math", "abs">(env, -5)`
+	 */
+	template <typename F, StringLiteral ClassName, StringLiteral MethodName, typename... Args>
+	requires std::is_function_v<F> && (detail::MethodType<F>::template accepts<Args...>())
+	auto callStaticMethod(JNIEnv* env, Args... args) {
+		return detail::toStringError(invokeStaticMethod<F, ClassName, MethodName>(env, args...));
+	}
+
+	template <typename F, StringLiteral ClassName, StringLiteral MethodName, typename... Args>
+	requires std::is_function_v<F> && (detail::MethodType<F>::template accepts<Args...>())
+	decltype(callStaticMethod<F, ClassName, MethodName>(std::declval<JNIEnv*>(), std::declval<Args>()...)) callStaticMethod(Args... args) {
+		GEODE_UNWRAP_INTO(auto env, getEnv());
+		return callStaticMethod<F, ClassName, MethodName>(env, args...);
+	}
+
+	/**
+	 * Calls a non-static JNI method, with the signature generated from a C++ function type and the lookup cached at the call site.
+	 * See invokeStaticMethod.
+	 */
+	template <typename F, StringLiteral ClassName, StringLiteral MethodName, typename... Args>
+	requires std::is_function_v<F> && (detail::MethodType<F>::template accepts<Args...>())
+	auto invokeMethod(JNIEnv* env, jobject obj, Args... args) {
+		static MethodHandle s_handle{ClassName.value, MethodName.value, signatureOf<F>.data()};
+		return detail::MethodType<F>::invoke(s_handle, env, obj, args...);
+	}
+
+	template <typename F, StringLiteral ClassName, StringLiteral MethodName, typename... Args>
+	requires std::is_function_v<F> && (detail::MethodType<F>::template accepts<Args...>())
+	decltype(invokeMethod<F, ClassName, MethodName>(std::declval<JNIEnv*>(), std::declval<jobject>(), std::declval<Args>()...)) invokeMethod(jobject obj, Args... args) {
+		GEODE_UNWRAP_INTO(auto env, detail::getCallEnv());
+		return invokeMethod<F, ClassName, MethodName>(env, obj, args...);
+	}
+
+	/**
+	 * Like invokeMethod, with a thrown exception's message as the error.
+	 */
+	template <typename F, StringLiteral ClassName, StringLiteral MethodName, typename... Args>
+	requires std::is_function_v<F> && (detail::MethodType<F>::template accepts<Args...>())
+	auto callMethod(JNIEnv* env, jobject obj, Args... args) {
+		return detail::toStringError(invokeMethod<F, ClassName, MethodName>(env, obj, args...));
+	}
+
+	template <typename F, StringLiteral ClassName, StringLiteral MethodName, typename... Args>
+	requires std::is_function_v<F> && (detail::MethodType<F>::template accepts<Args...>())
+	decltype(callMethod<F, ClassName, MethodName>(std::declval<JNIEnv*>(), std::declval<jobject>(), std::declval<Args>()...)) callMethod(jobject obj, Args... args) {
+		GEODE_UNWRAP_INTO(auto env, getEnv());
+		return callMethod<F, ClassName, MethodName>(env, obj, args...);
+	}
+
+	/**
+	 * Calls a static JNI method, caching the method lookup at the call site.
+	 * Usage: `callStaticMethod<int, "java/lang/Example", "method", "(I)I">(env, 32)`
+	 * The argument and result types are checked against the signature at compile time.
+	 */
+	template <typename T, StringLiteral ClassName, StringLiteral MethodName, StringLiteral ParamSignature, typename... Args>
+	geode::Result<detail::CallResult<T>> callStaticMethod(JNIEnv* env, Args... args) {
+		detail::checkSignature<T, ParamSignature, Args...>();
+
+		static StaticMethodHandle s_handle{ClassName.value, MethodName.value, ParamSignature.value};
+		return s_handle.call<T>(env, args...);
+	}
+
+	/**
+	 * Calls a static JNI method, caching the method lookup at the call site.
+	 */
+	template <typename T, StringLiteral ClassName, StringLiteral MethodName, StringLiteral ParamSignature, typename... Args>
+	geode::Result<detail::CallResult<T>> callStaticMethod(Args... args) {
+		GEODE_UNWRAP_INTO(auto env, getEnv());
+		return callStaticMethod<T, ClassName, MethodName, ParamSignature>(env, args...);
+	}
+
+	/**
+	 * Calls a non-static JNI method, caching the method lookup at the call site.
+	 * The argument and result types are checked against the signature at compile time.
+	 */
+	template <typename T, StringLiteral ClassName, StringLiteral MethodName, StringLiteral ParamSignature, typename... Args>
+	geode::Result<detail::CallResult<T>> callMethod(JNIEnv* env, jobject obj, Args... args) {
+		detail::checkSignature<T, ParamSignature, Args...>();
+
+		static MethodHandle s_handle{ClassName.value, MethodName.value, ParamSignature.value};
+		return s_handle.call<T>(env, obj, args...);
+	}
+
+	/**
+	 * Calls a non-static JNI method, caching the method lookup at the call site.
+	 */
+	template <typename T, StringLiteral ClassName, StringLiteral MethodName, StringLiteral ParamSignature, typename... Args>
+	geode::Result<detail::CallResult<T>> callMethod(jobject obj, Args... args) {
+		GEODE_UNWRAP_INTO(auto env, getEnv());
+		return callMethod<T, ClassName, MethodName, ParamSignature>(env, obj, args...);
+	}
+
+	namespace detail {
+		/**
+		 * Type a field of the given method-type type is accessed as through JNI.
+		 */
+		template <typename T>
+		using RawFieldType = std::conditional_t<std::same_as<T, bool>, jboolean, std::conditional_t<Primitive<T>, T, jobject>>;
+
+		/**
+		 * Result of reading a field. Object fields are returned as a LocalRef.
+		 */
+		template <typename T>
+		using FieldValue = std::conditional_t<std::same_as<typename JavaType<T>::Result, jobject>, LocalRef, typename JavaType<T>::Result>;
+
+		/**
+		 * Value accepted when writing a field. Strings are converted to a new Java string.
+		 */
+		template <typename T>
+		using FieldArgument = std::conditional_t<std::same_as<T, std::string>, std::string_view, typename JavaType<T>::Parameter>;
+
+		template <typename T>
+		geode::Result<FieldValue<T>> convertField(JNIEnv* env, RawFieldType<T> raw) {
+			if constexpr (std::same_as<T, bool>) {
+				return geode::Ok(raw == JNI_TRUE);
+			} else if constexpr (Primitive<T>) {
+				return geode::Ok(raw);
+			} else {
+				LocalRef ref = LocalRef::created(raw);
+
+				if constexpr (std::same_as<T, std::string>) {
+					return toString(env, ref.get<jstring>());
+				} else if constexpr (PrimitiveVector<FieldValue<T>>) {
+					using E = typename FieldValue<T>::value_type;
+					return extractArray<E>(env, ref.get<ArrayType<E>>());
+				} else {
+					return geode::Ok(std::move(ref));
+				}
+			}
+		}
+	}
+
+	/**
+	 * Reads a field through a FieldInfo.
+	 * T is written as in a method type: a JNI primitive, bool, std::string, Object, or std::vector for arrays.
+	 * For static fields, `obj` is ignored.
+	 */
+	template <typename T>
+	geode::Result<detail::FieldValue<T>> getField(JNIEnv* env, const FieldInfo& info, jobject obj = nullptr) {
+		using Raw = detail::RawFieldType<T>;
+
+		if (info.isStatic()) {
+			return detail::convertField<T>(env, FieldTraits<Raw>::getStatic(env, info.classID(), info.fieldID()));
+		}
+
+		if (obj == nullptr) {
+			return geode::Err("getField: null object");
+		}
+
+		return detail::convertField<T>(env, FieldTraits<Raw>::get(env, obj, info.fieldID()));
+	}
+
+	/**
+	 * Writes a field through a FieldInfo. See getField.
+	 */
+	template <typename T>
+	geode::Result<> setField(JNIEnv* env, const FieldInfo& info, jobject obj, detail::FieldArgument<T> value) {
+		using Raw = detail::RawFieldType<T>;
+
+		if (!info.isStatic() && obj == nullptr) {
+			return geode::Err("setField: null object");
+		}
+
+		auto write = [&](Raw raw) {
+			if (info.isStatic()) {
+				FieldTraits<Raw>::setStatic(env, info.classID(), info.fieldID(), raw);
+			} else {
+				FieldTraits<Raw>::set(env, obj, info.fieldID(), raw);
+			}
+		};
+
+		if constexpr (std::same_as<T, std::string>) {
+			GEODE_UNWRAP_INTO(auto str, toJString(env, value));
+			write(*str);
+		} else if constexpr (std::same_as<T, bool>) {
+			write(value ? JNI_TRUE : JNI_FALSE);
+		} else {
+			write(value);
+		}
+
+		return geode::Ok();
+	}
+
+	/**
+	 * Call-site cache for a static JNI field.
+	 * The field is looked up once, after which accesses go directly to the cached FieldInfo.
+	 */
+	class StaticFieldHandle final {
+		detail::CacheKey m_key;
+		std::atomic<FieldInfo*> m_info{nullptr};
+
+	public:
+		constexpr StaticFieldHandle(const char* className, const char* fieldName, const char* signature)
+			: m_key(detail::EntryKind::StaticField, className, fieldName, signature) {}
+
+		StaticFieldHandle(const StaticFieldHandle&) = delete;
+		StaticFieldHandle& operator=(const StaticFieldHandle&) = delete;
+
+		geode::Result<FieldInfo&> resolve(JNIEnv* env) {
+			if (auto info = m_info.load(std::memory_order_acquire); info && info->isCurrent()) {
+				return geode::Ok(*info);
+			}
+
+			GEODE_UNWRAP_INTO(auto& info, detail::getFieldInfo(env, m_key));
+			m_info.store(&info, std::memory_order_release);
+
+			return geode::Ok(info);
+		}
+	};
+
+	/**
+	 * Call-site cache for a non-static JNI field.
+	 * See StaticFieldHandle.
+	 */
+	class FieldHandle final {
+		detail::CacheKey m_key;
+		std::atomic<FieldInfo*> m_info{nullptr};
+
+	public:
+		constexpr FieldHandle(const char* className, const char* fieldName, const char* signature)
+			: m_key(detail::EntryKind::Field, className, fieldName, signature) {}
+
+		FieldHandle(const FieldHandle&) = delete;
+		FieldHandle& operator=(const FieldHandle&) = delete;
+
+		geode::Result<FieldInfo&> resolve(JNIEnv* env) {
+			if (auto info = m_info.load(std::memory_order_acquire); info && info->isCurrent()) {
+				return geode::Ok(*info);
+			}
+
+			GEODE_UNWRAP_INTO(auto& info, detail::getFieldInfo(env, m_key));
+			m_info.store(&info, std::memory_order_release);
+
+			return geode::Ok(info);
+		}
+	};
+
+	/**
+	 * Reads a non-static field, caching the field lookup at the call site. The signature is generated from T.
+	 * Usage: `getField<jint, "android/graphics/Point", "x">(env, point)`
+	 */
+	template <typename T, StringLiteral ClassName, StringLiteral FieldName>
+	geode::Result<detail::FieldValue<T>> getField(JNIEnv* env, jobject obj) {
+		static FieldHandle s_handle{ClassName.value, FieldName.value, detail::JavaType<T>::signature.data()};
+
+		GEODE_UNWRAP_INTO(auto& info, s_handle.resolve(env));
+		return getField<T>(env, info, obj);
+	}
+
+	/**
+	 * Writes a non-static field, caching the field lookup at the call site.
+	 */
+	template <typename T, StringLiteral ClassName, StringLiteral FieldName>
+	geode::Result<> setField(JNIEnv* env, jobject obj, detail::FieldArgument<T> value) {
+		static FieldHandle s_handle{ClassName.value, FieldName.value, detail::JavaType<T>::signature.data()};
+
+		GEODE_UNWRAP_INTO(auto& info, s_handle.resolve(env));
+		return setField<T>(env, info, obj, value);
+	}
+
+	/**
+	 * Reads a static field, caching the field lookup at the call site.
+	 */
+	template <typename T, StringLiteral ClassName, StringLiteral FieldName>
+	geode::Result<detail::FieldValue<T>> getStaticField(JNIEnv* env) {
+		static StaticFieldHandle s_handle{ClassName.value, FieldName.value, detail::JavaType<T>::signature.data()};
+
+		GEODE_UNWRAP_INTO(auto& info, s_handle.resolve(env));
+		return getField<T>(env, info);
+	}
+
+	/**
+	 * Writes a static field, caching the field lookup at the call site.
+	 */
+	template <typename T, StringLiteral ClassName, StringLiteral FieldName>
+	geode::Result<> setStaticField(JNIEnv* env, detail::FieldArgument<T> value) {
+		static StaticFieldHandle s_handle{ClassName.value, FieldName.value, detail::JavaType<T>::signature.data()};
+
+		GEODE_UNWRAP_INTO(auto& info, s_handle.resolve(env));
+		return setField<T>(env, info, nullptr, value);
+	}
+
+	/**
+	 * Binds a Java field to a member of a C++ struct, see StructMapper.
+	 */
+	template <StringLiteral FieldName, typename S, typename M, typename T>
+	struct FieldBinding {
+		using Struct = S;
+		using JavaType = T;
+
+		static constexpr std::string_view name{FieldName.value};
+
+		M S::* member;
+	};
+
+	/**
+	 * Creates a field binding. The Java type of the field is derived from the member type, unless given as T.
+	 * A member whose type differs from T, such as an enum, is converted with a static_cast.
+	 */
+	template <StringLiteral FieldName, typename T = void, typename S, typename M>
+	constexpr auto field(M S::* member) {
+		return FieldBinding<FieldName, S, M, std::conditional_t<std::same_as<T, void>, M, T>>{member};
+	}
+
+	/**
+	 * Reads a list of fields of a Java object into a C++ struct.
+	 * All field IDs are resolved together on first use, so a read performs no lookups.
+	 * Mappers should be stored as `static`, like method handles:
+	 * `static jni::StructMapper s_mapper{"android/graphics/Point", jni::field<"x">(&Point::x), jni::field<"y">(&Point::y)};`
+	 */
+	template <typename S, typename... Bindings>
+	class StructMapper final {
+		static constexpr std::uint32_t s_unresolved = ~std::uint32_t{0};
+
+		const char* m_className;
+		std::tuple<Bindings...> m_bindings;
+		std::array<jfieldID, sizeof...(Bindings)> m_fieldIds{};
+		std::atomic_uint32_t m_epoch{s_unresolved};
+		std::mutex m_resolveMutex{};
+
+		template <std::size_t I>
+		geode::Result<> resolveField(JNIEnv* env) {
+			using Binding = std::tuple_element_t<I, std::tuple<Bindings...>>;
+
+			detail::CacheKey key{
+				detail::EntryKind::Field, m_className, Binding::name, detail::JavaType<typename Binding::JavaType>::signature
+			};
+
+			GEODE_UNWRAP_INTO(auto& info, detail::getFieldInfo(env, key));
+			m_fieldIds[I] = info.fieldID();
+
+			return geode::Ok();
+		}
+
+		template <std::size_t I>
+		geode::Result<> readField(JNIEnv* env, jobject obj, S& out) const {
+			using Binding = std::tuple_element_t<I, std::tuple<Bindings...>>;
+			using T = typename Binding::JavaType;
+			using Raw = detail::RawFieldType<T>;
+
+			auto value = detail::convertField<T>(env, FieldTraits<Raw>::get(env, obj, m_fieldIds[I]));
+			if (!value) {
+				return geode::Err("StructMapper: failed to read " + std::string(Binding::name) + ": " + value.unwrapErr());
+			}
+
+			auto& member = out.*(std::get<I>(m_bindings).member);
+			member = static_cast<std::remove_reference_t<decltype(member)>>(std::move(value).unwrap());
+
+			return geode::Ok();
+		}
+
+		template <std::size_t... I>
+		geode::Result<> resolveFields(JNIEnv* env, std::index_sequence<I...>) {
+			geode::Result<> r = geode::Ok();
+			((r = resolveField<I>(env)).isOk() && ...);
+			return r;
+		}
+
+		template <std::size_t... I>
+		geode::Result<> readFields(JNIEnv* env, jobject obj, S& out, std::index_sequence<I...>) const {
+			geode::Result<> r = geode::Ok();
+			((r = readField<I>(env, obj, out)).isOk() && ...);
+			return r;
+		}
+
+	public:
+		constexpr StructMapper(const char* className, Bindings... bindings)
+			: m_className(className), m_bindings(bindings...) {}
+
+		StructMapper(const StructMapper&) = delete;
+		StructMapper& operator=(const StructMapper&) = delete;
+
+		/**
+		 * Looks up every field ID. Called automatically by read, and again after the ID cache is reset.
+		 */
+		geode::Result<> resolve(JNIEnv* env) {
+			std::scoped_lock lock(m_resolveMutex);
+
+			auto epoch = detail::s_cacheEpoch.load(std::memory_order_relaxed);
+			if (m_epoch.load(std::memory_order_relaxed) == epoch) {
+				return geode::Ok();
+			}
+
+			GEODE_UNWRAP(resolveFields(env, std::index_sequence_for<Bindings...>{}));
+			m_epoch.store(epoch, std::memory_order_release);
+
+			return geode::Ok();
+		}
+
+		/**
+		 * Reads every bound field of `obj` into `out`. Stops at the first field that can't be read.
+		 */
+		geode::Result<> read(JNIEnv* env, jobject obj, S& out) {
+			if (m_epoch.load(std::memory_order_acquire) != detail::s_cacheEpoch.load(std::memory_order_relaxed)) {
+				GEODE_UNWRAP(resolve(env));
+			}
+
+			if (obj == nullptr) {
+				return geode::Err("StructMapper: null object");
+			}
+
+			return readFields(env, obj, out, std::index_sequence_for<Bindings...>{});
+		}
+
+		geode::Result<S> read(JNIEnv* env, jobject obj) {
+			S r{};
+			GEODE_UNWRAP(read(env, obj, r));
+			return geode::Ok(std::move(r));
+		}
+	};
+
+	template <typename Binding, typename... Bindings>
+	StructMapper(const char*, Binding, Bindings...) -> StructMapper<typename Binding::Struct, Binding, Bindings...>;
 };
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <Geode/Result.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "executor.hpp"
+#include "jni.hpp"
+
+namespace launcher_utils::jni {
+	namespace detail {
+		/**
+		 * Running average of how long a kind of task takes. Only touched on the main thread.
+		 */
+		struct CostEstimate {
+			std::uint64_t nanoseconds{0};
+
+			void update(std::uint64_t sample) {
+				nanoseconds = nanoseconds == 0 ? sample : (nanoseconds * 7 + sample) / 8;
+			}
+		};
+
+		/**
+		 * Each call site submits its own lambda type, so this gives every call site its own estimate.
+		 */
+		template <typename F>
+		CostEstimate& costEstimateFor() {
+			static CostEstimate s_estimate{};
+			return s_estimate;
+		}
+	}
+
+	struct FrameSchedulerStats {
+		/**
+		 * Frames that had work queued.
+		 */
+		std::uint64_t frames{};
+
+		std::uint64_t tasksRun{};
+
+		/**
+		 * Times a task was left for a later frame, and the most left over in one frame.
+		 */
+		std::uint64_t tasksDeferred{};
+		std::size_t maxDeferredInFrame{};
+		std::size_t lastFrameDeferred{};
+
+		/**
+		 * Tasks estimated to take longer than the whole budget, which ran alone in a frame.
+		 */
+		std::uint64_t oversizedRuns{};
+
+		std::uint64_t framesOverBudget{};
+		std::uint64_t totalRunNanoseconds{};
+		std::uint64_t maxFrameNanoseconds{};
+
+		/**
+		 * Tasks waiting for a later frame.
+		 */
+		std::size_t queueDepth{};
+	};
+
+	/**
+	 * Runs low priority JNI calls on the main thread, a limited amount per frame.
+	 * Tasks run in submission order for as long as their estimated cost fits in the frame's budget. The estimate is
+	 * learned from how long earlier tasks from the same call site took. The first task that doesn't fit and every task
+	 * after it are left for a later frame. Every frame runs at least the first task in line, so a task estimated over
+	 * the whole budget runs alone in a frame, and a task never waits for more frames than there are tasks ahead of it.
+	 *
+	 * Unlike the Executor, tasks run on the main thread, so they can use launcher classes and touch the game freely.
+	 */
+	class FrameScheduler final {
+		struct Entry {
+			detail::Task* task;
+			detail::CostEstimate* estimate;
+		};
+
+		mutable std::mutex m_mutex{};
+		std::vector<Entry> m_incoming{};
+		bool m_frameQueued{false};
+
+		std::vector<Entry> m_queue{};
+		std::chrono::nanoseconds m_budget{std::chrono::microseconds(500)};
+
+		FrameSchedulerStats m_stats{};
+
+		FrameScheduler() = default;
+
+		void push(detail::Task* task, detail::CostEstimate& estimate);
+		void queueFrame();
+
+	public:
+		static FrameScheduler& get();
+
+		FrameScheduler(const FrameScheduler&) = delete;
+		FrameScheduler& operator=(const FrameScheduler&) = delete;
+
+		~FrameScheduler();
+
+		/**
+		 * Queues a call for a later frame. `function` receives the main thread's environment.
+		 */
+		template <typename F>
+		void submit(F&& function) {
+			auto& estimate = detail::costEstimateFor<std::decay_t<F>>();
+
+			auto task = [function = std::forward<F>(function)](geode::Result<JNIEnv*>& env) mutable {
+				if (env) {
+					function(env.unwrap());
+				}
+			};
+
+			push(new detail::FunctionTask<decltype(task)>(std::move(task)), estimate);
+		}
+
+		/**
+		 * Queues a call returning a geode::Result, and passes the result to `onComplete` right after it runs.
+		 */
+		template <typename F, typename C>
+		void submit(F&& function, C&& onComplete) {
+			using R = std::invoke_result_t<F&, JNIEnv*>;
+
+			auto& estimate = detail::costEstimateFor<std::decay_t<F>>();
+
+			auto task = [function = std::forward<F>(function), onComplete = std::forward<C>(onComplete)](geode::Result<JNIEnv*>& env) mutable {
+				onComplete(detail::runTask<R>(function, env));
+			};
+
+			push(new detail::FunctionTask<decltype(task)>(std::move(task)), estimate);
+		}
+
+		/**
+		 * Sets how much time queued work may take per frame. Defaults to 500 microseconds.
+		 */
+		void setBudget(std::chrono::microseconds budget);
+
+		/**
+		 * Runs queued work until the frame's budget is spent. This is queued on the main thread whenever work is
+		 * waiting, so it only needs to be called directly to run work sooner. Must be called on the main thread.
+		 */
+		void runFrame();
+
+		FrameSchedulerStats stats() const;
+		void resetStats();
+	};
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "jni.hpp"
+
+/**
+ * Timeline tracing of JNI calls, exported in Chrome's trace event format (viewable in Perfetto or chrome://tracing).
+ * Requires building with LAUNCHER_UTILS_TRACING; otherwise these functions do nothing and traces are empty.
+ *
+ * Every thread records into its own fixed-size ring buffer, so recording does not lock or allocate,
+ * apart from creating the buffer on a thread's first event. Once a buffer is full, its oldest events are overwritten.
+ * A thread's buffer is kept after the thread exits, until a new thread takes it over and drops its events.
+ */
+namespace launcher_utils::jni {
+	/**
+	 * Number of events each thread's buffer holds.
+	 */
+	inline constexpr std::size_t s_traceBufferEvents = 8192;
+
+	struct TraceStats {
+		/**
+		 * Buffers allocated so far, which is the most threads that have recorded events at the same time.
+		 */
+		std::size_t threads{};
+		std::uint64_t events{};
+
+		/**
+		 * Events that were overwritten because a buffer was full.
+		 */
+		std::uint64_t droppedEvents{};
+	};
+
+	constexpr bool isTracingAvailable() {
+#ifdef LAUNCHER_UTILS_TRACING
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	/**
+	 * Clears all buffers and starts recording calls, cache misses and frame markers.
+	 */
+	void startTracing();
+
+	void stopTracing();
+
+	bool isTracing();
+
+	/**
+	 * Records a frame boundary. Call this once per frame, for example from a scheduled update.
+	 */
+	void markTraceFrame();
+
+	TraceStats getTraceStats();
+
+	/**
+	 * Returns the recorded events as Chrome trace event JSON.
+	 * Tracing should be stopped first, since events recorded during the export may be read while being written.
+	 */
+	std::string getTraceJson();
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <Geode/Result.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "executor.hpp"
+#include "jni.hpp"
+
+namespace launcher_utils::jni {
+	/**
+	 * A class, method or field to resolve ahead of its first use.
+	 * The strings must be null terminated and outlive the warm-up, such as string literals or `signatureOf`.
+	 */
+	class WarmupTarget {
+		detail::CacheKey m_key;
+
+		constexpr explicit WarmupTarget(const detail::CacheKey& key) : m_key(key) {}
+
+	public:
+		static constexpr WarmupTarget forClass(std::string_view className) {
+			return WarmupTarget{detail::CacheKey{detail::EntryKind::Class, className}};
+		}
+
+		static constexpr WarmupTarget staticMethod(std::string_view className, std::string_view methodName, std::string_view signature) {
+			return WarmupTarget{detail::CacheKey{detail::EntryKind::StaticMethod, className, methodName, signature}};
+		}
+
+		static constexpr WarmupTarget method(std::string_view className, std::string_view methodName, std::string_view signature) {
+			return WarmupTarget{detail::CacheKey{detail::EntryKind::Method, className, methodName, signature}};
+		}
+
+		static constexpr WarmupTarget staticField(std::string_view className, std::string_view fieldName, std::string_view signature) {
+			return WarmupTarget{detail::CacheKey{detail::EntryKind::StaticField, className, fieldName, signature}};
+		}
+
+		static constexpr WarmupTarget field(std::string_view className, std::string_view fieldName, std::string_view signature) {
+			return WarmupTarget{detail::CacheKey{detail::EntryKind::Field, className, fieldName, signature}};
+		}
+
+		const detail::CacheKey& key() const {
+			return m_key;
+		}
+	};
+
+	/**
+	 * Adds targets to the warm-up list. Targets that are already listed are skipped.
+	 * The list starts out with every class and method used by geode.hpp.
+	 */
+	void addWarmupTargets(std::span<const WarmupTarget> targets);
+
+	inline void addWarmupTargets(std::initializer_list<WarmupTarget> targets) {
+		addWarmupTargets(std::span{targets.begin(), targets.size()});
+	}
+
+	/**
+	 * Adds targets to the warm-up list from a static initializer, next to the code using them:
+	 * `static jni::WarmupRegistrar s_warmup{jni::WarmupTarget::staticMethod("com/example/Foo", "bar", "()V")};`
+	 */
+	struct WarmupRegistrar {
+		WarmupRegistrar(std::initializer_list<WarmupTarget> targets) {
+			addWarmupTargets(targets);
+		}
+	};
+
+	struct WarmupEntry {
+		WarmupTarget target;
+		std::uint64_t nanoseconds{};
+
+		/**
+		 * Empty if the target was resolved.
+		 */
+		std::string error{};
+	};
+
+	struct WarmupReport {
+		/**
+		 * Time from the start of the warm-up until the last target was resolved.
+		 */
+		std::uint64_t totalNanoseconds{};
+
+		/**
+		 * Time the thread that started the warm-up was blocked for. For a background warm-up, this is only the class lookups.
+		 */
+		std::uint64_t blockingNanoseconds{};
+
+		std::size_t resolved{};
+		std::size_t failed{};
+
+		/**
+		 * Classes first, in the order they were first listed, followed by the members.
+		 */
+		std::vector<WarmupEntry> entries{};
+	};
+
+	/**
+	 * Resolves every target on the warm-up list now, so the first call of each method doesn't pay for the lookup.
+	 * The library already starts warmUpAsync on the main thread once the mod has loaded, unless it is configured
+	 * with `LAUNCHER_UTILS_AUTO_WARMUP` off, so this is only needed for targets added later or to get a report.
+	 * Targets that don't exist are cached as missing. Must run on the main thread, as other threads can't find launcher classes.
+	 */
+	geode::Result<WarmupReport> warmUp();
+
+	/**
+	 * Resolves the classes on the warm-up list on the calling thread, which must be the main thread,
+	 * then resolves the methods and fields on the executor's worker thread.
+	 */
+	Future<geode::Result<WarmupReport>> warmUpAsync();
+
+	/**
+	 * Like warmUpAsync, passing the report to `onComplete` on the main thread.
+	 */
+	void warmUpAsync(std::function<void(geode::Result<WarmupReport>)> onComplete);
+
+	/**
+	 * Formats a warm-up report as a summary line followed by one line per entry, slowest first.
+	 */
+	std::string formatWarmupReport(const WarmupReport& report);
+}
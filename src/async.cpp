@@ -0,0 +1,93 @@
+#include <launcher-utils/async.hpp>
+
+#include <array>
+#include <new>
+
+using namespace launcher_utils;
+
+namespace {
+	constexpr std::size_t s_frameGranularity = 64;
+	constexpr std::size_t s_frameClassCount = 16;
+
+	/**
+	 * Freed frames kept per size class, beyond which frames go back to the heap.
+	 */
+	constexpr std::size_t s_maxPooledFrames = 32;
+
+	struct FreeFrame {
+		FreeFrame* next;
+	};
+
+	/**
+	 * Frames are usually created and freed on the main thread, so each thread keeps its own lists and never locks.
+	 * A frame freed on another thread simply moves to that thread's lists.
+	 */
+	struct FramePool {
+		std::array<FreeFrame*, s_frameClassCount> frames{};
+		std::array<std::size_t, s_frameClassCount> counts{};
+
+		std::uint64_t allocations{0};
+		std::uint64_t reused{0};
+
+		~FramePool() {
+			for (auto frame : frames) {
+				while (frame != nullptr) {
+					::operator delete(std::exchange(frame, frame->next));
+				}
+			}
+		}
+	};
+
+	thread_local FramePool s_framePool{};
+
+	std::size_t sizeClass(std::size_t size) {
+		return (size - 1) / s_frameGranularity;
+	}
+}
+
+void* launcher_utils::detail::allocateFrame(std::size_t size) {
+	auto& pool = s_framePool;
+	pool.allocations++;
+
+	auto index = sizeClass(size);
+	if (index >= s_frameClassCount) {
+		return ::operator new(size);
+	}
+
+	if (auto frame = pool.frames[index]) {
+		pool.frames[index] = frame->next;
+		pool.counts[index]--;
+
+		pool.reused++;
+		return frame;
+	}
+
+	// round up, so the frame can be reused by any coroutine of the same class
+	return ::operator new((index + 1) * s_frameGranularity);
+}
+
+void launcher_utils::detail::freeFrame(void* frame, std::size_t size) {
+	auto index = sizeClass(size);
+	if (index >= s_frameClassCount) {
+		::operator delete(frame);
+		return;
+	}
+
+	auto& pool = s_framePool;
+	if (pool.counts[index] >= s_maxPooledFrames) {
+		::operator delete(frame);
+		return;
+	}
+
+	pool.frames[index] = new (frame) FreeFrame{pool.frames[index]};
+	pool.counts[index]++;
+}
+
+FramePoolStats launcher_utils::getFramePoolStats() {
+	FramePoolStats stats{};
+
+	stats.allocations = s_framePool.allocations;
+	stats.reused = s_framePool.reused;
+
+	return stats;
+}
@@ -0,0 +1,173 @@
+#include <launcher-utils/battery.hpp>
+
+#include <algorithm>
+
+using namespace launcher_utils;
+
+namespace {
+	geode::Result<BatteryState, jni::Error> fetchBatteryState(JNIEnv* env, int deviceId) {
+		static jni::StaticMethodHandle s_hasBattery{"com/geode/launcher/utils/GeodeUtils", "deviceHasBattery", "(I)Z"};
+		static jni::StaticMethodHandle s_getCapacity{"com/geode/launcher/utils/GeodeUtils", "getDeviceBatteryCapacity", "(I)F"};
+		static jni::StaticMethodHandle s_getStatus{"com/geode/launcher/utils/GeodeUtils", "getDeviceBatteryStatus", "(I)I"};
+
+		BatteryState state{};
+
+		GEODE_UNWRAP_INTO(state.hasBattery, s_hasBattery.invoke<bool>(env, deviceId));
+		if (!state.hasBattery) {
+			return geode::Ok(state);
+		}
+
+		GEODE_UNWRAP_INTO(state.capacity, s_getCapacity.invoke<float>(env, deviceId));
+		GEODE_UNWRAP_INTO(auto status, s_getStatus.invoke<int>(env, deviceId));
+		state.status = static_cast<InputDevice::BatteryStatus>(status);
+
+		return geode::Ok(state);
+	}
+}
+
+BatteryMonitor& BatteryMonitor::get() {
+	static BatteryMonitor s_monitor{};
+	return s_monitor;
+}
+
+void BatteryMonitor::setTTL(std::chrono::steady_clock::duration ttl) {
+	std::scoped_lock lock(m_mutex);
+	m_ttl = ttl;
+}
+
+BatteryMonitor::Entry& BatteryMonitor::findEntry(int deviceId) {
+	auto it = std::find_if(m_entries.begin(), m_entries.end(), [deviceId](const Entry& entry) {
+		return entry.deviceId == deviceId;
+	});
+
+	if (it != m_entries.end()) {
+		return *it;
+	}
+
+	// a new entry starts out stale, so it is fetched with the next batch
+	return m_entries.emplace_back(Entry{deviceId, BatteryState{}, std::chrono::steady_clock::time_point{}});
+}
+
+std::optional<jni::Error> BatteryMonitor::refreshStale(
+	std::chrono::steady_clock::time_point now, std::vector<std::pair<int, BatteryState>>& changed, int deviceId
+) {
+	auto envRes = jni::detail::getCallEnv();
+	if (!envRes) {
+		return std::move(envRes).unwrapErr();
+	}
+
+	auto env = envRes.unwrap();
+	std::optional<jni::Error> error{};
+
+	for (auto& entry : m_entries) {
+		auto known = entry.updated != std::chrono::steady_clock::time_point{};
+		if (known && now - entry.updated < m_ttl) {
+			continue;
+		}
+
+		auto state = fetchBatteryState(env, entry.deviceId);
+		if (!state) {
+			// keeps the previous state, and stays stale so the next query tries again
+			if (entry.deviceId == deviceId) {
+				error.emplace(std::move(state).unwrapErr());
+			}
+
+			continue;
+		}
+
+		entry.updated = now;
+
+		if (known && state.unwrap() != entry.state) {
+			changed.emplace_back(entry.deviceId, state.unwrap());
+		}
+
+		entry.state = state.unwrap();
+	}
+
+	return error;
+}
+
+void BatteryMonitor::notify(const std::vector<std::pair<int, BatteryState>>& changed) {
+	if (changed.empty()) {
+		return;
+	}
+
+	std::vector<Callback> listeners{};
+	{
+		std::scoped_lock lock(m_mutex);
+		for (const auto& [id, callback] : m_listeners) {
+			listeners.push_back(callback);
+		}
+	}
+
+	for (const auto& [deviceId, state] : changed) {
+		for (const auto& callback : listeners) {
+			callback(deviceId, state);
+		}
+	}
+}
+
+geode::Result<BatteryState> BatteryMonitor::getState(int deviceId) {
+	std::vector<std::pair<int, BatteryState>> changed{};
+	std::optional<jni::Error> error{};
+	BatteryState state{};
+	bool known{};
+
+	{
+		std::scoped_lock lock(m_mutex);
+
+		auto now = std::chrono::steady_clock::now();
+		auto& entry = findEntry(deviceId);
+		if (entry.updated == std::chrono::steady_clock::time_point{} || now - entry.updated >= m_ttl) {
+			error = refreshStale(now, changed, deviceId);
+		}
+
+		auto& refreshed = findEntry(deviceId);
+		state = refreshed.state;
+		known = refreshed.updated != std::chrono::steady_clock::time_point{};
+	}
+
+	notify(changed);
+
+	if (!known) {
+		return geode::Err(error ? error->message() : "BatteryMonitor: battery state unavailable");
+	}
+
+	return geode::Ok(state);
+}
+
+void BatteryMonitor::refresh() {
+	std::vector<std::pair<int, BatteryState>> changed{};
+
+	{
+		std::scoped_lock lock(m_mutex);
+		(void)refreshStale(std::chrono::steady_clock::now(), changed);
+	}
+
+	notify(changed);
+}
+
+void BatteryMonitor::forget(int deviceId) {
+	std::scoped_lock lock(m_mutex);
+
+	std::erase_if(m_entries, [deviceId](const Entry& entry) {
+		return entry.deviceId == deviceId;
+	});
+}
+
+std::size_t BatteryMonitor::addListener(Callback callback) {
+	std::scoped_lock lock(m_mutex);
+
+	auto id = m_nextListenerId++;
+	m_listeners.emplace_back(id, std::move(callback));
+
+	return id;
+}
+
+void BatteryMonitor::removeListener(std::size_t id) {
+	std::scoped_lock lock(m_mutex);
+
+	std::erase_if(m_listeners, [id](const auto& listener) {
+		return listener.first == id;
+	});
+}
@@ -0,0 +1,206 @@
+#include "cache.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+using namespace launcher_utils::jni::detail;
+
+void* Arena::allocate(std::size_t size, std::size_t align) {
+	auto offset = (m_chunkUsed + align - 1) & ~(align - 1);
+
+	if (size > s_chunkSize / 4) {
+		// oversized allocations get their own chunk, kept behind the current one so it isn't wasted
+		auto chunk = std::make_unique<std::byte[]>(size);
+		auto ptr = chunk.get();
+		m_chunks.insert(m_chunks.empty() ? m_chunks.end() : m_chunks.end() - 1, std::move(chunk));
+
+		m_reserved += size;
+		m_used += size;
+
+		return ptr;
+	}
+
+	if (offset + size > s_chunkSize) {
+		m_chunks.push_back(std::make_unique<std::byte[]>(s_chunkSize));
+		m_reserved += s_chunkSize;
+		offset = 0;
+	}
+
+	m_chunkUsed = offset + size;
+	m_used += size;
+
+	return m_chunks.back().get() + offset;
+}
+
+std::string_view Arena::intern(std::string_view str) {
+	if (str.empty()) {
+		return {};
+	}
+
+	auto ptr = static_cast<char*>(allocate(str.size() + 1, 1));
+	std::memcpy(ptr, str.data(), str.size());
+	ptr[str.size()] = '\0';
+
+	return {ptr, str.size()};
+}
+
+IdCache::Table::Table(std::size_t capacity)
+	: mask(capacity - 1), slots(std::make_unique<std::atomic<CacheEntry*>[]>(capacity)) {}
+
+CacheEntry* IdCache::Table::find(const CacheKey& key) const {
+	for (auto idx = key.hash & mask;; idx = (idx + 1) & mask) {
+		auto entry = slots[idx].load(std::memory_order_acquire);
+		if (entry == nullptr) {
+			return nullptr;
+		}
+
+		if (entry->key == key) {
+			return entry;
+		}
+	}
+}
+
+void IdCache::Table::place(CacheEntry* entry) {
+	auto idx = entry->key.hash & mask;
+	while (slots[idx].load(std::memory_order_relaxed) != nullptr) {
+		idx = (idx + 1) & mask;
+	}
+
+	slots[idx].store(entry, std::memory_order_release);
+}
+
+IdCache::IdCache() {
+	m_table.store(m_tables.emplace_back(std::make_unique<Table>(64)).get());
+}
+
+IdCache::Table& IdCache::tableForInsert() {
+	auto& table = *m_tables.back();
+
+	// keep the load factor at or below 1/2 so probe sequences stay short
+	auto capacity = table.mask + 1;
+	if ((m_size + 1) * 2 <= capacity) {
+		return table;
+	}
+
+	// readers may still be probing the old table, so it is retired instead of freed
+	auto& grown = *m_tables.emplace_back(std::make_unique<Table>(capacity * 2));
+	for (std::size_t i = 0; i < capacity; i++) {
+		if (auto entry = table.slots[i].load(std::memory_order_relaxed)) {
+			grown.place(entry);
+		}
+	}
+
+	m_table.store(&grown, std::memory_order_release);
+
+	return grown;
+}
+
+CacheEntry& IdCache::publish(CacheEntry* entry) {
+	tableForInsert().place(entry);
+	m_size++;
+
+	return *entry;
+}
+
+CacheKey IdCache::internKey(const CacheKey& key) {
+	CacheKey internedKey = key;
+	internedKey.className = m_arena.intern(key.className);
+	internedKey.memberName = m_arena.intern(key.memberName);
+	internedKey.paramSignature = m_arena.intern(key.paramSignature);
+
+	return internedKey;
+}
+
+CacheEntry& IdCache::insertClass(const CacheKey& key, GlobalRef&& classRef) {
+	std::scoped_lock lock(m_insertMutex);
+
+	if (auto existing = m_tables.back()->find(key)) {
+		return *existing;
+	}
+
+	return emplace<ClassEntry>(internKey(key), std::move(classRef));
+}
+
+CacheEntry& IdCache::insertMethod(const CacheKey& key, GlobalRef& classRef, jmethodID methodId) {
+	std::scoped_lock lock(m_insertMutex);
+
+	if (auto existing = m_tables.back()->find(key)) {
+		return *existing;
+	}
+
+	return emplace<MethodEntry>(internKey(key), classRef, methodId);
+}
+
+CacheEntry& IdCache::insertField(const CacheKey& key, GlobalRef& classRef, jfieldID fieldId) {
+	std::scoped_lock lock(m_insertMutex);
+
+	if (auto existing = m_tables.back()->find(key)) {
+		return *existing;
+	}
+
+	return emplace<FieldEntry>(internKey(key), classRef, fieldId);
+}
+
+CacheEntry& IdCache::insertMissing(const CacheKey& key, std::string_view error) {
+	std::scoped_lock lock(m_insertMutex);
+
+	if (auto existing = m_tables.back()->find(key)) {
+		return *existing;
+	}
+
+	auto internedKey = internKey(key);
+	auto internedError = m_arena.intern(error);
+
+	if (key.kind == EntryKind::StaticMethod || key.kind == EntryKind::Method) {
+		return emplace<MethodEntry>(internedKey, m_missingClass, nullptr, internedError);
+	}
+
+	return emplace<CacheEntry>(internedKey, internedError);
+}
+
+void IdCache::reset() {
+	std::scoped_lock lock(m_insertMutex);
+
+	m_table.store(m_tables.emplace_back(std::make_unique<Table>(64)).get(), std::memory_order_release);
+	m_size = 0;
+}
+
+launcher_utils::jni::CacheStats IdCache::stats() const {
+	std::scoped_lock lock(m_insertMutex);
+
+	auto& table = *m_tables.back();
+	auto capacity = table.mask + 1;
+
+	CacheStats stats{};
+	stats.entries = m_size;
+	stats.capacity = capacity;
+	stats.tableBytes = capacity * sizeof(std::atomic<CacheEntry*>);
+	stats.arenaReservedBytes = m_arena.reservedBytes();
+	stats.arenaUsedBytes = m_arena.usedBytes();
+
+	for (std::size_t i = 0; i + 1 < m_tables.size(); i++) {
+		stats.retiredTableBytes += (m_tables[i]->mask + 1) * sizeof(std::atomic<CacheEntry*>);
+	}
+
+	std::size_t totalProbes = 0;
+
+	for (std::size_t i = 0; i < capacity; i++) {
+		if (auto entry = table.slots[i].load(std::memory_order_relaxed)) {
+			auto probes = ((i - (entry->key.hash & table.mask)) & table.mask) + 1;
+			totalProbes += probes;
+			stats.maxProbeLength = std::max(stats.maxProbeLength, probes);
+		}
+	}
+
+	if (m_size > 0) {
+		stats.averageProbeLength = static_cast<double>(totalProbes) / m_size;
+	}
+
+	return stats;
+}
+
+IdCache& launcher_utils::jni::detail::getIdCache() {
+	static IdCache s_cache{};
+	return s_cache;
+}
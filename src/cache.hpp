@@ -0,0 +1,227 @@
+#pragma once
+
+#include <launcher-utils/jni.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace launcher_utils::jni::detail {
+	/**
+	 * A single cached class, method or field. Entries are allocated with a payload matching their kind:
+	 * a ClassEntry, MethodEntry or FieldEntry, or no payload at all for a missing class or field.
+	 * Missing methods keep a MethodEntry, so call-site handles can hold on to the miss like any other method.
+	 */
+	struct CacheEntry {
+		CacheKey key;
+
+		/**
+		 * Error of a class or member that doesn't exist. Misses are cached too, so they are only looked up once.
+		 */
+		std::string_view missing{};
+
+		explicit CacheEntry(const CacheKey& key, std::string_view missing = {}) : key(key), missing(missing) {}
+
+		/**
+		 * Only valid for a class that was found.
+		 */
+		GlobalRef& classRef();
+
+		/**
+		 * Valid for every method entry, including missing ones.
+		 */
+		MethodInfo& methodInfo();
+
+		/**
+		 * Only valid for a field that was found.
+		 */
+		FieldInfo& fieldInfo();
+	};
+
+	/**
+	 * Class entries own the class reference, member entries refer to the reference of their class entry.
+	 */
+	struct ClassEntry : CacheEntry {
+		GlobalRef ref;
+
+		ClassEntry(const CacheKey& key, GlobalRef&& ref) : CacheEntry(key), ref(std::move(ref)) {}
+	};
+
+	struct MethodEntry : CacheEntry {
+		MethodInfo info;
+
+		MethodEntry(const CacheKey& key, GlobalRef& classRef, jmethodID methodId, std::string_view missing = {})
+			: CacheEntry(key, missing),
+			  info(classRef, methodId, this->key.className, this->key.memberName, this->key.paramSignature, missing) {}
+	};
+
+	struct FieldEntry : CacheEntry {
+		FieldInfo info;
+
+		FieldEntry(const CacheKey& key, GlobalRef& classRef, jfieldID fieldId)
+			: CacheEntry(key), info(classRef, fieldId, key.kind == EntryKind::StaticField) {}
+	};
+
+	inline GlobalRef& CacheEntry::classRef() {
+		return static_cast<ClassEntry*>(this)->ref;
+	}
+
+	inline MethodInfo& CacheEntry::methodInfo() {
+		return static_cast<MethodEntry*>(this)->info;
+	}
+
+	inline FieldInfo& CacheEntry::fieldInfo() {
+		return static_cast<FieldEntry*>(this)->info;
+	}
+
+	/**
+	 * Hit and miss counts of cache lookups. Does nothing unless built with LAUNCHER_UTILS_INSTRUMENTATION.
+	 */
+	struct LookupCounter {
+#ifdef LAUNCHER_UTILS_INSTRUMENTATION
+		std::atomic_uint64_t hits{0};
+		std::atomic_uint64_t misses{0};
+
+		void hit() {
+			hits.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		void miss() {
+			misses.fetch_add(1, std::memory_order_relaxed);
+		}
+#else
+		void hit() {}
+		void miss() {}
+#endif
+	};
+
+	inline LookupCounter s_classLookups{};
+	inline LookupCounter s_methodLookups{};
+	inline LookupCounter s_fieldLookups{};
+
+	/**
+	 * Bump allocator for key strings and entries. Memory is only released with the arena.
+	 */
+	class Arena final {
+		static constexpr std::size_t s_chunkSize = 4096;
+
+		std::vector<std::unique_ptr<std::byte[]>> m_chunks{};
+		std::size_t m_chunkUsed{s_chunkSize};
+		std::size_t m_reserved{0};
+		std::size_t m_used{0};
+
+	public:
+		void* allocate(std::size_t size, std::size_t align);
+
+		/**
+		 * Copies a string into the arena. The copy is null terminated.
+		 */
+		std::string_view intern(std::string_view str);
+
+		std::size_t reservedBytes() const {
+			return m_reserved;
+		}
+
+		std::size_t usedBytes() const {
+			return m_used;
+		}
+	};
+
+	/**
+	 * Open-addressing (linear probing) table holding every cached class and method.
+	 * Entries are never removed, so references to them stay valid.
+	 *
+	 * Lookups are lock-free: readers only ever see fully constructed entries, and a table that is
+	 * replaced while growing is retired rather than freed, so a concurrent reader can finish its probe.
+	 * Inserts are serialized by a mutex.
+	 */
+	class IdCache final {
+		struct Table {
+			std::size_t mask;
+			std::unique_ptr<std::atomic<CacheEntry*>[]> slots;
+
+			explicit Table(std::size_t capacity);
+
+			CacheEntry* find(const CacheKey& key) const;
+			void place(CacheEntry* entry);
+		};
+
+		std::atomic<Table*> m_table{};
+		std::vector<std::unique_ptr<Table>> m_tables{};
+		std::size_t m_size{0};
+		Arena m_arena{};
+		mutable std::mutex m_insertMutex{};
+
+		/**
+		 * Class of missing methods, which stays null.
+		 */
+		GlobalRef m_missingClass{};
+
+		Table& tableForInsert();
+		CacheEntry& publish(CacheEntry* entry);
+		CacheKey internKey(const CacheKey& key);
+
+		template <typename T, typename... Args>
+		CacheEntry& emplace(Args&&... args) {
+			return publish(new (m_arena.allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...));
+		}
+
+	public:
+		IdCache();
+
+		CacheEntry* find(const CacheKey& key) const {
+			return m_table.load(std::memory_order_acquire)->find(key);
+		}
+
+		/**
+		 * Inserts a class entry. If another thread inserted the same key first, that entry is returned instead
+		 * and the given reference is left untouched.
+		 */
+		CacheEntry& insertClass(const CacheKey& key, GlobalRef&& classRef);
+
+		/**
+		 * Inserts a method entry. If another thread inserted the same key first, that entry is returned instead.
+		 */
+		CacheEntry& insertMethod(const CacheKey& key, GlobalRef& classRef, jmethodID methodId);
+
+		/**
+		 * Inserts a field entry. If another thread inserted the same key first, that entry is returned instead.
+		 */
+		CacheEntry& insertField(const CacheKey& key, GlobalRef& classRef, jfieldID fieldId);
+
+		/**
+		 * Inserts an entry for a class or member that doesn't exist, with the error to return for it.
+		 * If another thread inserted the same key first, that entry is returned instead.
+		 */
+		CacheEntry& insertMissing(const CacheKey& key, std::string_view error);
+
+		CacheStats stats() const;
+
+		/**
+		 * Calls the callback with every entry in the table, while holding the insert lock.
+		 */
+		template <typename F>
+		void forEach(F&& callback) const {
+			std::scoped_lock lock(m_insertMutex);
+
+			auto& table = *m_tables.back();
+			for (std::size_t i = 0; i <= table.mask; i++) {
+				if (auto entry = table.slots[i].load(std::memory_order_relaxed)) {
+					callback(*entry);
+				}
+			}
+		}
+
+		/**
+		 * Empties the table. Existing entries stay allocated, so references to them remain valid.
+		 */
+		void reset();
+	};
+
+	IdCache& getIdCache();
+}
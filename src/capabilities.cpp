@@ -0,0 +1,77 @@
+#include <launcher-utils/capabilities.hpp>
+
+#include <Geode/loader/Loader.hpp>
+
+#include <mutex>
+#include <thread>
+
+#include "launcher.hpp"
+
+using namespace launcher_utils;
+
+namespace {
+	std::mutex s_probeMutex{};
+
+	// static initializers run on the main thread as the mod is loaded
+	const auto s_mainThread = std::this_thread::get_id();
+
+	// probed from the main thread once the mod has loaded, so the first query from another thread finds it done
+	const auto s_loadProbe = (geode::Loader::get()->queueInMainThread([] {
+		(void)detail::probeCapabilities(false);
+	}), true);
+
+	/**
+	 * Whether a failed probe on this thread means the launcher really is unavailable. Other threads (and threads
+	 * attached by getEnv) may just be unable to see the launcher's classes, so their failures aren't kept.
+	 */
+	bool canCacheFailure() {
+		return std::this_thread::get_id() == s_mainThread && !jni::detail::isAttachedThread();
+	}
+
+	geode::Result<std::uint32_t> probeMethods() {
+		GEODE_UNWRAP_INTO(auto env, jni::getEnv());
+
+		// without the class, nothing could be probed (or this thread can't see it), so nothing is recorded
+		GEODE_UNWRAP(jni::getClassId(env, detail::s_utilsClass));
+
+		auto supported = (std::uint32_t{1} << static_cast<std::uint32_t>(Capability::Count)) - 1;
+
+		for (const auto& method : detail::s_launcherMethods) {
+			if (!jni::getStaticMethodInfo(env, detail::s_utilsClass, method.name, method.signature.data())) {
+				supported &= ~(std::uint32_t{1} << static_cast<std::uint32_t>(method.capability));
+			}
+		}
+
+		return geode::Ok(supported);
+	}
+}
+
+std::uint64_t launcher_utils::detail::probeCapabilities(bool retryFailed) {
+	std::scoped_lock lock(s_probeMutex);
+
+	auto epoch = jni::detail::s_cacheEpoch.load(std::memory_order_relaxed);
+
+	auto state = s_capabilities.load(std::memory_order_acquire);
+	if ((state >> 32) == epoch) {
+		if ((state & s_capabilitiesProbed) || ((state & s_capabilitiesUnavailable) && !retryFailed)) {
+			return state;
+		}
+	}
+
+	auto supported = probeMethods();
+
+	auto probed = (std::uint64_t{epoch} << 32) | (supported ? s_capabilitiesProbed | supported.unwrap() : s_capabilitiesUnavailable);
+	if (supported || canCacheFailure()) {
+		s_capabilities.store(probed, std::memory_order_release);
+	}
+
+	return probed;
+}
+
+geode::Result<> launcher_utils::probeCapabilities() {
+	if (!(detail::probeCapabilities(true) & detail::s_capabilitiesProbed)) {
+		return geode::Err("probeCapabilities: launcher classes are unavailable on this thread");
+	}
+
+	return geode::Ok();
+}
@@ -0,0 +1,169 @@
+#include <launcher-utils/devices.hpp>
+
+#include <Geode/loader/Loader.hpp>
+#include <Geode/utils/AndroidEvent.hpp>
+
+#include <algorithm>
+
+using namespace launcher_utils;
+
+namespace {
+	auto findDevice(std::vector<InputDevice>& devices, int deviceId) {
+		return std::lower_bound(devices.begin(), devices.end(), deviceId, [](const InputDevice& device, int id) {
+			return device.getDeviceId() < id;
+		});
+	}
+
+	bool isController(InputDevice& device) {
+		auto sources = device.snapshot().sources;
+
+		return (sources & InputDevice::Source::Joystick) == InputDevice::Source::Joystick
+			|| (sources & InputDevice::Source::Gamepad) == InputDevice::Source::Gamepad;
+	}
+
+	void listenForDeviceEvents() {
+		static geode::EventListener<geode::AndroidInputDeviceFilter> s_listener{
+			[](geode::AndroidInputDeviceEvent* event) {
+				auto deviceId = event->deviceId();
+				auto status = event->status();
+
+				geode::Loader::get()->queueInMainThread([deviceId, status] {
+					auto& registry = DeviceRegistry::get();
+
+					if (status == geode::AndroidInputDeviceEvent::Status::Removed) {
+						registry.remove(deviceId);
+					} else {
+						(void)registry.update(deviceId);
+					}
+				});
+
+				return geode::ListenerResult::Propagate;
+			},
+			geode::AndroidInputDeviceFilter()
+		};
+	}
+}
+
+DeviceRegistry& DeviceRegistry::get() {
+	static DeviceRegistry s_registry{};
+	return s_registry;
+}
+
+void DeviceRegistry::ensureSeeded() {
+	if (m_seeded) {
+		return;
+	}
+
+	// listen before fetching, so that no change can fall between the two
+	listenForDeviceEvents();
+
+	auto envRes = jni::getEnv();
+	if (!envRes) {
+		return;
+	}
+
+	auto env = envRes.unwrap();
+
+	std::vector<int> ids{};
+	if (!getConnectedDevices(ids)) {
+		return;
+	}
+
+	std::vector<InputDevice> devices{};
+	devices.reserve(ids.size());
+
+	{
+		// local references made while fetching the devices are released together with the frame
+		auto frame = jni::LocalFrame::push(env, 16);
+		if (!frame) {
+			return;
+		}
+
+		for (auto id : ids) {
+			if (auto device = InputDevice::create(id)) {
+				devices.push_back(std::move(device).unwrap());
+				(void)devices.back().snapshot();
+			}
+		}
+	}
+
+	std::ranges::sort(devices, {}, &InputDevice::getDeviceId);
+
+	m_devices = std::move(devices);
+	m_seeded = true;
+	m_version++;
+}
+
+void DeviceRegistry::insert(InputDevice&& device) {
+	auto it = findDevice(m_devices, device.getDeviceId());
+
+	if (it != m_devices.end() && it->getDeviceId() == device.getDeviceId()) {
+		*it = std::move(device);
+	} else {
+		m_devices.insert(it, std::move(device));
+	}
+
+	m_version++;
+}
+
+std::span<InputDevice> DeviceRegistry::devices() {
+	ensureSeeded();
+	return m_devices;
+}
+
+InputDevice* DeviceRegistry::find(int deviceId) {
+	ensureSeeded();
+
+	auto it = findDevice(m_devices, deviceId);
+	if (it == m_devices.end() || it->getDeviceId() != deviceId) {
+		return nullptr;
+	}
+
+	return &*it;
+}
+
+std::size_t DeviceRegistry::size() {
+	ensureSeeded();
+	return m_devices.size();
+}
+
+std::size_t DeviceRegistry::controllerCount() {
+	ensureSeeded();
+	return std::ranges::count_if(m_devices, isController);
+}
+
+geode::Result<> DeviceRegistry::update(int deviceId) {
+	// the seed fetches the current state of every device anyways
+	if (!m_seeded) {
+		return geode::Ok();
+	}
+
+	auto device = InputDevice::create(deviceId);
+	if (!device) {
+		remove(deviceId);
+		return geode::Err(device.unwrapErr());
+	}
+
+	// an InputDevice object never changes, so a changed device is replaced with the new one
+	auto& inserted = device.unwrap();
+	(void)inserted.snapshot();
+	insert(std::move(inserted));
+
+	return geode::Ok();
+}
+
+void DeviceRegistry::remove(int deviceId) {
+	auto it = findDevice(m_devices, deviceId);
+	if (it == m_devices.end() || it->getDeviceId() != deviceId) {
+		return;
+	}
+
+	m_devices.erase(it);
+	m_version++;
+}
+
+void DeviceRegistry::clear() {
+	m_devices.clear();
+	m_seeded = false;
+	m_version++;
+}
@@ -0,0 +1,201 @@
+#include <launcher-utils/executor.hpp>
+
+#include <pthread.h>
+
+using namespace launcher_utils;
+
+namespace {
+	template <typename T>
+	void updateMax(std::atomic<T>& max, T value) {
+		auto current = max.load(std::memory_order_relaxed);
+		while (value > current && !max.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+	}
+
+	std::uint64_t nanosecondsBetween(std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end) {
+		return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+	}
+}
+
+void jni::detail::TaskQueue::push(Task* task) {
+	task->next.store(nullptr, std::memory_order_relaxed);
+
+	auto previous = m_head.exchange(task, std::memory_order_acq_rel);
+	previous->next.store(task, std::memory_order_release);
+}
+
+jni::detail::Task* jni::detail::TaskQueue::pop() {
+	auto tail = m_tail;
+	auto next = tail->next.load(std::memory_order_acquire);
+
+	// the stub marks an empty queue, step over it
+	if (tail == &m_stub) {
+		if (next == nullptr) {
+			return nullptr;
+		}
+
+		m_tail = next;
+		tail = next;
+		next = next->next.load(std::memory_order_acquire);
+	}
+
+	if (next != nullptr) {
+		m_tail = next;
+		return tail;
+	}
+
+	// a producer has swapped the head, but not linked its task yet
+	if (tail != m_head.load(std::memory_order_acquire)) {
+		return nullptr;
+	}
+
+	// tail is the last task, push the stub behind it so it can be unlinked
+	push(&m_stub);
+
+	next = tail->next.load(std::memory_order_acquire);
+	if (next != nullptr) {
+		m_tail = next;
+		return tail;
+	}
+
+	return nullptr;
+}
+
+jni::Executor& jni::Executor::get() {
+	static auto s_executor = new Executor();
+	return *s_executor;
+}
+
+void jni::Executor::push(detail::Task* task) {
+	task->submitted = std::chrono::steady_clock::now();
+
+	m_submitted.fetch_add(1, std::memory_order_relaxed);
+	auto depth = m_depth.fetch_add(1, std::memory_order_seq_cst) + 1;
+	updateMax(m_maxDepth, depth);
+
+	m_queue.push(task);
+
+	if (!m_running.load(std::memory_order_acquire)) {
+		start();
+	}
+
+	// the worker sets m_sleeping before checking m_depth, so either it sees this task or this sees it sleeping
+	if (m_sleeping.load(std::memory_order_seq_cst)) {
+		std::scoped_lock lock(m_mutex);
+		m_wake.notify_one();
+	}
+}
+
+void jni::Executor::start() {
+	std::scoped_lock lock(m_mutex);
+
+	if (m_running.load(std::memory_order_relaxed)) {
+		return;
+	}
+
+	m_stopping = false;
+	m_thread = std::thread([this] {
+		pthread_setname_np(pthread_self(), "launcher-jni");
+		run();
+	});
+
+	m_running.store(true, std::memory_order_release);
+}
+
+void jni::Executor::run() {
+	while (true) {
+		auto task = m_queue.pop();
+
+		if (task == nullptr) {
+			if (m_depth.load(std::memory_order_seq_cst) > 0) {
+				// a task is being pushed, it will be linked in momentarily
+				std::this_thread::yield();
+				continue;
+			}
+
+			std::unique_lock lock(m_mutex);
+			m_sleeping.store(true, std::memory_order_seq_cst);
+
+			m_wake.wait(lock, [this] {
+				return m_depth.load(std::memory_order_seq_cst) > 0 || m_stopping;
+			});
+
+			m_sleeping.store(false, std::memory_order_relaxed);
+
+			if (m_stopping && m_depth.load(std::memory_order_seq_cst) == 0) {
+				return;
+			}
+
+			continue;
+		}
+
+		m_depth.fetch_sub(1, std::memory_order_relaxed);
+
+		auto begin = std::chrono::steady_clock::now();
+		auto wait = nanosecondsBetween(task->submitted, begin);
+
+		// getEnv's cached environment keeps this cheap after the first task
+		auto env = detail::attachCurrentThread();
+		task->run(env);
+		task->destroy();
+
+		auto runTime = nanosecondsBetween(begin, std::chrono::steady_clock::now());
+
+		m_totalWait.fetch_add(wait, std::memory_order_relaxed);
+		updateMax(m_maxWait, wait);
+		m_totalRun.fetch_add(runTime, std::memory_order_relaxed);
+		updateMax(m_maxRun, runTime);
+
+		m_completed.fetch_add(1, std::memory_order_release);
+	}
+}
+
+void jni::Executor::drain() {
+	if (!m_running.load(std::memory_order_acquire)) {
+		return;
+	}
+
+	// tasks run in order, so once this one has run, so has everything before it
+	submit([](JNIEnv*) -> geode::Result<> {
+		return geode::Ok();
+	}).wait();
+}
+
+void jni::Executor::shutdown() {
+	{
+		std::scoped_lock lock(m_mutex);
+		if (!m_running.load(std::memory_order_relaxed)) {
+			return;
+		}
+
+		m_stopping = true;
+		m_wake.notify_one();
+	}
+
+	m_thread.join();
+	m_running.store(false, std::memory_order_release);
+}
+
+jni::ExecutorStats jni::Executor::stats() const {
+	ExecutorStats stats{};
+
+	stats.submitted = m_submitted.load(std::memory_order_relaxed);
+	stats.completed = m_completed.load(std::memory_order_relaxed);
+	stats.queueDepth = m_depth.load(std::memory_order_relaxed);
+	stats.maxQueueDepth = m_maxDepth.load(std::memory_order_relaxed);
+	stats.totalWaitNanoseconds = m_totalWait.load(std::memory_order_relaxed);
+	stats.maxWaitNanoseconds = m_maxWait.load(std::memory_order_relaxed);
+	stats.totalRunNanoseconds = m_totalRun.load(std::memory_order_relaxed);
+	stats.maxRunNanoseconds = m_maxRun.load(std::memory_order_relaxed);
+
+	return stats;
+}
+
+void jni::Executor::resetStats() {
+	m_submitted.store(0, std::memory_order_relaxed);
+	m_completed.store(0, std::memory_order_relaxed);
+	m_maxDepth.store(m_depth.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	m_totalWait.store(0, std::memory_order_relaxed);
+	m_maxWait.store(0, std::memory_order_relaxed);
+	m_totalRun.store(0, std::memory_order_relaxed);
+	m_maxRun.store(0, std::memory_order_relaxed);
+}
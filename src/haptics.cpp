@@ -0,0 +1,395 @@
+#include <launcher-utils/haptics.hpp>
+#include <launcher-utils/executor.hpp>
+
+#include <Geode/loader/Loader.hpp>
+
+#include <algorithm>
+
+using namespace launcher_utils;
+
+namespace {
+	std::int64_t roundUpMilliseconds(std::chrono::steady_clock::duration duration) {
+		return std::chrono::ceil<std::chrono::milliseconds>(duration).count();
+	}
+}
+
+HapticsScheduler& HapticsScheduler::get() {
+	static HapticsScheduler s_scheduler{};
+	return s_scheduler;
+}
+
+HapticsScheduler::Channel& HapticsScheduler::findChannel(int deviceId, int motorIdx) {
+	auto it = std::find_if(m_channels.begin(), m_channels.end(), [deviceId, motorIdx](const Channel& channel) {
+		return channel.deviceId == deviceId && channel.motorIdx == motorIdx;
+	});
+
+	if (it != m_channels.end()) {
+		return *it;
+	}
+
+	return m_channels.emplace_back(Channel{deviceId, motorIdx});
+}
+
+int HapticsScheduler::lookupMotorCount(int deviceId) {
+	auto generation = detail::getDeviceGeneration(deviceId);
+
+	{
+		std::scoped_lock lock(m_mutex);
+
+		auto it = std::ranges::find(m_motorCounts, deviceId, &MotorCount::deviceId);
+		if (it != m_motorCounts.end() && it->generation == generation) {
+			return it->count;
+		}
+	}
+
+	if (detail::lacksCapability(Capability::DeviceVibration)) {
+		return 0;
+	}
+
+	auto res = jni::invokeStaticMethod<jint(jint), "com/geode/launcher/utils/GeodeUtils", "getDeviceHapticsCount">(deviceId);
+	if (!res) {
+		return 0;
+	}
+
+	std::scoped_lock lock(m_mutex);
+
+	auto it = std::ranges::find(m_motorCounts, deviceId, &MotorCount::deviceId);
+	if (it != m_motorCounts.end()) {
+		*it = MotorCount{deviceId, generation, res.unwrap()};
+	} else {
+		m_motorCounts.push_back(MotorCount{deviceId, generation, res.unwrap()});
+	}
+
+	return res.unwrap();
+}
+
+void HapticsScheduler::request(int deviceId, int motorIdx, std::int64_t durationMs, int intensity, std::int64_t delayMs) {
+	auto now = Clock::now();
+
+	// looked up before taking the lock, so that merging the channels in flush never calls into Java under it
+	auto motorCount = deviceId != s_phone && motorIdx == -1 ? lookupMotorCount(deviceId) : 0;
+
+	{
+		std::scoped_lock lock(m_mutex);
+		m_stats.requests++;
+
+		auto sequence = ++m_sequence;
+
+		auto& channel = findChannel(deviceId, motorIdx);
+		channel.motorCount = std::max(channel.motorCount, motorCount);
+		if (durationMs <= 0 || intensity <= 0) {
+			// anything requested before the cancel would be cut off by it
+			channel.pending.clear();
+			channel.cancel = true;
+			channel.cancelSequence = sequence;
+		} else {
+			auto start = now + std::chrono::milliseconds(std::max<std::int64_t>(delayMs, 0));
+			channel.pending.push_back(Pulse{start, start + std::chrono::milliseconds(durationMs), intensity, sequence});
+		}
+
+		if (m_flushQueued) {
+			return;
+		}
+
+		m_flushQueued = true;
+	}
+
+	queueFlush();
+}
+
+void HapticsScheduler::queueFlush() {
+	geode::Loader::get()->queueInMainThread([] {
+		HapticsScheduler::get().flush();
+	});
+}
+
+void HapticsScheduler::mergeMotorChannels() {
+	for (std::size_t i = 0; i < m_channels.size();) {
+		auto deviceId = m_channels[i].deviceId;
+		if (deviceId == s_phone || m_channels[i].motorIdx != -1) {
+			i++;
+			continue;
+		}
+
+		std::vector<int> motors{};
+		for (const auto& channel : m_channels) {
+			if (channel.deviceId == deviceId && channel.motorIdx >= 0) {
+				motors.push_back(channel.motorIdx);
+			}
+		}
+
+		if (motors.empty()) {
+			i++;
+			continue;
+		}
+
+		// motors without requests of their own still have to keep the all-motors vibration
+		for (int motorIdx = 0; motorIdx < m_channels[i].motorCount; motorIdx++) {
+			if (std::ranges::find(motors, motorIdx) == motors.end()) {
+				motors.push_back(motorIdx);
+			}
+		}
+
+		auto all = std::move(m_channels[i]);
+		m_channels.erase(m_channels.begin() + i);
+
+		for (auto motorIdx : motors) {
+			auto& channel = findChannel(deviceId, motorIdx);
+
+			if (all.cancel) {
+				std::erase_if(channel.pending, [&all](const Pulse& pulse) {
+					return pulse.sequence < all.cancelSequence;
+				});
+
+				channel.cancelSequence = channel.cancel ? std::max(channel.cancelSequence, all.cancelSequence) : all.cancelSequence;
+				channel.cancel = true;
+			} else if (!channel.cancel) {
+				channel.playing.insert(channel.playing.end(), all.playing.begin(), all.playing.end());
+			}
+
+			for (const auto& pulse : all.pending) {
+				if (!channel.cancel || pulse.sequence > channel.cancelSequence) {
+					channel.pending.push_back(pulse);
+				}
+			}
+		}
+	}
+}
+
+void HapticsScheduler::vibrate(std::int64_t durationMs, std::int64_t delayMs) {
+	request(s_phone, -1, durationMs, 255, delayMs);
+}
+
+void HapticsScheduler::vibrateDevice(int deviceId, std::int64_t durationMs, int intensity, int motorIdx, std::int64_t delayMs) {
+	request(deviceId, motorIdx, durationMs, intensity, delayMs);
+}
+
+void HapticsScheduler::setMaxCallRate(double callsPerSecond) {
+	std::scoped_lock lock(m_mutex);
+
+	if (callsPerSecond <= 0.0) {
+		m_minInterval = Clock::duration::zero();
+		return;
+	}
+
+	m_minInterval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / callsPerSecond));
+}
+
+bool HapticsScheduler::compile(Channel& channel, Clock::time_point now, std::vector<Call>& calls) {
+	auto pulses = std::exchange(channel.pending, {});
+
+	// requests held back by the rate limit are delayed rather than shortened
+	for (auto& pulse : pulses) {
+		if (pulse.start < now) {
+			pulse.end += now - pulse.start;
+			pulse.start = now;
+		}
+	}
+
+	// the next call replaces whatever is still playing, so the rest of it has to be part of that call
+	if (!channel.cancel) {
+		for (auto pulse : channel.playing) {
+			if (pulse.end > now) {
+				pulse.start = std::max(pulse.start, now);
+				pulses.push_back(pulse);
+			}
+		}
+	}
+
+	channel.playing.clear();
+
+	if (pulses.empty()) {
+		// the phone's vibrator has no way to stop, so its requests are only dropped
+		if (channel.cancel && channel.deviceId != s_phone) {
+			calls.push_back(Call{channel.deviceId, channel.motorIdx, 0, 0});
+		}
+
+		channel.cancel = false;
+		return false;
+	}
+
+	channel.cancel = false;
+
+	std::ranges::sort(pulses, {}, &Pulse::start);
+
+	std::vector<Pulse> segments{};
+	for (const auto& pulse : pulses) {
+		if (!segments.empty() && pulse.start <= segments.back().end) {
+			auto& segment = segments.back();
+			segment.end = std::max(segment.end, pulse.end);
+			segment.intensity = std::max(segment.intensity, pulse.intensity);
+		} else {
+			segments.push_back(pulse);
+		}
+	}
+
+	if (channel.deviceId == s_phone) {
+		Call call{s_phone, -1, 0, 0};
+
+		if (segments.size() == 1 && segments.front().start == now) {
+			call.durationMs = roundUpMilliseconds(segments.front().end - now);
+		} else {
+			auto cursor = now;
+			for (const auto& segment : segments) {
+				call.pattern.push_back(roundUpMilliseconds(segment.start - cursor));
+				call.pattern.push_back(roundUpMilliseconds(segment.end - segment.start));
+				cursor = segment.end;
+			}
+		}
+
+		calls.push_back(std::move(call));
+		channel.playing = std::move(segments);
+
+		return false;
+	}
+
+	// vibrateDevice has no pattern, so every segment after the first gets its own call once it is due
+	auto& first = segments.front();
+	if (first.start > now) {
+		channel.pending = std::move(segments);
+		return true;
+	}
+
+	calls.push_back(Call{channel.deviceId, channel.motorIdx, first.intensity, roundUpMilliseconds(first.end - first.start)});
+
+	channel.playing.assign(segments.begin(), segments.begin() + 1);
+	channel.pending.assign(segments.begin() + 1, segments.end());
+
+	return !channel.pending.empty();
+}
+
+void HapticsScheduler::send(std::vector<Call>&& calls) {
+	if (calls.empty()) {
+		return;
+	}
+
+	detail::prepareAsyncCall();
+
+	jni::Executor::get().enqueue([this, calls = std::move(calls)](geode::Result<JNIEnv*>& env) {
+		for (const auto& call : calls) {
+			geode::Result<> r = geode::Ok();
+
+			if (!env) {
+				r = geode::Err(env.unwrapErr());
+			} else if (call.deviceId != s_phone) {
+				r = InputDevice::performVibrateDevice(env.unwrap(), call.deviceId, call.durationMs, call.intensity, call.motorIdx);
+			} else if (!call.pattern.empty()) {
+				auto pattern = call.pattern;
+				r = vibratePattern(pattern, -1);
+			} else {
+				r = launcher_utils::vibrate(call.durationMs);
+			}
+
+			if (!r) {
+				m_failedCalls.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+	});
+}
+
+void HapticsScheduler::flush() {
+	flush(Clock::now());
+}
+
+void HapticsScheduler::flush(Clock::time_point now) {
+	std::vector<Call> calls{};
+	bool queueNext = false;
+
+	{
+		std::scoped_lock lock(m_mutex);
+		m_flushQueued = false;
+
+		mergeMotorChannels();
+
+		// decided up front, so that every motor of a device can be sent in the same flush
+		auto mayCall = [&](int deviceId) {
+			auto it = std::find_if(m_lastCalls.begin(), m_lastCalls.end(), [deviceId](const auto& x) {
+				return x.first == deviceId;
+			});
+
+			return it == m_lastCalls.end() || now - it->second >= m_minInterval;
+		};
+
+		std::vector<int> calledDevices{};
+
+		for (auto& channel : m_channels) {
+			if (channel.pending.empty() && !channel.cancel) {
+				continue;
+			}
+
+			if (!mayCall(channel.deviceId)) {
+				m_stats.rateLimited++;
+				queueNext = true;
+				continue;
+			}
+
+			auto callCount = calls.size();
+			if (compile(channel, now, calls)) {
+				queueNext = true;
+			}
+
+			if (calls.size() != callCount) {
+				calledDevices.push_back(channel.deviceId);
+			}
+		}
+
+		for (auto deviceId : calledDevices) {
+			auto it = std::find_if(m_lastCalls.begin(), m_lastCalls.end(), [deviceId](const auto& x) {
+				return x.first == deviceId;
+			});
+
+			if (it != m_lastCalls.end()) {
+				it->second = now;
+			} else {
+				m_lastCalls.emplace_back(deviceId, now);
+			}
+		}
+
+		m_stats.calls += calls.size();
+
+		// held back requests are looked at again next frame
+		if (queueNext && !m_flushQueued) {
+			m_flushQueued = true;
+		} else {
+			queueNext = false;
+		}
+	}
+
+	if (queueNext) {
+		queueFlush();
+	}
+
+	send(std::move(calls));
+}
+
+void HapticsScheduler::forget(int deviceId) {
+	std::scoped_lock lock(m_mutex);
+
+	std::erase_if(m_channels, [deviceId](const Channel& channel) {
+		return channel.deviceId == deviceId;
+	});
+
+	std::erase_if(m_lastCalls, [deviceId](const auto& x) {
+		return x.first == deviceId;
+	});
+
+	std::erase_if(m_motorCounts, [deviceId](const MotorCount& x) {
+		return x.deviceId == deviceId;
+	});
+}
+
+HapticsStats HapticsScheduler::stats() const {
+	std::scoped_lock lock(m_mutex);
+
+	auto stats = m_stats;
+	stats.failedCalls = m_failedCalls.load(std::memory_order_relaxed);
+
+	return stats;
+}
+
+void HapticsScheduler::resetStats() {
+	std::scoped_lock lock(m_mutex);
+
+	m_stats = HapticsStats{};
+	m_failedCalls.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <launcher-utils/capabilities.hpp>
+
+#include <array>
+#include <string_view>
+#include <vector>
+
+namespace launcher_utils::detail {
+	inline constexpr auto s_utilsClass = "com/geode/launcher/utils/GeodeUtils";
+
+	struct LauncherMethod {
+		Capability capability;
+		const char* name;
+		std::string_view signature;
+	};
+
+	/**
+	 * Every launcher method used by the wrappers in geode.hpp.
+	 * Signatures are written like their call sites, so resolving them fills the same cache entries.
+	 */
+	inline constexpr std::array s_launcherMethods{
+		LauncherMethod{Capability::Vibrate, "vibrateSupported", jni::signatureOf<bool()>},
+		LauncherMethod{Capability::Vibrate, "vibrate", jni::signatureOf<void(jlong)>},
+		LauncherMethod{Capability::VibratePattern, "vibratePattern", jni::signatureOf<void(std::vector<jlong>, jint)>},
+		LauncherMethod{Capability::ConnectedDevices, "getConnectedDevices", jni::signatureOf<std::vector<jint>()>},
+		LauncherMethod{Capability::ConnectedDevices, "getDevice", jni::signatureOf<jni::Object<"android/view/InputDevice">(jint)>},
+		LauncherMethod{Capability::ControllerCount, "controllersConnected", jni::signatureOf<jint()>},
+		LauncherMethod{Capability::DeviceBattery, "deviceHasBattery", jni::signatureOf<bool(jint)>},
+		LauncherMethod{Capability::DeviceBattery, "getDeviceBatteryCapacity", jni::signatureOf<jfloat(jint)>},
+		LauncherMethod{Capability::DeviceBattery, "getDeviceBatteryStatus", jni::signatureOf<jint(jint)>},
+		LauncherMethod{Capability::DeviceLights, "getDeviceLightsCount", jni::signatureOf<jint(jint)>},
+		LauncherMethod{Capability::DeviceLights, "getLightType", jni::signatureOf<jint(jint)>},
+		LauncherMethod{Capability::DeviceLights, "setDeviceLightColor", jni::signatureOf<bool(jint, jint, jint)>},
+		LauncherMethod{Capability::DeviceVibration, "getDeviceHapticsCount", jni::signatureOf<jint(jint)>},
+		LauncherMethod{Capability::DeviceVibration, "vibrateDevice", jni::signatureOf<bool(jint, jlong, jint, jint)>},
+	};
+}
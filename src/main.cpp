@@ -1,187 +1,806 @@
 #include <launcher-utils/jni.hpp>
+#include <launcher-utils/executor.hpp>
 #include <launcher-utils/geode.hpp>
 
+#include "cache.hpp"
+#include "trace.hpp"
+#include "utf.hpp"
+
+#include <Geode/utils/AndroidEvent.hpp>
+#include <Geode/utils/string.hpp>
+
+#include <fmt/format.h>
+
+#include <atomic>
+#include <cstring>
+#include <mutex>
 #include <string_view>
 #include <string>
 
 using namespace launcher_utils;
 
+namespace {
+	std::atomic<jni::JavaVMProvider> s_vmProvider{nullptr};
+	std::atomic_uint32_t s_vmGeneration{0};
+
+	std::atomic_bool s_autoAttach{false};
+	std::atomic_uint64_t s_attachCount{0};
+	std::atomic_uint64_t s_detachCount{0};
+
+	/**
+	 * The NDK's jni.h declares the out parameter as JNIEnv**, the JDK's (used by host builds) as void**.
+	 */
+	template <typename VM>
+	jint attachCurrentThread(VM* vm, JNIEnv** env, JavaVMAttachArgs* args) {
+		if constexpr (requires { vm->AttachCurrentThread(env, args); }) {
+			return vm->AttachCurrentThread(env, args);
+		} else {
+			return vm->AttachCurrentThread(reinterpret_cast<void**>(env), args);
+		}
+	}
+
+	char s_threadName[] = "launcher-utils";
+
+	/**
+	 * The calling thread's environment, cached by getEnv.
+	 */
+	struct ThreadEnv {
+		JNIEnv* env{};
+		std::uint32_t generation{};
+
+		/**
+		 * The VM getEnv attached this thread to, if any. Attached threads can't see the launcher's classes,
+		 * so their class misses aren't cached.
+		 */
+		JavaVM* attachedVM{};
+
+		/**
+		 * Set once the thread is exiting, after which getEnv no longer attaches it.
+		 */
+		bool exiting{};
+
+		void detach() {
+			if (attachedVM) {
+				attachedVM->DetachCurrentThread();
+				s_detachCount++;
+			}
+
+			attachedVM = nullptr;
+			env = nullptr;
+		}
+	};
+
+	thread_local constinit ThreadEnv s_threadEnv{};
+
+	bool attachedHere() {
+		return s_threadEnv.attachedVM != nullptr;
+	}
+
+	/**
+	 * Detaches the owning thread on exit, if getEnv attached it.
+	 */
+	struct ThreadAttachment {
+		~ThreadAttachment() {
+			s_threadEnv.detach();
+			s_threadEnv.exiting = true;
+		}
+	};
+}
+
+JavaVM* jni::getJavaVM() {
+	if (auto provider = s_vmProvider.load(std::memory_order_acquire)) {
+		return provider();
+	}
+
+	return cocos2d::JniHelper::getJavaVM();
+}
+
+void jni::setJavaVMProvider(JavaVMProvider provider) {
+	s_vmProvider.store(provider, std::memory_order_release);
+	s_vmGeneration++;
+
+	detail::s_cacheEpoch++;
+	detail::getIdCache().reset();
+}
+
+namespace {
+	geode::Result<JNIEnv*> getEnvImpl(bool attach) {
+		auto& state = s_threadEnv;
+
+		auto generation = s_vmGeneration.load(std::memory_order_relaxed);
+		if (state.env && state.generation == generation) {
+			return geode::Ok(state.env);
+		}
+
+		state.env = nullptr;
+		state.generation = generation;
+
+		auto vm = jni::getJavaVM();
+		if (state.attachedVM && state.attachedVM != vm) {
+			// the VM provider changed since this thread was attached, so it leaves the old VM before joining the new one
+			state.detach();
+		}
+
+		if (!vm) {
+			return geode::Err("getEnv: no JavaVM available");
+		}
+
+		JNIEnv* env = nullptr;
+		auto ret = vm->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_4);
+		switch (ret) {
+			case JNI_OK:
+				state.env = env;
+				return geode::Ok(env);
+			case JNI_EDETACHED: {
+				if (!attach) {
+					return geode::Err("getEnv: environment is on a separate thread");
+				}
+
+				if (state.exiting) {
+					return geode::Err("getEnv: thread is exiting");
+				}
+
+				static thread_local ThreadAttachment attachment{};
+
+				JavaVMAttachArgs args{JNI_VERSION_1_4, s_threadName, nullptr};
+				if (auto attachRet = attachCurrentThread(vm, &env, &args); attachRet != JNI_OK) {
+					return geode::Err(fmt::format("getEnv: AttachCurrentThread failed ({})", attachRet));
+				}
+
+				state.env = env;
+				state.attachedVM = vm;
+				s_attachCount++;
+
+				return geode::Ok(env);
+			}
+			default:
+				return geode::Err(fmt::format("getEnv: {}", ret));
+		}
+	}
+}
+
 geode::Result<JNIEnv*> jni::getEnv() {
-	static thread_local JNIEnv* env = nullptr;
-	if (env) {
-		return geode::Ok(env);
+	return getEnvImpl(s_autoAttach.load(std::memory_order_relaxed));
+}
+
+geode::Result<JNIEnv*> jni::detail::attachCurrentThread() {
+	return getEnvImpl(true);
+}
+
+bool jni::detail::isAttachedThread() {
+	return attachedHere();
+}
+
+void jni::setAutoAttach(bool enabled) {
+	s_autoAttach.store(enabled, std::memory_order_relaxed);
+}
+
+jni::AttachStats jni::getAttachStats() {
+	return {
+		s_attachCount.load(std::memory_order_relaxed),
+		s_detachCount.load(std::memory_order_relaxed)
+	};
+}
+
+namespace {
+	jni::MethodHandle s_getClassName{"java/lang/Class", "getName", "()Ljava/lang/String;"};
+	jni::MethodHandle s_getMessage{"java/lang/Throwable", "getMessage", "()Ljava/lang/String;"};
+	jni::MethodHandle s_throwableToString{"java/lang/Throwable", "toString", "()Ljava/lang/String;"};
+	jni::StaticMethodHandle s_getStackTraceString{"android/util/Log", "getStackTraceString", "(Ljava/lang/Throwable;)Ljava/lang/String;"};
+
+	/**
+	 * Converts the result of a String method. Describing an exception must not leave another one pending,
+	 * so these calls check for exceptions by hand instead of going through checkForExceptions.
+	 */
+	std::string takeString(JNIEnv* env, jobject result) {
+		auto ref = jni::LocalRef::created(result);
+
+		if (env->ExceptionCheck() == JNI_TRUE) {
+			env->ExceptionClear();
+			return {};
+		}
+
+		if (!ref) {
+			return {};
+		}
+
+		return jni::toString(env, ref.get<jstring>()).unwrapOrDefault();
 	}
 
-	auto vm = cocos2d::JniHelper::getJavaVM();
+	std::string callStringMethod(jni::MethodHandle& handle, jobject obj) {
+		if (!obj) {
+			return {};
+		}
 
-	auto ret = vm->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_4);
-	switch (ret) {
-		case JNI_OK:
-			return geode::Ok(env);
-		case JNI_EDETACHED:
-			env = nullptr;
-			return geode::Err("getEnv: environment is on a separate thread");
-		default:
-			env = nullptr;
-			return geode::Err(fmt::format("getEnv: {}", ret));
+		auto envRes = jni::getEnv();
+		if (!envRes) {
+			return {};
+		}
+
+		auto env = envRes.unwrap();
+
+		auto info = handle.resolve(env);
+		if (!info) {
+			return {};
+		}
+
+		return takeString(env, env->CallObjectMethodA(obj, info.unwrap().methodID(), nullptr));
 	}
 }
 
-geode::Result<> jni::checkForExceptions(JNIEnv* env) {
-	if (env->ExceptionCheck() == JNI_TRUE) {
-		auto e = env->ExceptionOccurred();
-		env->ExceptionClear();
+std::string jni::Exception::className() const {
+	if (!get()) {
+		return {};
+	}
 
-		GEODE_UNWRAP_INTO(auto msg, callMethod<std::string>(env, "java/lang/Throwable", "getMessage", "()Ljava/lang/String;", e));
+	auto env = getEnv();
+	if (!env) {
+		return {};
+	}
+
+	auto cls = LocalRef::created(env.unwrap()->GetObjectClass(get()));
+	return callStringMethod(s_getClassName, *cls);
+}
 
-		geode::Err(msg);
+std::string jni::Exception::message() const {
+	return callStringMethod(s_getMessage, get());
+}
+
+std::string jni::Exception::toString() const {
+	return callStringMethod(s_throwableToString, get());
+}
+
+std::string jni::Exception::stackTrace() const {
+	if (!get()) {
+		return {};
+	}
+
+	auto envRes = getEnv();
+	if (!envRes) {
+		return {};
+	}
+
+	auto env = envRes.unwrap();
+
+	// android.util.Log formats the trace and every cause in one call, but isn't there off Android
+	auto info = s_getStackTraceString.resolve(env);
+	if (!info) {
+		return toString();
 	}
 
-	return geode::Ok();
+	jvalue arg{};
+	arg.l = get();
+
+	auto& method = info.unwrap();
+	return takeString(env, env->CallStaticObjectMethodA(method.classID(), method.methodID(), &arg));
 }
 
-geode::Result<jni::GlobalRef&> jni::getClassId(JNIEnv* env, const char* className) {
-	static std::unordered_map<std::string, jni::GlobalRef> s_classCache;
+geode::Result<void, jni::Exception> jni::checkException(JNIEnv* env) {
+	if (env->ExceptionCheck() != JNI_TRUE) {
+		return geode::Ok();
+	}
+
+	auto throwable = env->ExceptionOccurred();
+	env->ExceptionClear();
+
+	auto ref = GlobalRef(throwable);
+	env->DeleteLocalRef(throwable);
+
+	return geode::Err(Exception(std::move(ref)));
+}
+
+std::string jni::Error::message() const {
+	if (auto description = std::get_if<std::string>(&m_value)) {
+		return *description;
+	}
+
+	if (auto description = std::get_if<std::string_view>(&m_value)) {
+		return std::string(*description);
+	}
+
+	auto exception = this->exception();
+
+	auto message = exception->message();
+	if (message.empty()) {
+		message = exception->className();
+	}
+
+	if (message.empty()) {
+		return "Java exception";
+	}
+
+	return message;
+}
 
-	if (auto it = s_classCache.find(className); it != s_classCache.end()) {
-		return geode::Ok(it->second);
+geode::Result<> jni::detail::exceptionToError(JNIEnv* env) {
+	auto r = checkException(env);
+	if (r) {
+		return geode::Ok();
 	}
 
-	auto classId = LocalRef(env->FindClass(className));
+	return geode::Err(Error(std::move(r).unwrapErr()).message());
+}
+
+jni::CacheStats jni::getCacheStats() {
+	return detail::getIdCache().stats();
+}
+
+geode::Result<jni::GlobalRef&> jni::detail::getClassId(JNIEnv* env, const CacheKey& key) {
+	auto& cache = getIdCache();
+
+	if (auto entry = cache.find(key)) {
+		s_classLookups.hit();
+
+		if (!entry->missing.empty()) {
+			return geode::Err(std::string(entry->missing));
+		}
+
+		return geode::Ok(entry->classRef());
+	}
+
+	s_classLookups.miss();
+	MissTrace trace{key.className};
+
+	auto classId = LocalRef::created(env->FindClass(key.className.data()));
 	if (!classId) {
 		env->ExceptionClear();
-		return geode::Err(fmt::format("Failed to find class {}", className));
+
+		auto error = fmt::format("Failed to find class {}", key.className);
+		if (!attachedHere()) {
+			trace.resolved(cache.insertMissing(key, error));
+		}
+
+		return geode::Err(std::move(error));
 	}
 
-	auto& classRef = s_classCache.try_emplace(className, classId.get<jclass>()).first->second;
+	auto& entry = cache.insertClass(key, GlobalRef(classId.get<jclass>()));
+	trace.resolved(entry);
 
-	return geode::Ok(classRef);
+	return geode::Ok(entry.classRef());
 }
 
-geode::Result<jni::MethodInfo&> jni::getStaticMethodInfo(JNIEnv* env, const char* className, const char* methodName, const char* paramSignature) {
-	static std::unordered_map<std::string, MethodInfo> s_methodCache;
+geode::Result<jni::MethodInfo&> jni::detail::lookupMethodInfo(JNIEnv* env, const CacheKey& key) {
+	auto& cache = getIdCache();
+
+	if (auto entry = cache.find(key)) {
+		s_methodLookups.hit();
+		return geode::Ok(entry->methodInfo());
+	}
+
+	s_methodLookups.miss();
+	MissTrace trace{key.className, key.memberName};
+
+	auto classRes = getClassId(env, CacheKey{EntryKind::Class, key.className});
+	if (!classRes) {
+		// members of a missing class are missing too, as long as the class miss itself can be cached
+		if (attachedHere()) {
+			return geode::Err(std::move(classRes).unwrapErr());
+		}
+
+		auto& entry = cache.insertMissing(key, classRes.unwrapErr());
+		trace.resolved(entry);
 
-	auto methodSignature = fmt::format("{}.{}{}", className, methodName, paramSignature);
-	if (auto it = s_methodCache.find(methodSignature); it != s_methodCache.end()) {
-		return geode::Ok(it->second);
+		return geode::Ok(entry.methodInfo());
 	}
 
-	GEODE_UNWRAP_INTO(auto& classId, getClassId(env, className));
+	auto& classId = classRes.unwrap();
 
-	auto methodId = env->GetStaticMethodID(classId.get<jclass>(), methodName, paramSignature);
+	auto isStatic = key.kind == EntryKind::StaticMethod;
+	auto methodId = isStatic
+		? env->GetStaticMethodID(classId.get<jclass>(), key.memberName.data(), key.paramSignature.data())
+		: env->GetMethodID(classId.get<jclass>(), key.memberName.data(), key.paramSignature.data());
 	if (!methodId) {
 		env->ExceptionClear();
-		return geode::Err(fmt::format("Failed to find static method {}.{}{}", className, methodName, paramSignature));
+
+		auto error = fmt::format(
+			"Failed to find {} {}.{}{}", isStatic ? "static method" : "method", key.className, key.memberName, key.paramSignature
+		);
+
+		auto& entry = cache.insertMissing(key, error);
+		trace.resolved(entry);
+
+		return geode::Ok(entry.methodInfo());
 	}
 
-	auto& methodInfo = s_methodCache.try_emplace(
-		methodSignature,
-		classId,
-		methodId
-	).first->second;
+	auto& entry = cache.insertMethod(key, classId, methodId);
+	trace.resolved(entry);
 
-	return geode::Ok(methodInfo);
+	return geode::Ok(entry.methodInfo());
 }
 
-geode::Result<jni::MethodInfo&> jni::getMethodInfo(JNIEnv* env, const char* className, const char* methodName, const char* paramSignature) {
-	static std::unordered_map<std::string, jni::MethodInfo> s_methodCache;
+geode::Result<jni::MethodInfo&> jni::detail::getMethodInfo(JNIEnv* env, const CacheKey& key) {
+	GEODE_UNWRAP_INTO(auto& info, lookupMethodInfo(env, key));
 
-	auto methodSignature = fmt::format("{}.{}{}", className, methodName, paramSignature);
-	if (auto it = s_methodCache.find(methodSignature); it != s_methodCache.end()) {
-		return geode::Ok(it->second);
+	if (!info.missing().empty()) {
+		return geode::Err(std::string(info.missing()));
 	}
 
-	GEODE_UNWRAP_INTO(auto& classId, getClassId(env, className));
+	return geode::Ok(info);
+}
 
-	auto methodId = env->GetMethodID(classId.get<jclass>(), methodName, paramSignature);
-	if (!methodId) {
+geode::Result<jni::FieldInfo&> jni::detail::getFieldInfo(JNIEnv* env, const CacheKey& key) {
+	auto& cache = getIdCache();
+
+	if (auto entry = cache.find(key)) {
+		s_fieldLookups.hit();
+
+		if (!entry->missing.empty()) {
+			return geode::Err(std::string(entry->missing));
+		}
+
+		return geode::Ok(entry->fieldInfo());
+	}
+
+	s_fieldLookups.miss();
+	MissTrace trace{key.className, key.memberName};
+
+	auto classRes = getClassId(env, CacheKey{EntryKind::Class, key.className});
+	if (!classRes) {
+		// members of a missing class are missing too, as long as the class miss itself can be cached
+		if (!attachedHere()) {
+			trace.resolved(cache.insertMissing(key, classRes.unwrapErr()));
+		}
+
+		return geode::Err(std::move(classRes).unwrapErr());
+	}
+
+	auto& classId = classRes.unwrap();
+
+	auto isStatic = key.kind == EntryKind::StaticField;
+	auto fieldId = isStatic
+		? env->GetStaticFieldID(classId.get<jclass>(), key.memberName.data(), key.paramSignature.data())
+		: env->GetFieldID(classId.get<jclass>(), key.memberName.data(), key.paramSignature.data());
+	if (!fieldId) {
 		env->ExceptionClear();
-		return geode::Err(fmt::format("Failed to find static method {}.{}{}", className, methodName, paramSignature));
+
+		auto error = fmt::format(
+			"Failed to find {} {}.{}:{}", isStatic ? "static field" : "field", key.className, key.memberName, key.paramSignature
+		);
+
+		trace.resolved(cache.insertMissing(key, error));
+		return geode::Err(std::move(error));
 	}
 
-	return geode::Ok(s_methodCache.try_emplace(
-		methodSignature,
-		classId,
-		methodId
-	).first->second);
+	auto& entry = cache.insertField(key, classId, fieldId);
+	trace.resolved(entry);
+
+	return geode::Ok(entry.fieldInfo());
 }
 
-jni::LocalRef jni::toJavaArray(JNIEnv* env, std::span<std::int64_t> arr) {
-	auto ptr = env->NewLongArray(arr.size());
-	env->SetLongArrayRegion(ptr, 0, arr.size(), arr.data());
+geode::Result<jni::GlobalRef&> jni::getClassId(JNIEnv* env, const char* className) {
+	return detail::getClassId(env, detail::CacheKey{detail::EntryKind::Class, className});
+}
+
+geode::Result<jni::MethodInfo&> jni::getStaticMethodInfo(JNIEnv* env, const char* className, const char* methodName, const char* paramSignature) {
+	return detail::getMethodInfo(env, detail::CacheKey{detail::EntryKind::StaticMethod, className, methodName, paramSignature});
+}
 
-	return LocalRef(ptr);
+geode::Result<jni::MethodInfo&> jni::getMethodInfo(JNIEnv* env, const char* className, const char* methodName, const char* paramSignature) {
+	return detail::getMethodInfo(env, detail::CacheKey{detail::EntryKind::Method, className, methodName, paramSignature});
 }
 
-geode::Result<std::vector<int>> jni::extractArray(JNIEnv* env, jintArray array) {
-	if (array == nullptr) {
-		return geode::Err("extractArray: null array");
-	}
+geode::Result<jni::FieldInfo&> jni::getStaticFieldInfo(JNIEnv* env, const char* className, const char* fieldName, const char* signature) {
+	return detail::getFieldInfo(env, detail::CacheKey{detail::EntryKind::StaticField, className, fieldName, signature});
+}
 
-	auto len = env->GetArrayLength(array);
-	std::vector<int> r(len);
-	env->GetIntArrayRegion(array, 0, len, r.data());
-	return geode::Ok(r);
+geode::Result<jni::FieldInfo&> jni::getFieldInfo(JNIEnv* env, const char* className, const char* fieldName, const char* signature) {
+	return detail::getFieldInfo(env, detail::CacheKey{detail::EntryKind::Field, className, fieldName, signature});
+}
+
+jni::LocalRef jni::toJavaArray(JNIEnv* env, std::span<std::int64_t> arr) {
+	return toJavaArray<std::span<std::int64_t>>(env, arr);
+}
+
+geode::Result<std::vector<int>> jni::extractArray(JNIEnv* env, jintArray array) {
+	return extractArray<jint>(env, array);
 }
 
 geode::Result<std::string> jni::toString(JNIEnv* env, jstring string) {
+	std::string r{};
+	GEODE_UNWRAP(toString(env, string, r));
+
+	return geode::Ok(std::move(r));
+}
+
+geode::Result<> jni::toString(JNIEnv* env, jstring string, std::string& out) {
 	if (!string) {
 		return geode::Err("convertString: null string");
 	}
 
+	std::size_t length = env->GetStringLength(string);
+
+	// short strings are copied out in one call, skipping the pin/release pair
+	constexpr std::size_t stackLength = 256;
+	if (length <= stackLength) {
+		jchar buf[stackLength];
+		env->GetStringRegion(string, 0, static_cast<jsize>(length), buf);
+
+		return detail::utf16ToUtf8({reinterpret_cast<const char16_t*>(buf), length}, out);
+	}
+
 	auto chars = env->GetStringChars(string, nullptr);
 	if (!chars) {
 		return geode::Err("convertString: GetStringChars failed");
 	}
 
-	std::size_t length = env->GetStringLength(string);
 	std::u16string_view strData{
 		reinterpret_cast<const char16_t*>(chars),
 		length
 	};
 
-	auto r = geode::utils::string::utf16ToUtf8(strData);
+	auto r = detail::utf16ToUtf8(strData, out);
 
 	env->ReleaseStringChars(string, chars);
 
 	return r;
 }
 
-geode::Result<jni::LocalRef> jni::toJString(JNIEnv* env, std::string_view string) {
-	GEODE_UNWRAP_INTO(auto wString, geode::utils::string::utf8ToUtf16(string));
+namespace {
+	/**
+	 * Widens ASCII into a UTF-16 Java string, using a stack buffer for short strings and a reused per-thread buffer for long ones.
+	 */
+	jstring newWidenedString(JNIEnv* env, std::string_view string) {
+		constexpr std::size_t stackLength = 256;
 
-	auto jString = env->NewString(
-		reinterpret_cast<const jchar*>(wString.data()),
-		wString.size()
-	);
-	if (!jString) {
-		return geode::Err("toJavaString: NewString returned null");
+		if (string.size() <= stackLength) {
+			char16_t buf[stackLength];
+			jni::detail::widenAscii(string.data(), string.size(), buf);
+
+			return env->NewString(reinterpret_cast<const jchar*>(buf), string.size());
+		}
+
+		static thread_local std::u16string s_buffer{};
+		s_buffer.resize(string.size());
+		jni::detail::widenAscii(string.data(), string.size(), s_buffer.data());
+
+		return env->NewString(reinterpret_cast<const jchar*>(s_buffer.data()), s_buffer.size());
 	}
 
-	return geode::Ok(LocalRef(jString));
+	/**
+	 * Converts to a Java string. When `terminated` is set, the byte after the view is a NUL, so ASCII is passed to the JVM as is.
+	 */
+	geode::Result<jni::LocalRef> makeJString(JNIEnv* env, std::string_view string, bool terminated) {
+		constexpr std::size_t stackLength = 256;
+
+		jstring jString = nullptr;
+
+		switch (jni::detail::classifyAscii(string)) {
+			case jni::detail::AsciiKind::Plain: {
+				// modified UTF-8 is identical to ASCII as long as there are no NULs, so the JVM can take it directly
+				if (terminated) {
+					jString = env->NewStringUTF(string.data());
+				} else if (string.size() < stackLength) {
+					char buf[stackLength];
+					std::memcpy(buf, string.data(), string.size());
+					buf[string.size()] = '\0';
+
+					jString = env->NewStringUTF(buf);
+				} else {
+					jString = newWidenedString(env, string);
+				}
+				break;
+			}
+			case jni::detail::AsciiKind::WithNul: {
+				jString = newWidenedString(env, string);
+				break;
+			}
+			case jni::detail::AsciiKind::NonAscii: {
+				GEODE_UNWRAP_INTO(auto wString, geode::utils::string::utf8ToUtf16(string));
+
+				jString = env->NewString(
+					reinterpret_cast<const jchar*>(wString.data()),
+					wString.size()
+				);
+				break;
+			}
+		}
+
+		if (!jString) {
+			return geode::Err("toJavaString: NewString returned null");
+		}
+
+		return geode::Ok(jni::LocalRef::created(jString));
+	}
+}
+
+geode::Result<jni::LocalRef> jni::toJString(JNIEnv* env, std::string_view string) {
+	return makeJString(env, string, false);
+}
+
+geode::Result<jni::LocalRef> jni::toJString(JNIEnv* env, const char* string) {
+	return makeJString(env, string, true);
+}
+
+geode::Result<jni::LocalRef> jni::toJString(JNIEnv* env, const std::string& string) {
+	return makeJString(env, string, true);
 }
 
 geode::Result<int> launcher_utils::getConnectedControllerCount() {
-	return jni::callStaticMethod<int>("com/geode/launcher/utils/GeodeUtils", "controllersConnected", "()I");
+	GEODE_UNWRAP(detail::requireCapability(Capability::ControllerCount, "getConnectedControllerCount"));
+	return jni::callStaticMethod<jint(), "com/geode/launcher/utils/GeodeUtils", "controllersConnected">();
 }
 
 geode::Result<std::vector<int>> launcher_utils::getConnectedDevices() {
-	return jni::callStaticMethod<std::vector<int>>("com/geode/launcher/utils/GeodeUtils", "getConnectedDevices", "()[I");
+	GEODE_UNWRAP(detail::requireCapability(Capability::ConnectedDevices, "getConnectedDevices"));
+	return jni::callStaticMethod<std::vector<jint>(), "com/geode/launcher/utils/GeodeUtils", "getConnectedDevices">();
+}
+
+geode::Result<> launcher_utils::getConnectedDevices(std::vector<int>& out) {
+	GEODE_UNWRAP(detail::requireCapability(Capability::ConnectedDevices, "getConnectedDevices"));
+	GEODE_UNWRAP_INTO(auto env, jni::getEnv());
+	GEODE_UNWRAP_INTO(auto array, jni::callStaticMethod<jobject, "com/geode/launcher/utils/GeodeUtils", "getConnectedDevices", "()[I">(env));
+
+	return jni::extractArray<jint>(env, array.get<jintArray>(), out);
 }
 
 geode::Result<bool> launcher_utils::vibrateSupported() {
-	return jni::callStaticMethod<bool>("com/geode/launcher/utils/GeodeUtils", "vibrateSupported", "()Z");
+	GEODE_UNWRAP(detail::requireCapability(Capability::Vibrate, "vibrateSupported"));
+	return jni::callStaticMethod<bool(), "com/geode/launcher/utils/GeodeUtils", "vibrateSupported">();
 }
 
 geode::Result<> launcher_utils::vibrate(std::int64_t ms) {
-	return jni::callStaticMethod<void>("com/geode/launcher/utils/GeodeUtils", "vibrate", "(J)V", ms);
+	GEODE_UNWRAP(detail::requireCapability(Capability::Vibrate, "vibrate"));
+	return jni::callStaticMethod<void(jlong), "com/geode/launcher/utils/GeodeUtils", "vibrate">(ms);
 }
 
 geode::Result<> launcher_utils::vibratePattern(std::span<std::int64_t> pattern, int repeat) {
+	GEODE_UNWRAP(detail::requireCapability(Capability::VibratePattern, "vibratePattern"));
 	GEODE_UNWRAP_INTO(auto env, jni::getEnv());
 
 	auto arr = jni::toJavaArray(env, pattern);
-	auto r = jni::callStaticMethod<void>(env, "com/geode/launcher/utils/GeodeUtils", "vibratePattern", "([JI)V", *arr, repeat);
+	auto r = jni::callStaticMethod<void(std::vector<jlong>, jint), "com/geode/launcher/utils/GeodeUtils", "vibratePattern">(env, arr.get<jlongArray>(), repeat);
 
 	return r;
 }
+
+void launcher_utils::detail::prepareAsyncCall() {
+	if (auto env = jni::getEnv()) {
+		(void)jni::getClassId(env.unwrap(), "com/geode/launcher/utils/GeodeUtils");
+	}
+}
+
+jni::Future<geode::Result<>> launcher_utils::vibrateAsync(std::int64_t ms) {
+	detail::prepareAsyncCall();
+	return jni::Executor::get().submit([ms](JNIEnv*) {
+		return vibrate(ms);
+	});
+}
+
+void launcher_utils::vibrateAsync(std::int64_t ms, AsyncCallback onComplete) {
+	detail::prepareAsyncCall();
+	jni::Executor::get().submit([ms](JNIEnv*) {
+		return vibrate(ms);
+	}, std::move(onComplete));
+}
+
+jni::Future<geode::Result<>> launcher_utils::vibratePatternAsync(std::vector<std::int64_t> pattern, int repeat) {
+	detail::prepareAsyncCall();
+	return jni::Executor::get().submit([pattern = std::move(pattern), repeat](JNIEnv*) mutable {
+		return vibratePattern(pattern, repeat);
+	});
+}
+
+void launcher_utils::vibratePatternAsync(std::vector<std::int64_t> pattern, int repeat, AsyncCallback onComplete) {
+	detail::prepareAsyncCall();
+	jni::Executor::get().submit([pattern = std::move(pattern), repeat](JNIEnv*) mutable {
+		return vibratePattern(pattern, repeat);
+	}, std::move(onComplete));
+}
+
+jni::Future<geode::Result<>> launcher_utils::InputDevice::setLightsAsync(ControllerLightType type, std::uint32_t color) {
+	detail::prepareAsyncCall();
+	return jni::Executor::get().submit([deviceId = m_deviceId, type, color](JNIEnv* env) {
+		return performSetLights(env, deviceId, type, color);
+	});
+}
+
+void launcher_utils::InputDevice::setLightsAsync(ControllerLightType type, std::uint32_t color, AsyncCallback onComplete) {
+	detail::prepareAsyncCall();
+	jni::Executor::get().submit([deviceId = m_deviceId, type, color](JNIEnv* env) {
+		return performSetLights(env, deviceId, type, color);
+	}, std::move(onComplete));
+}
+
+jni::Future<geode::Result<>> launcher_utils::InputDevice::vibrateDeviceAsync(std::int64_t durationMs, int intensity, int motorIdx) {
+	detail::prepareAsyncCall();
+	return jni::Executor::get().submit([deviceId = m_deviceId, durationMs, intensity, motorIdx](JNIEnv* env) {
+		return performVibrateDevice(env, deviceId, durationMs, intensity, motorIdx);
+	});
+}
+
+void launcher_utils::InputDevice::vibrateDeviceAsync(std::int64_t durationMs, int intensity, int motorIdx, AsyncCallback onComplete) {
+	detail::prepareAsyncCall();
+	jni::Executor::get().submit([deviceId = m_deviceId, durationMs, intensity, motorIdx](JNIEnv* env) {
+		return performVibrateDevice(env, deviceId, durationMs, intensity, motorIdx);
+	}, std::move(onComplete));
+}
+
+namespace {
+	std::atomic_uint64_t s_deviceChangeCount{0};
+	std::mutex s_deviceGenerationMutex{};
+	std::vector<std::pair<int, std::uint64_t>> s_deviceGenerations{};
+
+	// registered by a static initializer, which runs on the main thread as the mod is loaded,
+	// so changes made before the first snapshot are counted too. It is never destroyed, as the
+	// event system may already be gone when static destructors run
+	auto s_deviceChangeListener = new geode::EventListener<geode::AndroidInputDeviceFilter>(
+		[](geode::AndroidInputDeviceEvent* event) {
+			std::scoped_lock lock(s_deviceGenerationMutex);
+
+			auto generation = ++s_deviceChangeCount;
+			auto deviceId = event->deviceId();
+
+			auto it = std::find_if(s_deviceGenerations.begin(), s_deviceGenerations.end(), [deviceId](const auto& x) {
+				return x.first == deviceId;
+			});
+
+			if (it != s_deviceGenerations.end()) {
+				it->second = generation;
+			} else {
+				s_deviceGenerations.emplace_back(deviceId, generation);
+			}
+
+			return geode::ListenerResult::Propagate;
+		},
+		geode::AndroidInputDeviceFilter()
+	);
+}
+
+std::uint64_t launcher_utils::detail::getDeviceChangeCount() {
+	return s_deviceChangeCount.load(std::memory_order_acquire);
+}
+
+std::uint64_t launcher_utils::detail::getDeviceGeneration(int deviceId) {
+	std::scoped_lock lock(s_deviceGenerationMutex);
+
+	for (const auto& [id, generation] : s_deviceGenerations) {
+		if (id == deviceId) {
+			return generation;
+		}
+	}
+
+	return 0;
+}
+
+launcher_utils::InputDevice::Info launcher_utils::InputDevice::fetchInfo(std::uint64_t generation) {
+	static jni::MethodHandle s_getDescriptor{"android/view/InputDevice", "getDescriptor", "()Ljava/lang/String;"};
+	static jni::MethodHandle s_getName{"android/view/InputDevice", "getName", "()Ljava/lang/String;"};
+	static jni::MethodHandle s_getVendorId{"android/view/InputDevice", "getVendorId", "()I"};
+	static jni::MethodHandle s_getProductId{"android/view/InputDevice", "getProductId", "()I"};
+	static jni::MethodHandle s_getSources{"android/view/InputDevice", "getSources", "()I"};
+	static jni::StaticMethodHandle s_getLightCount{"com/geode/launcher/utils/GeodeUtils", "getDeviceLightsCount", "(I)I"};
+	static jni::StaticMethodHandle s_getLightType{"com/geode/launcher/utils/GeodeUtils", "getLightType", "(I)I"};
+	static jni::StaticMethodHandle s_getMotorCount{"com/geode/launcher/utils/GeodeUtils", "getDeviceHapticsCount", "(I)I"};
+
+	Info info{};
+
+	auto envRes = jni::getEnv();
+	if (!envRes) {
+		return info;
+	}
+
+	auto env = envRes.unwrap();
+
+	// an InputDevice is a snapshot of the device when it was fetched, so a reconfigured device has to be fetched again.
+	// if it has been disconnected since, the old object is kept and the fetch is retried on the next change
+	if (generation != m_deviceGeneration) {
+		auto device = jni::callStaticMethod<jni::Object<"android/view/InputDevice">(jint), "com/geode/launcher/utils/GeodeUtils", "getDevice">(env, m_deviceId);
+		if (device && device.unwrap()) {
+			m_inputDevice = jni::GlobalRef(*device.unwrap());
+			m_deviceGeneration = generation;
+		}
+	}
+
+	auto obj = *m_inputDevice;
+
+	info.descriptor = s_getDescriptor.invoke<std::string>(env, obj).unwrapOrDefault();
+	info.name = s_getName.invoke<std::string>(env, obj).unwrapOrDefault();
+	info.vendorId = s_getVendorId.invoke<int>(env, obj).unwrapOrDefault();
+	info.productId = s_getProductId.invoke<int>(env, obj).unwrapOrDefault();
+	info.sources = static_cast<Source>(s_getSources.invoke<int>(env, obj).unwrapOrDefault());
+	info.lightCount = s_getLightCount.invoke<int>(env, m_deviceId).unwrapOrDefault();
+	info.lightType = static_cast<ControllerLightType>(s_getLightType.invoke<int>(env, m_deviceId).unwrapOrDefault());
+	info.motorCount = s_getMotorCount.invoke<int>(env, m_deviceId).unwrapOrDefault();
+
+	return info;
+}
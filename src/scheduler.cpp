@@ -0,0 +1,157 @@
+#include <launcher-utils/scheduler.hpp>
+
+#include <Geode/loader/Loader.hpp>
+
+#include <algorithm>
+
+using namespace launcher_utils;
+
+namespace {
+	std::uint64_t nanosecondsBetween(std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end) {
+		return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+	}
+}
+
+jni::FrameScheduler& jni::FrameScheduler::get() {
+	static FrameScheduler s_scheduler{};
+	return s_scheduler;
+}
+
+jni::FrameScheduler::~FrameScheduler() {
+	for (auto& entry : m_queue) {
+		entry.task->destroy();
+	}
+
+	for (auto& entry : m_incoming) {
+		entry.task->destroy();
+	}
+}
+
+void jni::FrameScheduler::push(detail::Task* task, detail::CostEstimate& estimate) {
+	task->submitted = std::chrono::steady_clock::now();
+
+	{
+		std::scoped_lock lock(m_mutex);
+		m_incoming.push_back(Entry{task, &estimate});
+
+		if (m_frameQueued) {
+			return;
+		}
+
+		m_frameQueued = true;
+	}
+
+	queueFrame();
+}
+
+void jni::FrameScheduler::queueFrame() {
+	geode::Loader::get()->queueInMainThread([] {
+		FrameScheduler::get().runFrame();
+	});
+}
+
+void jni::FrameScheduler::setBudget(std::chrono::microseconds budget) {
+	std::scoped_lock lock(m_mutex);
+	m_budget = budget;
+}
+
+void jni::FrameScheduler::runFrame() {
+	auto frameStart = std::chrono::steady_clock::now();
+
+	std::uint64_t budget;
+
+	{
+		std::scoped_lock lock(m_mutex);
+		m_frameQueued = false;
+
+		m_queue.insert(m_queue.end(), m_incoming.begin(), m_incoming.end());
+		m_incoming.clear();
+
+		budget = static_cast<std::uint64_t>(m_budget.count());
+	}
+
+	if (m_queue.empty()) {
+		return;
+	}
+
+	auto env = getEnv();
+
+	std::uint64_t spent = 0;
+	std::uint64_t ran = 0;
+	std::uint64_t oversized = 0;
+
+	for (auto& entry : m_queue) {
+		// tasks from a call site that hasn't run yet have no estimate, and are let through to get one.
+		// the first task always runs, so a task over the whole budget isn't stuck; once a task doesn't fit,
+		// the ones behind it wait as well, so cheap tasks can't overtake it
+		auto estimate = entry.estimate->nanoseconds;
+		if (ran > 0 && spent + estimate > budget) {
+			break;
+		}
+
+		auto begin = std::chrono::steady_clock::now();
+		entry.task->run(env);
+		auto cost = nanosecondsBetween(begin, std::chrono::steady_clock::now());
+
+		entry.estimate->update(cost);
+		spent += cost;
+
+		ran++;
+		if (estimate > budget) {
+			oversized++;
+		}
+
+		entry.task->destroy();
+	}
+
+	m_queue.erase(m_queue.begin(), m_queue.begin() + static_cast<std::ptrdiff_t>(ran));
+	auto deferred = m_queue.size();
+
+	auto frameTime = nanosecondsBetween(frameStart, std::chrono::steady_clock::now());
+	auto queueNext = false;
+
+	{
+		std::scoped_lock lock(m_mutex);
+
+		m_stats.frames++;
+		m_stats.tasksRun += ran;
+		m_stats.tasksDeferred += deferred;
+		m_stats.lastFrameDeferred = deferred;
+		m_stats.maxDeferredInFrame = std::max(m_stats.maxDeferredInFrame, deferred);
+		m_stats.oversizedRuns += oversized;
+		m_stats.totalRunNanoseconds += spent;
+		m_stats.maxFrameNanoseconds = std::max(m_stats.maxFrameNanoseconds, frameTime);
+		m_stats.queueDepth = m_queue.size();
+
+		if (spent > budget) {
+			m_stats.framesOverBudget++;
+		}
+
+		// deferred work, and anything submitted by the tasks that just ran, continues next frame
+		if ((!m_queue.empty() || !m_incoming.empty()) && !m_frameQueued) {
+			m_frameQueued = true;
+			queueNext = true;
+		}
+	}
+
+	if (queueNext) {
+		queueFrame();
+	}
+}
+
+jni::FrameSchedulerStats jni::FrameScheduler::stats() const {
+	std::scoped_lock lock(m_mutex);
+
+	auto stats = m_stats;
+	stats.queueDepth += m_incoming.size();
+
+	return stats;
+}
+
+void jni::FrameScheduler::resetStats() {
+	std::scoped_lock lock(m_mutex);
+
+	auto queueDepth = m_stats.queueDepth;
+	m_stats = FrameSchedulerStats{};
+	m_stats.queueDepth = queueDepth;
+}
@@ -0,0 +1,127 @@
+#include <launcher-utils/jni.hpp>
+
+#include "cache.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+
+using namespace launcher_utils;
+
+std::uint64_t jni::MethodCallStats::percentile(double p) const {
+	std::uint64_t total = 0;
+	for (auto count : latency) {
+		total += count;
+	}
+
+	if (total == 0) {
+		return 0;
+	}
+
+	auto target = static_cast<std::uint64_t>(p * static_cast<double>(total));
+	std::uint64_t seen = 0;
+
+	for (std::size_t i = 0; i < latency.size(); i++) {
+		seen += latency[i];
+		if (seen > target) {
+			return std::uint64_t{1} << i;
+		}
+	}
+
+	return std::uint64_t{1} << (latency.size() - 1);
+}
+
+jni::CallStats jni::getCallStats() {
+	CallStats stats{};
+
+#ifdef LAUNCHER_UTILS_INSTRUMENTATION
+	stats.enabled = true;
+
+	stats.classCacheHits = detail::s_classLookups.hits.load(std::memory_order_relaxed);
+	stats.classCacheMisses = detail::s_classLookups.misses.load(std::memory_order_relaxed);
+	stats.methodCacheHits = detail::s_methodLookups.hits.load(std::memory_order_relaxed);
+	stats.methodCacheMisses = detail::s_methodLookups.misses.load(std::memory_order_relaxed);
+	stats.fieldCacheHits = detail::s_fieldLookups.hits.load(std::memory_order_relaxed);
+	stats.fieldCacheMisses = detail::s_fieldLookups.misses.load(std::memory_order_relaxed);
+
+	detail::getIdCache().forEach([&stats](detail::CacheEntry& entry) {
+		if (entry.key.kind != detail::EntryKind::StaticMethod && entry.key.kind != detail::EntryKind::Method) {
+			return;
+		}
+
+		if (!entry.missing.empty()) {
+			return;
+		}
+
+		auto& counters = entry.methodInfo().counters();
+
+		MethodCallStats method{};
+		method.className = entry.key.className;
+		method.methodName = entry.key.memberName;
+		method.signature = entry.key.paramSignature;
+		method.isStatic = entry.key.kind == detail::EntryKind::StaticMethod;
+
+		method.calls = counters.calls.load(std::memory_order_relaxed);
+		method.exceptions = counters.exceptions.load(std::memory_order_relaxed);
+		method.totalNanoseconds = counters.totalNanoseconds.load(std::memory_order_relaxed);
+		for (std::size_t i = 0; i < s_latencyBucketCount; i++) {
+			method.latency[i] = counters.latency[i].load(std::memory_order_relaxed);
+		}
+
+		stats.methods.push_back(method);
+	});
+#endif
+
+	return stats;
+}
+
+void jni::resetCallStats() {
+#ifdef LAUNCHER_UTILS_INSTRUMENTATION
+	for (auto lookups : {&detail::s_classLookups, &detail::s_methodLookups, &detail::s_fieldLookups}) {
+		lookups->hits.store(0, std::memory_order_relaxed);
+		lookups->misses.store(0, std::memory_order_relaxed);
+	}
+
+	detail::getIdCache().forEach([](detail::CacheEntry& entry) {
+		if (entry.key.kind == detail::EntryKind::StaticMethod || entry.key.kind == detail::EntryKind::Method) {
+			entry.methodInfo().counters().reset();
+		}
+	});
+#endif
+}
+
+std::string jni::formatCallStats(const CallStats& stats) {
+	if (!stats.enabled) {
+		return "call statistics are disabled (build with LAUNCHER_UTILS_INSTRUMENTATION)";
+	}
+
+	auto r = fmt::format(
+		"class cache: {} hits, {} misses; method cache: {} hits, {} misses; field cache: {} hits, {} misses\n",
+		stats.classCacheHits, stats.classCacheMisses, stats.methodCacheHits, stats.methodCacheMisses,
+		stats.fieldCacheHits, stats.fieldCacheMisses
+	);
+
+	std::vector<const MethodCallStats*> methods{};
+	for (const auto& method : stats.methods) {
+		if (method.calls > 0) {
+			methods.push_back(&method);
+		}
+	}
+
+	std::ranges::sort(methods, [](const MethodCallStats* a, const MethodCallStats* b) {
+		return a->totalNanoseconds > b->totalNanoseconds;
+	});
+
+	for (auto method : methods) {
+		r += fmt::format(
+			"{}.{}{}: {} calls, {} exceptions, total {:.3f}ms, mean {}ns, p50 <{}ns, p99 <{}ns\n",
+			method->className, method->methodName, method->signature,
+			method->calls, method->exceptions,
+			static_cast<double>(method->totalNanoseconds) / 1'000'000.0,
+			method->totalNanoseconds / method->calls,
+			method->percentile(0.5), method->percentile(0.99)
+		);
+	}
+
+	return r;
+}
@@ -0,0 +1,296 @@
+#include <launcher-utils/trace.hpp>
+
+#include "trace.hpp"
+
+#ifdef LAUNCHER_UTILS_TRACING
+#include <fmt/format.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace launcher_utils;
+
+#ifdef LAUNCHER_UTILS_TRACING
+namespace {
+	enum class EventKind : std::uint8_t {
+		Call,
+		CacheMiss,
+		Frame
+	};
+
+	struct Event {
+		EventKind kind{};
+		std::string_view className{};
+		std::string_view memberName{};
+		std::string_view signature{};
+		std::int64_t begin{};
+		std::int64_t end{};
+	};
+
+	/**
+	 * Ring buffer written only by its own thread. `position` packs the tracing generation the buffer was last
+	 * written in (upper bits) with the number of events written since (lower bits). A buffer left from an earlier
+	 * startTracing reads as empty, and its own thread starts it over on its next write.
+	 */
+	struct ThreadBuffer {
+		int threadId{};
+		std::unique_ptr<Event[]> events{std::make_unique<Event[]>(jni::s_traceBufferEvents)};
+		std::atomic_uint64_t position{0};
+	};
+
+	constexpr unsigned s_countBits = 40;
+	constexpr std::uint64_t s_countMask = (std::uint64_t{1} << s_countBits) - 1;
+
+	std::mutex s_buffersMutex{};
+	std::vector<std::unique_ptr<ThreadBuffer>> s_buffers{};
+	std::atomic_int64_t s_traceStart{0};
+
+	/**
+	 * Buffers of threads that have exited, handed to the next thread that records an event.
+	 */
+	std::vector<ThreadBuffer*> s_freeBuffers{};
+
+	/**
+	 * Incremented by startTracing, so every buffer is emptied without touching another thread's buffer.
+	 */
+	std::atomic_uint64_t s_traceGeneration{0};
+
+	thread_local ThreadBuffer* t_buffer = nullptr;
+
+	/**
+	 * Frees the thread's buffer as it exits. Kept apart from t_buffer, which is read on every event
+	 * and so has no destructor to register.
+	 */
+	struct BufferRelease {
+		ThreadBuffer* buffer{};
+
+		~BufferRelease() {
+			if (buffer) {
+				std::scoped_lock lock(s_buffersMutex);
+				s_freeBuffers.push_back(buffer);
+			}
+		}
+	};
+
+	thread_local BufferRelease t_bufferRelease{};
+
+	// names of failed lookups, which have no cache entry to borrow them from
+	std::mutex s_namesMutex{};
+	std::unordered_set<std::string> s_names{};
+
+	std::int64_t toNanoseconds(std::chrono::steady_clock::time_point time) {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+	}
+
+	std::uint64_t generationBits() {
+		return s_traceGeneration.load(std::memory_order_acquire) << s_countBits;
+	}
+
+	ThreadBuffer& threadBuffer() {
+		if (t_buffer == nullptr) {
+			std::scoped_lock lock(s_buffersMutex);
+
+			ThreadBuffer* buffer;
+			if (!s_freeBuffers.empty()) {
+				// the events left by the thread that exited are dropped
+				buffer = s_freeBuffers.back();
+				s_freeBuffers.pop_back();
+				buffer->position.store(generationBits(), std::memory_order_release);
+			} else {
+				buffer = s_buffers.emplace_back(std::make_unique<ThreadBuffer>()).get();
+			}
+
+			buffer->threadId = static_cast<int>(::syscall(SYS_gettid));
+
+			t_buffer = buffer;
+			t_bufferRelease.buffer = buffer;
+		}
+
+		return *t_buffer;
+	}
+
+	/**
+	 * Number of events written to the buffer since tracing last started.
+	 */
+	std::uint64_t eventCount(std::uint64_t position, std::uint64_t generation) {
+		return (position & ~s_countMask) == generation ? position & s_countMask : 0;
+	}
+
+	void pushEvent(const Event& event) {
+		auto& buffer = threadBuffer();
+
+		auto generation = generationBits();
+		auto count = eventCount(buffer.position.load(std::memory_order_relaxed), generation);
+
+		buffer.events[count % jni::s_traceBufferEvents] = event;
+		buffer.position.store(generation | (count + 1), std::memory_order_release);
+	}
+
+	std::string_view internName(std::string_view name) {
+		std::scoped_lock lock(s_namesMutex);
+		return *s_names.emplace(name).first;
+	}
+
+	void appendEscaped(std::string& out, std::string_view str) {
+		for (auto c : str) {
+			if (c == '"' || c == '\\') {
+				out += '\\';
+			}
+
+			out += c;
+		}
+	}
+
+	void appendEvent(std::string& out, const Event& event, int pid, int tid, std::int64_t start) {
+		auto ts = static_cast<double>(event.begin - start) / 1000.0;
+
+		if (event.kind == EventKind::Frame) {
+			out += fmt::format(R"({{"name":"frame","cat":"frame","ph":"i","s":"g","ts":{:.3f},"pid":{},"tid":{}}})", ts, pid, tid);
+			return;
+		}
+
+		// show the class without its package, the full name is kept in the arguments
+		auto shortClass = event.className.substr(event.className.rfind('/') + 1);
+
+		out += R"({"name":")";
+		if (event.kind == EventKind::CacheMiss) {
+			out += "cache miss ";
+		}
+		appendEscaped(out, shortClass);
+		if (!event.memberName.empty()) {
+			out += '.';
+			appendEscaped(out, event.memberName);
+		}
+
+		out += fmt::format(
+			R"(","cat":"{}","ph":"X","ts":{:.3f},"dur":{:.3f},"pid":{},"tid":{},"args":{{"class":")",
+			event.kind == EventKind::Call ? "jni" : "jni.cache",
+			ts, static_cast<double>(event.end - event.begin) / 1000.0, pid, tid
+		);
+		appendEscaped(out, event.className);
+		out += R"(","signature":")";
+		appendEscaped(out, event.signature);
+		out += R"("}})";
+	}
+}
+
+void jni::detail::traceCall(const MethodInfo& info, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end) {
+	pushEvent({
+		EventKind::Call,
+		info.className(), info.methodName(), info.signature(),
+		toNanoseconds(begin), toNanoseconds(end)
+	});
+}
+
+void jni::detail::traceCacheMiss(
+	const CacheEntry* entry, std::string_view className, std::string_view memberName,
+	std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end
+) {
+	Event event{EventKind::CacheMiss};
+	event.begin = toNanoseconds(begin);
+	event.end = toNanoseconds(end);
+
+	if (entry != nullptr) {
+		event.className = entry->key.className;
+		event.memberName = entry->key.memberName;
+		event.signature = entry->key.paramSignature;
+	} else {
+		event.className = internName(className);
+		event.memberName = internName(memberName);
+	}
+
+	pushEvent(event);
+}
+#endif
+
+void jni::startTracing() {
+#ifdef LAUNCHER_UTILS_TRACING
+	s_traceGeneration.fetch_add(1, std::memory_order_acq_rel);
+	s_traceStart.store(toNanoseconds(std::chrono::steady_clock::now()), std::memory_order_relaxed);
+	detail::s_tracing.store(true, std::memory_order_release);
+#endif
+}
+
+void jni::stopTracing() {
+#ifdef LAUNCHER_UTILS_TRACING
+	detail::s_tracing.store(false, std::memory_order_release);
+#endif
+}
+
+bool jni::isTracing() {
+#ifdef LAUNCHER_UTILS_TRACING
+	return detail::s_tracing.load(std::memory_order_relaxed);
+#else
+	return false;
+#endif
+}
+
+void jni::markTraceFrame() {
+#ifdef LAUNCHER_UTILS_TRACING
+	if (!detail::s_tracing.load(std::memory_order_relaxed)) {
+		return;
+	}
+
+	auto now = toNanoseconds(std::chrono::steady_clock::now());
+	pushEvent({EventKind::Frame, {}, {}, {}, now, now});
+#endif
+}
+
+jni::TraceStats jni::getTraceStats() {
+	TraceStats stats{};
+
+#ifdef LAUNCHER_UTILS_TRACING
+	std::scoped_lock lock(s_buffersMutex);
+
+	auto generation = generationBits();
+
+	stats.threads = s_buffers.size();
+	for (auto& buffer : s_buffers) {
+		auto head = eventCount(buffer->position.load(std::memory_order_acquire), generation);
+
+		stats.events += std::min<std::uint64_t>(head, s_traceBufferEvents);
+		if (head > s_traceBufferEvents) {
+			stats.droppedEvents += head - s_traceBufferEvents;
+		}
+	}
+#endif
+
+	return stats;
+}
+
+std::string jni::getTraceJson() {
+	std::string out = R"({"displayTimeUnit":"ns","traceEvents":[)";
+
+#ifdef LAUNCHER_UTILS_TRACING
+	auto pid = static_cast<int>(::getpid());
+	auto start = s_traceStart.load(std::memory_order_relaxed);
+	auto first = true;
+
+	std::scoped_lock lock(s_buffersMutex);
+	auto generation = generationBits();
+
+	for (auto& buffer : s_buffers) {
+		auto head = eventCount(buffer->position.load(std::memory_order_acquire), generation);
+		auto begin = head > s_traceBufferEvents ? head - s_traceBufferEvents : 0;
+
+		for (auto i = begin; i < head; i++) {
+			if (!first) {
+				out += ',';
+			}
+			first = false;
+
+			appendEvent(out, buffer->events[i % s_traceBufferEvents], pid, buffer->threadId, start);
+		}
+	}
+#endif
+
+	out += "]}";
+	return out;
+}
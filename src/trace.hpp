@@ -0,0 +1,63 @@
+#pragma once
+
+#include <launcher-utils/trace.hpp>
+
+#include "cache.hpp"
+
+#include <chrono>
+#include <string_view>
+
+namespace launcher_utils::jni::detail {
+#ifdef LAUNCHER_UTILS_TRACING
+	/**
+	 * Appends a cache miss event to the calling thread's trace buffer.
+	 * If `entry` is null, the names are copied, as the caller's strings don't outlive the lookup.
+	 */
+	void traceCacheMiss(
+		const CacheEntry* entry, std::string_view className, std::string_view memberName,
+		std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end
+	);
+#endif
+
+	/**
+	 * Traces a cache miss, from construction until destruction. Does nothing unless built with LAUNCHER_UTILS_TRACING.
+	 */
+	class MissTrace final {
+#ifdef LAUNCHER_UTILS_TRACING
+		std::string_view m_className;
+		std::string_view m_memberName;
+		const CacheEntry* m_entry{};
+		std::chrono::steady_clock::time_point m_begin{};
+		bool m_tracing{};
+
+	public:
+		explicit MissTrace(std::string_view className, std::string_view memberName = {})
+			: m_className(className), m_memberName(memberName), m_tracing(s_tracing.load(std::memory_order_relaxed)) {
+			if (m_tracing) {
+				m_begin = std::chrono::steady_clock::now();
+			}
+		}
+
+		~MissTrace() {
+			if (m_tracing) {
+				traceCacheMiss(m_entry, m_className, m_memberName, m_begin, std::chrono::steady_clock::now());
+			}
+		}
+
+		/**
+		 * Sets the entry the lookup produced, so the event can refer to its interned names.
+		 */
+		void resolved(const CacheEntry& entry) {
+			m_entry = &entry;
+		}
+#else
+	public:
+		explicit MissTrace(std::string_view, std::string_view = {}) {}
+
+		void resolved(const CacheEntry&) {}
+#endif
+
+		MissTrace(const MissTrace&) = delete;
+		MissTrace& operator=(const MissTrace&) = delete;
+	};
+}
@@ -0,0 +1,135 @@
+#include "utf.hpp"
+
+#include <Geode/utils/string.hpp>
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+using namespace launcher_utils::jni;
+
+std::size_t detail::narrowAscii(const char16_t* src, std::size_t len, char* dst) {
+	std::size_t i = 0;
+
+#if defined(__SSE2__)
+	auto highMask = _mm_set1_epi16(static_cast<short>(0xff80));
+	auto zero = _mm_setzero_si128();
+
+	for (; i + 16 <= len; i += 16) {
+		auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+		auto b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 8));
+
+		auto high = _mm_and_si128(_mm_or_si128(a, b), highMask);
+		if (_mm_movemask_epi8(_mm_cmpeq_epi16(high, zero)) != 0xffff) {
+			break;
+		}
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(a, b));
+	}
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+	for (; i + 16 <= len; i += 16) {
+		auto a = vld1q_u16(reinterpret_cast<const std::uint16_t*>(src + i));
+		auto b = vld1q_u16(reinterpret_cast<const std::uint16_t*>(src + i + 8));
+
+		if (vmaxvq_u16(vorrq_u16(a, b)) >= 0x80) {
+			break;
+		}
+
+		vst1q_u8(reinterpret_cast<std::uint8_t*>(dst + i), vcombine_u8(vmovn_u16(a), vmovn_u16(b)));
+	}
+#endif
+
+	// scalar tail, also finds the exact position of a non-ASCII unit in the last vector block
+	for (; i < len; i++) {
+		auto c = src[i];
+		if (c >= 0x80) {
+			break;
+		}
+
+		dst[i] = static_cast<char>(c);
+	}
+
+	return i;
+}
+
+detail::AsciiKind detail::classifyAscii(std::string_view str) {
+	auto src = reinterpret_cast<const std::uint8_t*>(str.data());
+	auto len = str.size();
+
+	std::size_t i = 0;
+	bool hasNul = false;
+
+#if defined(__SSE2__)
+	auto zero = _mm_setzero_si128();
+
+	for (; i + 16 <= len; i += 16) {
+		auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+		if (_mm_movemask_epi8(v) != 0) {
+			return AsciiKind::NonAscii;
+		}
+
+		hasNul |= _mm_movemask_epi8(_mm_cmpeq_epi8(v, zero)) != 0;
+	}
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+	for (; i + 16 <= len; i += 16) {
+		auto v = vld1q_u8(src + i);
+		if (vmaxvq_u8(v) >= 0x80) {
+			return AsciiKind::NonAscii;
+		}
+
+		hasNul |= vminvq_u8(v) == 0;
+	}
+#endif
+
+	for (; i < len; i++) {
+		if (src[i] >= 0x80) {
+			return AsciiKind::NonAscii;
+		}
+
+		hasNul |= src[i] == 0;
+	}
+
+	return hasNul ? AsciiKind::WithNul : AsciiKind::Plain;
+}
+
+void detail::widenAscii(const char* src, std::size_t len, char16_t* dst) {
+	std::size_t i = 0;
+
+#if defined(__SSE2__)
+	auto zero = _mm_setzero_si128();
+
+	for (; i + 16 <= len; i += 16) {
+		auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi8(v, zero));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 8), _mm_unpackhi_epi8(v, zero));
+	}
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+	for (; i + 16 <= len; i += 16) {
+		auto v = vld1q_u8(reinterpret_cast<const std::uint8_t*>(src + i));
+
+		vst1q_u16(reinterpret_cast<std::uint16_t*>(dst + i), vmovl_u8(vget_low_u8(v)));
+		vst1q_u16(reinterpret_cast<std::uint16_t*>(dst + i + 8), vmovl_high_u8(v));
+	}
+#endif
+
+	for (; i < len; i++) {
+		dst[i] = static_cast<char16_t>(static_cast<std::uint8_t>(src[i]));
+	}
+}
+
+geode::Result<> detail::utf16ToUtf8(std::u16string_view str, std::string& out) {
+	out.resize(str.size());
+
+	if (narrowAscii(str.data(), str.size(), out.data()) == str.size()) {
+		return geode::Ok();
+	}
+
+	GEODE_UNWRAP_INTO(out, geode::utils::string::utf16ToUtf8(str));
+	return geode::Ok();
+}
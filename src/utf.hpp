@@ -0,0 +1,37 @@
+#pragma once
+
+#include <Geode/Result.hpp>
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace launcher_utils::jni::detail {
+	/**
+	 * Copies UTF-16 code units into `dst` as long as they are ASCII.
+	 * Returns the number of units copied, which is less than `len` if a non-ASCII unit was found.
+	 */
+	std::size_t narrowAscii(const char16_t* src, std::size_t len, char* dst);
+
+	enum class AsciiKind {
+		/** ASCII without any NUL bytes. */
+		Plain,
+		/** ASCII containing at least one NUL byte. */
+		WithNul,
+		/** Contains bytes outside of ASCII. */
+		NonAscii
+	};
+
+	AsciiKind classifyAscii(std::string_view str);
+
+	/**
+	 * Widens ASCII bytes into UTF-16 code units. The input must be ASCII (see classifyAscii).
+	 */
+	void widenAscii(const char* src, std::size_t len, char16_t* dst);
+
+	/**
+	 * Converts UTF-16 to UTF-8 into `out`, reusing its capacity.
+	 * ASCII strings are narrowed directly, anything else falls back to Geode's converter.
+	 */
+	geode::Result<> utf16ToUtf8(std::u16string_view str, std::string& out);
+}
@@ -0,0 +1,256 @@
+#include <launcher-utils/warmup.hpp>
+
+#include <Geode/loader/Loader.hpp>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+
+#include "launcher.hpp"
+
+using namespace launcher_utils;
+
+namespace {
+	using Clock = std::chrono::steady_clock;
+
+	constexpr auto s_inputDeviceClass = "android/view/InputDevice";
+
+	std::uint64_t elapsedSince(Clock::time_point start) {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+	}
+
+	std::vector<jni::WarmupTarget> defaultTargets() {
+		std::vector<jni::WarmupTarget> targets{};
+
+		for (const auto& method : detail::s_launcherMethods) {
+			targets.push_back(jni::WarmupTarget::staticMethod(detail::s_utilsClass, method.name, method.signature));
+		}
+
+		// used by InputDevice
+		targets.push_back(jni::WarmupTarget::method(s_inputDeviceClass, "getDescriptor", jni::signatureOf<std::string()>));
+		targets.push_back(jni::WarmupTarget::method(s_inputDeviceClass, "getName", jni::signatureOf<std::string()>));
+		targets.push_back(jni::WarmupTarget::method(s_inputDeviceClass, "getVendorId", jni::signatureOf<jint()>));
+		targets.push_back(jni::WarmupTarget::method(s_inputDeviceClass, "getProductId", jni::signatureOf<jint()>));
+		targets.push_back(jni::WarmupTarget::method(s_inputDeviceClass, "getSources", jni::signatureOf<jint()>));
+
+		// used to describe exceptions, so the first failing call isn't slowed down further
+		targets.push_back(jni::WarmupTarget::method("java/lang/Class", "getName", "()Ljava/lang/String;"));
+		targets.push_back(jni::WarmupTarget::method("java/lang/Throwable", "getMessage", "()Ljava/lang/String;"));
+		targets.push_back(jni::WarmupTarget::method("java/lang/Throwable", "toString", "()Ljava/lang/String;"));
+		targets.push_back(jni::WarmupTarget::staticMethod("android/util/Log", "getStackTraceString", "(Ljava/lang/Throwable;)Ljava/lang/String;"));
+
+		return targets;
+	}
+
+	// constant initialized, so registrars in other translation units can use it during static initialization
+	std::mutex s_targetsMutex{};
+
+	std::vector<jni::WarmupTarget>& warmupTargets() {
+		static std::vector<jni::WarmupTarget> s_targets = defaultTargets();
+		return s_targets;
+	}
+
+	/**
+	 * One entry per class, in the order the classes are first listed, followed by the members.
+	 */
+	std::vector<jni::WarmupEntry> planEntries() {
+		std::scoped_lock lock(s_targetsMutex);
+
+		std::vector<jni::WarmupEntry> entries{};
+		std::size_t classCount = 0;
+
+		for (const auto& target : warmupTargets()) {
+			auto className = target.key().className;
+
+			auto classEnd = entries.begin() + classCount;
+			auto listed = std::ranges::any_of(entries.begin(), classEnd, [&](const jni::WarmupEntry& entry) {
+				return entry.target.key().className == className;
+			});
+
+			if (!listed) {
+				entries.insert(classEnd, jni::WarmupEntry{jni::WarmupTarget::forClass(className)});
+				classCount++;
+			}
+
+			if (target.key().kind != jni::detail::EntryKind::Class) {
+				entries.push_back(jni::WarmupEntry{target});
+			}
+		}
+
+		return entries;
+	}
+
+	geode::Result<> resolve(JNIEnv* env, const jni::detail::CacheKey& key) {
+		switch (key.kind) {
+			case jni::detail::EntryKind::Class:
+				GEODE_UNWRAP(jni::detail::getClassId(env, key));
+				break;
+			case jni::detail::EntryKind::StaticMethod:
+			case jni::detail::EntryKind::Method:
+				GEODE_UNWRAP(jni::detail::getMethodInfo(env, key));
+				break;
+			case jni::detail::EntryKind::StaticField:
+			case jni::detail::EntryKind::Field:
+				GEODE_UNWRAP(jni::detail::getFieldInfo(env, key));
+				break;
+		}
+
+		return geode::Ok();
+	}
+
+	void resolveEntry(JNIEnv* env, jni::WarmupEntry& entry) {
+		auto start = Clock::now();
+		auto r = resolve(env, entry.target.key());
+		entry.nanoseconds = elapsedSince(start);
+
+		if (!r) {
+			entry.error = r.unwrapErr();
+		}
+	}
+
+	void countResults(jni::WarmupReport& report) {
+		report.failed = std::ranges::count_if(report.entries, [](const jni::WarmupEntry& entry) {
+			return !entry.error.empty();
+		});
+		report.resolved = report.entries.size() - report.failed;
+	}
+
+	/**
+	 * Resolves the classes on the calling thread, returning a task that resolves the members on the worker.
+	 * Attached threads can't find launcher classes, but can look up members of classes that are already cached.
+	 */
+	auto prepareWarmup() {
+		auto start = Clock::now();
+
+		jni::WarmupReport report{};
+		report.entries = planEntries();
+
+		auto env = jni::getEnv();
+		for (auto& entry : report.entries) {
+			if (entry.target.key().kind != jni::detail::EntryKind::Class) {
+				break;
+			}
+
+			if (env) {
+				resolveEntry(env.unwrap(), entry);
+			} else {
+				entry.error = env.unwrapErr();
+			}
+		}
+
+		report.blockingNanoseconds = elapsedSince(start);
+
+		return [report = std::move(report), start](JNIEnv* env) mutable -> geode::Result<jni::WarmupReport> {
+			for (auto& entry : report.entries) {
+				if (entry.target.key().kind != jni::detail::EntryKind::Class) {
+					resolveEntry(env, entry);
+				}
+			}
+
+			report.totalNanoseconds = elapsedSince(start);
+			countResults(report);
+
+			return geode::Ok(std::move(report));
+		};
+	}
+
+#ifndef LAUNCHER_UTILS_NO_AUTO_WARMUP
+	// queued from a static initializer, so it starts on the main thread once the mod has loaded,
+	// after every WarmupRegistrar has added its targets
+	const auto s_loadWarmup = (geode::Loader::get()->queueInMainThread([] {
+		(void)jni::warmUpAsync();
+	}), true);
+#endif
+
+	std::string_view kindName(jni::detail::EntryKind kind) {
+		switch (kind) {
+			case jni::detail::EntryKind::Class: return "class";
+			case jni::detail::EntryKind::StaticMethod: return "static method";
+			case jni::detail::EntryKind::Method: return "method";
+			case jni::detail::EntryKind::StaticField: return "static field";
+			case jni::detail::EntryKind::Field: return "field";
+		}
+
+		return "unknown";
+	}
+}
+
+void jni::addWarmupTargets(std::span<const WarmupTarget> targets) {
+	std::scoped_lock lock(s_targetsMutex);
+
+	auto& list = warmupTargets();
+	for (const auto& target : targets) {
+		auto listed = std::ranges::any_of(list, [&](const WarmupTarget& other) {
+			return other.key() == target.key();
+		});
+
+		if (!listed) {
+			list.push_back(target);
+		}
+	}
+}
+
+geode::Result<jni::WarmupReport> jni::warmUp() {
+	GEODE_UNWRAP_INTO(auto env, getEnv());
+
+	auto start = Clock::now();
+
+	WarmupReport report{};
+	report.entries = planEntries();
+
+	for (auto& entry : report.entries) {
+		resolveEntry(env, entry);
+	}
+
+	report.totalNanoseconds = elapsedSince(start);
+	report.blockingNanoseconds = report.totalNanoseconds;
+	countResults(report);
+
+	return geode::Ok(std::move(report));
+}
+
+jni::Future<geode::Result<jni::WarmupReport>> jni::warmUpAsync() {
+	return Executor::get().submit(prepareWarmup());
+}
+
+void jni::warmUpAsync(std::function<void(geode::Result<WarmupReport>)> onComplete) {
+	Executor::get().submit(prepareWarmup(), std::move(onComplete));
+}
+
+std::string jni::formatWarmupReport(const WarmupReport& report) {
+	auto r = fmt::format(
+		"warm-up: {} resolved, {} failed, total {:.3f}ms, blocking {:.3f}ms\n",
+		report.resolved, report.failed,
+		static_cast<double>(report.totalNanoseconds) / 1'000'000.0,
+		static_cast<double>(report.blockingNanoseconds) / 1'000'000.0
+	);
+
+	std::vector<const WarmupEntry*> entries{};
+	for (const auto& entry : report.entries) {
+		entries.push_back(&entry);
+	}
+
+	std::ranges::sort(entries, [](const WarmupEntry* a, const WarmupEntry* b) {
+		return a->nanoseconds > b->nanoseconds;
+	});
+
+	for (auto entry : entries) {
+		const auto& key = entry->target.key();
+
+		r += fmt::format(
+			"{} {}{}{}{}: {}ns",
+			kindName(key.kind), key.className, key.memberName.empty() ? "" : ".", key.memberName, key.paramSignature,
+			entry->nanoseconds
+		);
+
+		if (!entry->error.empty()) {
+			r += fmt::format(" ({})", entry->error);
+		}
+
+		r += '\n';
+	}
+
+	return r;
+}
@@ -0,0 +1,190 @@
+#include <Geode/Geode.hpp>
+#include <Geode/modify/MenuLayer.hpp>
+
+#include <launcher-utils/geode.hpp>
+#include <launcher-utils/trace.hpp>
+
+#include "base.hpp"
+#include "benchmarks.hpp"
+
+class BenchmarkTestLayer : public BaseTestLayer {
+	void onRun() {
+		auto report = runBenchmarks();
+
+		for (const auto& result : report.results) {
+			addLogLine(fmt::format("{}: {:.1f}ns (min {:.1f}ns)", result.name, result.medianNs, result.minNs));
+		}
+
+		for (const auto& note : report.notes) {
+			addLogLine(note);
+		}
+
+		auto json = report.toJson();
+		geode::log::info("benchmark results: {}", json);
+
+		auto path = geode::Mod::get()->getSaveDir() / "benchmark.json";
+		if (auto r = geode::utils::file::writeString(path, json); !r) {
+			addLogLine(fmt::format("failed to write results: {}", r.unwrapErr()));
+			return;
+		}
+
+		addLogLine(fmt::format("wrote {}", geode::utils::string::pathToString(path)));
+	}
+
+	void onCallStats() {
+		auto stats = launcher_utils::jni::formatCallStats(launcher_utils::jni::getCallStats());
+		geode::log::info("call stats:\n{}", stats);
+
+		for (const auto& line : geode::utils::string::split(stats, "\n")) {
+			addLogLine(line);
+		}
+	}
+
+	void onStartTrace() {
+		if (!launcher_utils::jni::isTracingAvailable()) {
+			addLogLine("trace: tracing is disabled (build with LAUNCHER_UTILS_TRACING)");
+			return;
+		}
+
+		launcher_utils::jni::startTracing();
+		this->scheduleUpdate();
+
+		addLogLine("trace: started");
+	}
+
+	void onStopTrace() {
+		if (!launcher_utils::jni::isTracing()) {
+			return;
+		}
+
+		launcher_utils::jni::stopTracing();
+		this->unscheduleUpdate();
+
+		auto stats = launcher_utils::jni::getTraceStats();
+		auto path = geode::Mod::get()->getSaveDir() / "trace.json";
+		if (auto r = geode::utils::file::writeString(path, launcher_utils::jni::getTraceJson()); !r) {
+			addLogLine(fmt::format("trace: failed to write: {}", r.unwrapErr()));
+			return;
+		}
+
+		addLogLine(fmt::format(
+			"trace: {} events on {} threads ({} dropped), wrote {}",
+			stats.events, stats.threads, stats.droppedEvents, geode::utils::string::pathToString(path)
+		));
+	}
+
+	virtual void update(float) override {
+		launcher_utils::jni::markTraceFrame();
+
+		// poll like a mod showing controller status every frame would
+		std::vector<int> devices{};
+		if (launcher_utils::getConnectedDevices(devices)) {
+			for (auto id : devices) {
+				if (auto device = launcher_utils::InputDevice::create(id)) {
+					(void)device.unwrap().getBatteryCapacity();
+				}
+			}
+		}
+	}
+
+	virtual void onExit() override {
+		onStopTrace();
+		BaseTestLayer::onExit();
+	}
+
+	virtual bool init() override {
+		if (!BaseTestLayer::init()) {
+			return false;
+		}
+
+		auto winSize = cocos2d::CCDirector::sharedDirector()->getWinSize();
+
+		auto testMenu = cocos2d::CCMenu::create();
+
+		auto runButton = geode::cocos::CCMenuItemExt::createSpriteExtra(
+			ButtonSprite::create("Run Benchmarks"),
+			[this](auto) {
+				onRun();
+			}
+		);
+		testMenu->addChild(runButton);
+
+		auto statsButton = geode::cocos::CCMenuItemExt::createSpriteExtra(
+			ButtonSprite::create("Call Stats"),
+			[this](auto) {
+				onCallStats();
+			}
+		);
+		testMenu->addChild(statsButton);
+
+		auto startTraceButton = geode::cocos::CCMenuItemExt::createSpriteExtra(
+			ButtonSprite::create("Start Trace"),
+			[this](auto) {
+				onStartTrace();
+			}
+		);
+		testMenu->addChild(startTraceButton);
+
+		auto stopTraceButton = geode::cocos::CCMenuItemExt::createSpriteExtra(
+			ButtonSprite::create("Stop Trace"),
+			[this](auto) {
+				onStopTrace();
+			}
+		);
+		testMenu->addChild(stopTraceButton);
+
+		testMenu->setLayout(
+			geode::SimpleColumnLayout::create()
+				->setGap(5.0f)
+		);
+		this->addChild(testMenu);
+		testMenu->setPosition(winSize/2);
+
+		return true;
+	}
+
+public:
+	static BenchmarkTestLayer* create() {
+		auto pRet = new BenchmarkTestLayer();
+		if (!pRet->init()) {
+			delete pRet;
+			return nullptr;
+		}
+
+		pRet->autorelease();
+		return pRet;
+	}
+};
+
+struct BenchmarkMenuLayer : geode::Modify<BenchmarkMenuLayer, MenuLayer> {
+	virtual bool init() override {
+		if (!MenuLayer::init()) {
+			return false;
+		}
+
+		auto benchmarkSprite = cocos2d::CCSprite::createWithSpriteFrameName("GJ_statsBtn_001.png");
+
+		auto benchmarkButton = CCMenuItemSpriteExtra::create(
+			benchmarkSprite,
+			this,
+			menu_selector(BenchmarkMenuLayer::onBenchmark)
+		);
+
+		auto menu = this->getChildByID("bottom-menu");
+		menu->addChild(benchmarkButton);
+
+		benchmarkButton->setID("benchmark-btn"_spr);
+		menu->updateLayout();
+
+		return true;
+	}
+
+	void onBenchmark(CCObject*) {
+		auto scene = cocos2d::CCScene::create();
+		scene->addChild(BenchmarkTestLayer::create());
+
+		cocos2d::CCDirector::sharedDirector()->pushScene(
+			cocos2d::CCTransitionFade::create(0.5f, scene)
+		);
+	}
+};
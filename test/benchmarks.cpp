@@ -0,0 +1,664 @@
+#include <launcher-utils/async.hpp>
+#include <launcher-utils/capabilities.hpp>
+#include <launcher-utils/devices.hpp>
+#include <launcher-utils/geode.hpp>
+#include <launcher-utils/haptics.hpp>
+#include <launcher-utils/scheduler.hpp>
+#include <launcher-utils/warmup.hpp>
+
+#include <fmt/format.h>
+
+#include "benchmarks.hpp"
+#include "fakejvm.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <numeric>
+
+#ifndef LAUNCHER_UTILS_COMMIT
+#define LAUNCHER_UTILS_COMMIT ""
+#endif
+
+namespace {
+	/**
+	 * Keeps the compiler from optimizing away a benchmarked value.
+	 */
+	template <typename T>
+	inline void doNotOptimize(const T& value) {
+		asm volatile("" : : "r,m"(value) : "memory");
+	}
+
+	class BenchmarkRunner {
+		static constexpr int s_batchCount = 7;
+
+		std::vector<BenchmarkResult> m_results{};
+
+	public:
+		/**
+		 * Runs the body `iterations` times per batch, and records the median and fastest batch in ns per call.
+		 */
+		template <typename F>
+		const BenchmarkResult& run(std::string_view name, std::uint64_t iterations, F&& body) {
+			for (std::uint64_t i = 0; i < iterations / 10; i++) {
+				body();
+			}
+
+			std::array<double, s_batchCount> times{};
+			for (auto& time : times) {
+				auto begin = std::chrono::steady_clock::now();
+				for (std::uint64_t i = 0; i < iterations; i++) {
+					body();
+				}
+				auto elapsed = std::chrono::steady_clock::now() - begin;
+
+				time = std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(iterations);
+			}
+
+			std::ranges::sort(times);
+
+			return m_results.emplace_back(BenchmarkResult{
+				std::string(name), iterations * s_batchCount, times[s_batchCount / 2], times[0]
+			});
+		}
+
+		std::vector<BenchmarkResult> takeResults() {
+			return std::move(m_results);
+		}
+	};
+
+	constexpr auto s_utilsClass = "com/geode/launcher/utils/GeodeUtils";
+	constexpr int s_deviceId = 7;
+
+	void setupDevices(fake_jvm::FakeJVM& vm) {
+		vm.installLauncherClasses();
+		vm.devices.push_back({
+			.id = s_deviceId,
+			.name = "Benchmark Controller",
+			.descriptor = "6a1f0d0c4e7b7d1c2a9e3f5b8c0d1e2f3a4b5c6d",
+			.vendorId = 0x054c,
+			.productId = 0x0ce6,
+			.sources = static_cast<int>(launcher_utils::InputDevice::Source::Gamepad),
+			.hasBattery = true,
+			.batteryCapacity = 0.5f,
+			.lightCount = 1,
+			.lightType = 1,
+			.motorCount = 2,
+			.motionRanges = {{
+				.axis = 0,
+				.source = static_cast<int>(launcher_utils::InputDevice::Source::Joystick),
+				.min = -1.0f,
+				.max = 1.0f,
+				.flat = 0.05f,
+				.fuzz = 0.01f,
+				.resolution = 0.0f
+			}}
+		});
+	}
+
+	void runCallBenchmarks(BenchmarkRunner& runner, JNIEnv* env) {
+		constexpr std::uint64_t iterations = 200'000;
+
+		auto cls = launcher_utils::jni::LocalRef(env->FindClass(s_utilsClass));
+		auto methodId = env->GetStaticMethodID(cls.get<jclass>(), "getDeviceLightsCount", "(I)I");
+
+		runner.run("call/raw", iterations, [&] {
+			doNotOptimize(env->CallStaticIntMethod(cls.get<jclass>(), methodId, s_deviceId));
+		});
+
+		runner.run("call/raw-jvalue", iterations, [&] {
+			jvalue args[1]{};
+			args[0].i = s_deviceId;
+			doNotOptimize(env->CallStaticIntMethodA(cls.get<jclass>(), methodId, args));
+		});
+
+		runner.run("call/raw+exception-check", iterations, [&] {
+			doNotOptimize(env->CallStaticIntMethod(cls.get<jclass>(), methodId, s_deviceId));
+			doNotOptimize(env->ExceptionCheck());
+		});
+
+		runner.run("call/runtime-strings", iterations, [&] {
+			doNotOptimize(launcher_utils::jni::callStaticMethod<int>(env, s_utilsClass, "getDeviceLightsCount", "(I)I", s_deviceId));
+		});
+
+		runner.run("call/template-strings", iterations, [&] {
+			doNotOptimize(launcher_utils::jni::callStaticMethod<int, "com/geode/launcher/utils/GeodeUtils", "getDeviceLightsCount", "(I)I">(env, s_deviceId));
+		});
+
+		static launcher_utils::jni::StaticMethodHandle s_handle{s_utilsClass, "getDeviceLightsCount", "(I)I"};
+		runner.run("call/handle", iterations, [&] {
+			doNotOptimize(s_handle.call<int>(env, s_deviceId));
+		});
+	}
+
+	void runLookupBenchmarks(BenchmarkRunner& runner, JNIEnv* env) {
+		constexpr std::uint64_t iterations = 500'000;
+
+		runner.run("lookup/cache-hit", iterations, [&] {
+			doNotOptimize(launcher_utils::jni::getStaticMethodInfo(env, s_utilsClass, "getDeviceLightsCount", "(I)I").isOk());
+		});
+
+		runner.run("lookup/class-cache-hit", iterations, [&] {
+			doNotOptimize(launcher_utils::jni::getClassId(env, s_utilsClass).isOk());
+		});
+
+		// misses are cached, so an API the launcher lacks doesn't pay for a lookup and an exception each call
+		runner.run("lookup/cached-miss", iterations, [&] {
+			doNotOptimize(launcher_utils::jni::getStaticMethodInfo(env, s_utilsClass, "missingMethod", "()V").isOk());
+		});
+
+		// a call-site handle keeps the miss itself, so it skips the cache lookup and doesn't copy the error
+		runner.run("lookup/handle-cached-miss", iterations, [&] {
+			static launcher_utils::jni::StaticMethodHandle s_handle{s_utilsClass, "missingMethod", "()V"};
+			doNotOptimize(s_handle.resolve(env).isOk());
+		});
+
+		runner.run("lookup/supports", iterations, [&] {
+			doNotOptimize(launcher_utils::supports(launcher_utils::Capability::DeviceLights));
+		});
+
+		// the method cache used to be keyed on a formatted string, kept to compare against
+		runner.run("lookup/fmt-key", iterations, [&] {
+			doNotOptimize(fmt::format("{}.{}{}", s_utilsClass, "getDeviceLightsCount", "(I)I"));
+		});
+	}
+
+	void runExceptionBenchmarks(BenchmarkRunner& runner, JNIEnv* env, fake_jvm::FakeJVM& vm) {
+		runner.run("exception/check-clear", 1'000'000, [&] {
+			doNotOptimize(launcher_utils::jni::checkForExceptions(env).isOk());
+		});
+
+		runner.run("exception/check-pending", 10'000, [&] {
+			vm.throwException("java/lang/RuntimeException", u"benchmark");
+			doNotOptimize(launcher_utils::jni::checkForExceptions(env).isOk());
+		});
+
+		// only captures the exception, for callers that don't read the message
+		runner.run("exception/capture-pending", 10'000, [&] {
+			vm.throwException("java/lang/RuntimeException", u"benchmark");
+			doNotOptimize(launcher_utils::jni::checkException(env).isOk());
+		});
+
+		// a throwing call whose error is discarded, like the geode.hpp getters that fall back to a default
+		runner.run("exception/call-discarded", 10'000, [&] {
+			vm.injectException("com/geode/launcher/utils/GeodeUtils", "getDeviceLightsCount", "benchmark");
+			doNotOptimize(launcher_utils::jni::invokeStaticMethod<jint(jint), "com/geode/launcher/utils/GeodeUtils", "getDeviceLightsCount">(env, s_deviceId).unwrapOrDefault());
+		});
+
+		runner.run("exception/call-formatted", 10'000, [&] {
+			vm.injectException("com/geode/launcher/utils/GeodeUtils", "getDeviceLightsCount", "benchmark");
+			doNotOptimize(launcher_utils::jni::callStaticMethod<jint(jint), "com/geode/launcher/utils/GeodeUtils", "getDeviceLightsCount">(env, s_deviceId).isOk());
+		});
+	}
+
+	void runReferenceBenchmarks(BenchmarkRunner& runner, JNIEnv* env) {
+		constexpr std::uint64_t iterations = 500'000;
+
+		auto str = launcher_utils::jni::LocalRef(env->NewStringUTF("reference"));
+
+		runner.run("ref/local", iterations, [&] {
+			auto ref = launcher_utils::jni::LocalRef(env->NewLocalRef(*str));
+			doNotOptimize(*ref);
+		});
+
+		runner.run("ref/global", iterations, [&] {
+			auto ref = launcher_utils::jni::GlobalRef(*str);
+			doNotOptimize(*ref);
+		});
+
+		runner.run("ref/local-frame", iterations, [&] {
+			auto frame = launcher_utils::jni::LocalFrame::push(env, 4);
+			auto ref = launcher_utils::jni::LocalRef::created(env->NewLocalRef(*str));
+			doNotOptimize(*ref);
+		});
+	}
+
+	void runArrayBenchmarks(BenchmarkRunner& runner, JNIEnv* env) {
+		for (std::size_t length : {16, 1024}) {
+			std::vector<jint> values(length);
+			std::iota(values.begin(), values.end(), 0);
+
+			auto array = launcher_utils::jni::toJavaArray(env, values);
+			auto iterations = length > 16 ? 50'000 : 500'000;
+
+			runner.run(fmt::format("array/extract-int[{}]", length), iterations, [&] {
+				doNotOptimize(launcher_utils::jni::extractArray(env, array.get<jintArray>()));
+			});
+
+			std::vector<jint> out{};
+			runner.run(fmt::format("array/extract-int-reuse[{}]", length), iterations, [&] {
+				doNotOptimize(launcher_utils::jni::extractArray<jint>(env, array.get<jintArray>(), out).isOk());
+			});
+
+			runner.run(fmt::format("array/to-java-int[{}]", length), iterations, [&] {
+				auto r = launcher_utils::jni::toJavaArray(env, values);
+				doNotOptimize(*r);
+			});
+		}
+	}
+
+	void runStringBenchmarks(BenchmarkRunner& runner, JNIEnv* env) {
+		struct TestString {
+			const char* name;
+			std::string value;
+		};
+
+		std::array strings = {
+			TestString{"ascii-16", std::string(16, 'a')},
+			TestString{"ascii-256", std::string(256, 'a')},
+			TestString{"utf8-64", [] {
+				std::string r{};
+				for (int i = 0; i < 16; i++) {
+					r += "ab\xc3\xa9\xe2\x82\xac";
+				}
+				return r;
+			}()},
+		};
+
+		for (const auto& [name, value] : strings) {
+			auto jstr = launcher_utils::jni::toJString(env, value).unwrap();
+
+			runner.run(fmt::format("string/to-string/{}", name), 200'000, [&] {
+				doNotOptimize(launcher_utils::jni::toString(env, jstr.get<jstring>()));
+			});
+
+			std::string out{};
+			runner.run(fmt::format("string/to-string-reuse/{}", name), 200'000, [&] {
+				doNotOptimize(launcher_utils::jni::toString(env, jstr.get<jstring>(), out).isOk());
+			});
+
+			runner.run(fmt::format("string/to-jstring/{}", name), 200'000, [&] {
+				doNotOptimize(launcher_utils::jni::toJString(env, value).isOk());
+			});
+
+			// a view isn't known to be null terminated, so it takes the copying path
+			runner.run(fmt::format("string/to-jstring-view/{}", name), 200'000, [&] {
+				doNotOptimize(launcher_utils::jni::toJString(env, std::string_view(value)).isOk());
+			});
+		}
+	}
+
+	void runFieldBenchmarks(BenchmarkRunner& runner, JNIEnv* env) {
+		constexpr std::uint64_t iterations = 100'000;
+
+		struct MotionRange {
+			jint axis;
+			jint source;
+			jfloat min;
+			jfloat max;
+			jfloat flat;
+			jfloat fuzz;
+			jfloat resolution;
+		};
+
+		using launcher_utils::jni::callMethod;
+		using launcher_utils::jni::Object;
+
+		auto device = launcher_utils::jni::callStaticMethod<Object<"android/view/InputDevice">(jint), "com/geode/launcher/utils/GeodeUtils", "getDevice">(
+			env, s_deviceId
+		);
+		auto range = callMethod<Object<"android/view/InputDevice$MotionRange">(jint), "android/view/InputDevice", "getMotionRange">(
+			env, device.unwrap().get(), 0
+		).unwrap();
+
+		// one call per value, as the platform class is meant to be used
+		runner.run("field/getters", iterations, [&] {
+			MotionRange r{};
+			r.axis = callMethod<jint(), "android/view/InputDevice$MotionRange", "getAxis">(env, range.get()).unwrapOrDefault();
+			r.source = callMethod<jint(), "android/view/InputDevice$MotionRange", "getSource">(env, range.get()).unwrapOrDefault();
+			r.min = callMethod<jfloat(), "android/view/InputDevice$MotionRange", "getMin">(env, range.get()).unwrapOrDefault();
+			r.max = callMethod<jfloat(), "android/view/InputDevice$MotionRange", "getMax">(env, range.get()).unwrapOrDefault();
+			r.flat = callMethod<jfloat(), "android/view/InputDevice$MotionRange", "getFlat">(env, range.get()).unwrapOrDefault();
+			r.fuzz = callMethod<jfloat(), "android/view/InputDevice$MotionRange", "getFuzz">(env, range.get()).unwrapOrDefault();
+			r.resolution = callMethod<jfloat(), "android/view/InputDevice$MotionRange", "getResolution">(env, range.get()).unwrapOrDefault();
+			doNotOptimize(r);
+		});
+
+		runner.run("field/get-field", iterations, [&] {
+			using launcher_utils::jni::getField;
+
+			MotionRange r{};
+			r.axis = getField<jint, "android/view/InputDevice$MotionRange", "mAxis">(env, range.get()).unwrapOrDefault();
+			r.source = getField<jint, "android/view/InputDevice$MotionRange", "mSource">(env, range.get()).unwrapOrDefault();
+			r.min = getField<jfloat, "android/view/InputDevice$MotionRange", "mMin">(env, range.get()).unwrapOrDefault();
+			r.max = getField<jfloat, "android/view/InputDevice$MotionRange", "mMax">(env, range.get()).unwrapOrDefault();
+			r.flat = getField<jfloat, "android/view/InputDevice$MotionRange", "mFlat">(env, range.get()).unwrapOrDefault();
+			r.fuzz = getField<jfloat, "android/view/InputDevice$MotionRange", "mFuzz">(env, range.get()).unwrapOrDefault();
+			r.resolution = getField<jfloat, "android/view/InputDevice$MotionRange", "mResolution">(env, range.get()).unwrapOrDefault();
+			doNotOptimize(r);
+		});
+
+		static launcher_utils::jni::StructMapper s_mapper{
+			"android/view/InputDevice$MotionRange",
+			launcher_utils::jni::field<"mAxis">(&MotionRange::axis),
+			launcher_utils::jni::field<"mSource">(&MotionRange::source),
+			launcher_utils::jni::field<"mMin">(&MotionRange::min),
+			launcher_utils::jni::field<"mMax">(&MotionRange::max),
+			launcher_utils::jni::field<"mFlat">(&MotionRange::flat),
+			launcher_utils::jni::field<"mFuzz">(&MotionRange::fuzz),
+			launcher_utils::jni::field<"mResolution">(&MotionRange::resolution)
+		};
+
+		runner.run("field/struct-mapper", iterations, [&] {
+			MotionRange r{};
+			doNotOptimize(s_mapper.read(env, range.get(), r).isOk());
+			doNotOptimize(r);
+		});
+	}
+
+	void runExecutorBenchmarks(BenchmarkRunner& runner, fake_jvm::FakeJVM& vm) {
+		constexpr std::uint64_t iterations = 100'000;
+
+		auto& executor = launcher_utils::jni::Executor::get();
+
+		// cost to the calling thread, which is what the main thread pays per call
+		runner.run("executor/sync-vibrate", iterations, [&] {
+			doNotOptimize(launcher_utils::vibrate(1).isOk());
+		});
+
+		runner.run("executor/async-vibrate", iterations, [&] {
+			doNotOptimize(launcher_utils::vibrateAsync(1).valid());
+		});
+
+		executor.drain();
+
+		runner.run("executor/round-trip", iterations / 10, [&] {
+			doNotOptimize(launcher_utils::vibrateAsync(1).get().isOk());
+		});
+
+		// the fake call returns immediately, while the real one goes through the vibrator service
+		constexpr auto serviceLatency = std::chrono::microseconds(50);
+		vm.setLatency(s_utilsClass, "vibrate", serviceLatency);
+
+		runner.run("executor/sync-vibrate-50us", 200, [&] {
+			doNotOptimize(launcher_utils::vibrate(1).isOk());
+		});
+
+		runner.run("executor/async-vibrate-50us", 200, [&] {
+			doNotOptimize(launcher_utils::vibrateAsync(1).valid());
+		});
+
+		executor.drain();
+		vm.setLatency(s_utilsClass, "vibrate", {});
+	}
+
+	launcher_utils::AsyncTask<int> awaitResult(int value) {
+		auto x = co_await geode::Result<int>(geode::Ok(value));
+		co_return geode::Ok(x + 1);
+	}
+
+	launcher_utils::AsyncTask<int> awaitTasks(int value) {
+		auto x = co_await awaitResult(value);
+		auto y = co_await awaitResult(x);
+		co_return geode::Ok(y);
+	}
+
+	void runCoroutineBenchmarks(BenchmarkRunner& runner) {
+		constexpr std::uint64_t iterations = 1'000'000;
+
+		// after the first iteration every frame comes from the pool
+		runner.run("coro/await-result", iterations, [&] {
+			doNotOptimize(awaitResult(1).result().unwrapOr(0));
+		});
+
+		runner.run("coro/await-task", iterations, [&] {
+			doNotOptimize(awaitTasks(1).result().unwrapOr(0));
+		});
+	}
+
+	void runHapticsBenchmarks(BenchmarkRunner& runner, fake_jvm::FakeJVM& vm) {
+		constexpr std::uint64_t iterations = 200;
+		constexpr int requestsPerFrame = 10;
+
+		auto device = launcher_utils::InputDevice::create(s_deviceId).unwrap();
+		auto& haptics = launcher_utils::HapticsScheduler::get();
+
+		vm.setLatency(s_utilsClass, "vibrateDevice", std::chrono::microseconds(50));
+
+		// a frame with a hit effect for every collision
+		runner.run("haptics/direct-x10", iterations, [&] {
+			for (int i = 0; i < requestsPerFrame; i++) {
+				doNotOptimize(device.vibrateDevice(20 + i, 100, 0).isOk());
+			}
+		});
+
+		haptics.setMaxCallRate(0);
+
+		runner.run("haptics/scheduled-x10", iterations, [&] {
+			for (int i = 0; i < requestsPerFrame; i++) {
+				haptics.vibrateDevice(s_deviceId, 20 + i, 100, 0);
+			}
+
+			haptics.flush();
+		});
+
+		launcher_utils::jni::Executor::get().drain();
+		vm.setLatency(s_utilsClass, "vibrateDevice", {});
+
+		haptics.setMaxCallRate(20);
+		haptics.forget(s_deviceId);
+	}
+
+	void runFrameSchedulerBenchmarks(BenchmarkRunner& runner, fake_jvm::FakeJVM& vm) {
+		constexpr std::uint64_t iterations = 200;
+		constexpr int queriesPerRefresh = 20;
+
+		auto device = launcher_utils::InputDevice::create(s_deviceId).unwrap();
+		auto& scheduler = launcher_utils::jni::FrameScheduler::get();
+
+		vm.setLatency(s_utilsClass, "getDeviceBatteryCapacity", std::chrono::microseconds(50));
+
+		// a settings page refreshing every controller's battery at once
+		runner.run("frame-scheduler/direct-x20", iterations, [&] {
+			for (int i = 0; i < queriesPerRefresh; i++) {
+				doNotOptimize(device.getBatteryCapacity());
+			}
+		});
+
+		scheduler.resetStats();
+
+		// measures a frame: the refresh is spread over as many frames as the budget needs
+		runner.run("frame-scheduler/frame", iterations, [&] {
+			if (scheduler.stats().queueDepth == 0) {
+				for (int i = 0; i < queriesPerRefresh; i++) {
+					scheduler.submit([](JNIEnv* env) {
+						doNotOptimize(launcher_utils::jni::callStaticMethod<jfloat(jint), "com/geode/launcher/utils/GeodeUtils", "getDeviceBatteryCapacity">(env, s_deviceId).isOk());
+					});
+				}
+			}
+
+			scheduler.runFrame();
+		});
+
+		while (scheduler.stats().queueDepth != 0) {
+			scheduler.runFrame();
+		}
+
+		vm.setLatency(s_utilsClass, "getDeviceBatteryCapacity", {});
+	}
+
+	void runDeviceBenchmarks(BenchmarkRunner& runner) {
+		constexpr std::uint64_t iterations = 100'000;
+
+		runner.run("device/create", iterations, [&] {
+			doNotOptimize(launcher_utils::InputDevice::create(s_deviceId).isOk());
+		});
+
+		auto device = launcher_utils::InputDevice::create(s_deviceId).unwrap();
+
+		runner.run("device/get-name", iterations, [&] {
+			doNotOptimize(device.getName());
+		});
+
+		runner.run("device/get-vendor-id", iterations, [&] {
+			doNotOptimize(device.getVendorId());
+		});
+
+		runner.run("device/get-battery-capacity", iterations, [&] {
+			doNotOptimize(device.getBatteryCapacity());
+		});
+
+		runner.run("device/snapshot-fetch", iterations / 10, [&] {
+			device.invalidateSnapshot();
+			doNotOptimize(device.snapshot().vendorId);
+		});
+
+		runner.run("device/snapshot-cached", iterations, [&] {
+			doNotOptimize(device.snapshot().vendorId);
+		});
+
+		// listing the controllers, like a mod showing their status every frame would
+		runner.run("device/poll-connected", iterations / 10, [&] {
+			std::vector<int> ids{};
+			if (launcher_utils::getConnectedDevices(ids)) {
+				for (auto id : ids) {
+					if (auto connected = launcher_utils::InputDevice::create(id)) {
+						doNotOptimize(connected.unwrap().snapshot().vendorId);
+					}
+				}
+			}
+		});
+
+		auto& registry = launcher_utils::DeviceRegistry::get();
+		registry.clear();
+
+		runner.run("device/registry", iterations, [&] {
+			for (auto& connected : registry.devices()) {
+				doNotOptimize(connected.snapshot().vendorId);
+			}
+		});
+
+		registry.clear();
+	}
+
+	/**
+	 * Times the first launcher call on a fresh VM, whose ID cache starts out empty like right after loading.
+	 */
+	std::uint64_t timeFirstCall(launcher_utils::jni::WarmupReport* report) {
+		fake_jvm::FakeJVM vm{};
+		setupDevices(vm);
+		vm.install();
+
+		if (report) {
+			*report = launcher_utils::jni::warmUp().unwrapOrDefault();
+		}
+
+		auto begin = std::chrono::steady_clock::now();
+		doNotOptimize(launcher_utils::getConnectedControllerCount().isOk());
+		auto elapsed = std::chrono::steady_clock::now() - begin;
+
+		vm.uninstall();
+
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+	}
+}
+
+
+BenchmarkReport runBenchmarks() {
+	BenchmarkRunner runner{};
+	launcher_utils::jni::ExecutorStats executorStats{};
+
+	{
+		fake_jvm::FakeJVM vm{};
+		setupDevices(vm);
+		vm.install();
+
+		auto env = launcher_utils::jni::getEnv().unwrap();
+
+		runCallBenchmarks(runner, env);
+		runLookupBenchmarks(runner, env);
+		runExceptionBenchmarks(runner, env, vm);
+		runReferenceBenchmarks(runner, env);
+		runArrayBenchmarks(runner, env);
+		runStringBenchmarks(runner, env);
+		runFieldBenchmarks(runner, env);
+		runDeviceBenchmarks(runner);
+		runCoroutineBenchmarks(runner);
+
+		launcher_utils::jni::Executor::get().resetStats();
+		runExecutorBenchmarks(runner, vm);
+		runHapticsBenchmarks(runner, vm);
+		runFrameSchedulerBenchmarks(runner, vm);
+
+		// the worker is attached to the fake JVM, so it has to stop before the VM goes away
+		launcher_utils::jni::Executor::get().shutdown();
+		executorStats = launcher_utils::jni::Executor::get().stats();
+
+		vm.uninstall();
+	}
+
+	launcher_utils::jni::WarmupReport warmup{};
+	auto coldCall = timeFirstCall(nullptr);
+	auto warmCall = timeFirstCall(&warmup);
+
+	BenchmarkReport report{};
+	report.results = runner.takeResults();
+
+	if (executorStats.completed > 0) {
+		report.notes.push_back(fmt::format(
+			"executor: {} tasks, max queue depth {}, mean wait {}ns (max {}ns), mean run {}ns (max {}ns)",
+			executorStats.completed, executorStats.maxQueueDepth,
+			executorStats.totalWaitNanoseconds / executorStats.completed, executorStats.maxWaitNanoseconds,
+			executorStats.totalRunNanoseconds / executorStats.completed, executorStats.maxRunNanoseconds
+		));
+	}
+
+	auto haptics = launcher_utils::HapticsScheduler::get().stats();
+	report.notes.push_back(fmt::format(
+		"haptics: {} requests, {} calls, {} rate limited, {} failed",
+		haptics.requests, haptics.calls, haptics.rateLimited, haptics.failedCalls
+	));
+
+	auto scheduler = launcher_utils::jni::FrameScheduler::get().stats();
+	if (scheduler.frames > 0) {
+		report.notes.push_back(fmt::format(
+			"frame scheduler: {} tasks over {} frames, {} deferred (max {} in a frame), {} oversized, {} over budget, max frame {}ns",
+			scheduler.tasksRun, scheduler.frames, scheduler.tasksDeferred, scheduler.maxDeferredInFrame,
+			scheduler.oversizedRuns, scheduler.framesOverBudget, scheduler.maxFrameNanoseconds
+		));
+	}
+
+	report.notes.push_back(fmt::format(
+		"warm-up: {} entries in {}ns ({} failed); first call {}ns cold, {}ns warmed up",
+		warmup.entries.size(), warmup.totalNanoseconds, warmup.failed, coldCall, warmCall
+	));
+
+	auto frames = launcher_utils::getFramePoolStats();
+	report.notes.push_back(fmt::format("coroutine frames: {} allocated, {} reused", frames.allocations, frames.reused));
+
+	return report;
+}
+
+std::string BenchmarkReport::toJson() const {
+	auto escape = [](std::string_view str) {
+		std::string r{};
+		for (auto c : str) {
+			if (c == '"' || c == '\\') {
+				r += '\\';
+			}
+			r += c;
+		}
+		return r;
+	};
+
+	std::string entries{};
+	for (const auto& result : results) {
+		if (!entries.empty()) {
+			entries += ',';
+		}
+
+		entries += fmt::format(
+			R"({{"name":"{}","iterations":{},"median_ns":{},"min_ns":{}}})",
+			escape(result.name), result.iterations, result.medianNs, result.minNs
+		);
+	}
+
+	auto timestamp = std::chrono::duration_cast<std::chrono::seconds>(
+		std::chrono::system_clock::now().time_since_epoch()
+	).count();
+
+	return fmt::format(
+		R"({{"commit":"{}","timestamp":{},"backend":"fake-jvm","unit":"ns/op","results":[{}]}})",
+		escape(LAUNCHER_UTILS_COMMIT), timestamp, entries
+	);
+}
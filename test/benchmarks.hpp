@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct BenchmarkResult {
+	std::string name;
+	std::uint64_t iterations;
+	double medianNs;
+	double minNs;
+};
+
+struct BenchmarkReport {
+	std::vector<BenchmarkResult> results{};
+
+	/** Summary lines for the executor, schedulers, warm-up and coroutine pools. */
+	std::vector<std::string> notes{};
+
+	/**
+	 * Results as JSON, tagged with the commit they were built from so runs can be compared between commits.
+	 */
+	std::string toJson() const;
+};
+
+/**
+ * Runs the call layer microbenchmark suite against a fake JVM, which is installed for the duration.
+ * Shared by the test mod's benchmark layer and the host benchmark executable.
+ */
+BenchmarkReport runBenchmarks();
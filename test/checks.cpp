@@ -0,0 +1,713 @@
+#include <Geode/utils/AndroidEvent.hpp>
+#include <launcher-utils/async.hpp>
+#include <launcher-utils/battery.hpp>
+#include <launcher-utils/capabilities.hpp>
+#include <launcher-utils/devices.hpp>
+#include <launcher-utils/geode.hpp>
+#include <launcher-utils/haptics.hpp>
+#include <launcher-utils/scheduler.hpp>
+#include <launcher-utils/trace.hpp>
+#include <launcher-utils/warmup.hpp>
+
+#include "checks.hpp"
+
+#include <Geode/utils/string.hpp>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <barrier>
+#include <chrono>
+#include <random>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+	// generated signatures must match what the launcher's methods are declared with
+	static_assert(launcher_utils::jni::signatureOf<bool(jint, jlong, jint, jint)> == "(IJII)Z");
+	static_assert(launcher_utils::jni::signatureOf<void(std::vector<jlong>, jint)> == "([JI)V");
+	static_assert(launcher_utils::jni::signatureOf<std::string()> == "()Ljava/lang/String;");
+	static_assert(launcher_utils::jni::signatureOf<launcher_utils::jni::Object<"android/view/InputDevice">(jint)> == "(I)Landroid/view/InputDevice;");
+	static_assert(launcher_utils::jni::signatureOf<std::vector<std::vector<launcher_utils::jni::Object<"java/lang/String">>>()> == "()[[Ljava/lang/String;");
+
+	constexpr auto s_utilsClass = "com/geode/launcher/utils/GeodeUtils";
+
+	/**
+	 * Passed to every check. Failures are reported with the name of the check they came from.
+	 */
+	struct CheckContext {
+		fake_jvm::FakeJVM& vm;
+		std::vector<std::string> failures{};
+		std::string_view check{};
+
+		void expect(bool condition, std::string_view what) {
+			if (!condition) {
+				failures.push_back(std::string(check) + ": " + std::string(what));
+			}
+		}
+	};
+
+	launcher_utils::AsyncTask<int> nextDeviceId(geode::Result<int> id) {
+		auto value = co_await std::move(id);
+		co_return geode::Ok(value + 1);
+	}
+
+	launcher_utils::AsyncTask<int> sumNextDeviceIds(geode::Result<int> a, geode::Result<int> b) {
+		auto x = co_await nextDeviceId(std::move(a));
+		auto y = co_await nextDeviceId(std::move(b));
+		co_return geode::Ok(x + y);
+	}
+
+	void checkDevices(CheckContext& ctx) {
+		ctx.expect(launcher_utils::getConnectedControllerCount().unwrapOrDefault() == 1, "controller count");
+		ctx.expect(launcher_utils::getConnectedDevices().unwrapOrDefault() == std::vector<int>{7}, "device ids");
+		ctx.expect(launcher_utils::vibrate(25).isOk() && ctx.vm.lastVibrationMs == 25, "vibrate");
+	}
+
+	void checkStrings(CheckContext& ctx) {
+		auto env = launcher_utils::jni::getEnv().unwrap();
+
+		// longer than the stack buffer, and cut out of a longer string so the view isn't null terminated
+		std::string text(600, 'a');
+		std::string_view view(text.data(), 400);
+
+		auto fromView = launcher_utils::jni::toJString(env, view);
+		auto fromString = launcher_utils::jni::toJString(env, text);
+		ctx.expect(
+			fromView.isOk() && fromString.isOk()
+				&& launcher_utils::jni::toString(env, fromView.unwrap().get<jstring>()).unwrapOrDefault() == view
+				&& launcher_utils::jni::toString(env, fromString.unwrap().get<jstring>()).unwrapOrDefault() == text,
+			"long ascii strings"
+		);
+	}
+
+	/**
+	 * The UTF-8 to jstring conversion used before the ASCII fast path, kept for comparison.
+	 */
+	geode::Result<launcher_utils::jni::LocalRef> toJStringReference(JNIEnv* env, std::string_view string) {
+		GEODE_UNWRAP_INTO(auto wString, geode::utils::string::utf8ToUtf16(string));
+
+		auto jString = env->NewString(reinterpret_cast<const jchar*>(wString.data()), wString.size());
+		if (!jString) {
+			return geode::Err("NewString returned null");
+		}
+
+		return geode::Ok(launcher_utils::jni::LocalRef(jString));
+	}
+
+	std::u16string readJString(JNIEnv* env, jstring string) {
+		std::u16string r(env->GetStringLength(string), u'\0');
+		env->GetStringRegion(string, 0, static_cast<jsize>(r.size()), reinterpret_cast<jchar*>(r.data()));
+
+		return r;
+	}
+
+	/**
+	 * Builds a random byte string from ASCII, NULs, valid multibyte sequences (including surrogate pairs),
+	 * encoded surrogates, truncated sequences and stray continuation bytes.
+	 */
+	std::string makeFuzzString(std::mt19937& rng) {
+		static constexpr std::array<std::string_view, 10> fragments = {
+			"a", "Z", std::string_view("\0", 1), "\xc3\xa9", "\xe2\x82\xac", "\xf0\x9f\x98\x80",
+			"\xed\xa0\x80", "\xe2\x82", "\x80", "\xff"
+		};
+
+		std::uniform_int_distribution<std::size_t> lengthDist{0, 300};
+		std::uniform_int_distribution<std::size_t> fragmentDist{0, fragments.size() - 1};
+		std::uniform_int_distribution<int> modeDist{0, 3};
+
+		// most strings are ASCII only, to exercise the fast paths
+		auto asciiOnly = modeDist(rng) != 0;
+
+		std::string r{};
+		auto length = lengthDist(rng);
+		while (r.size() < length) {
+			auto fragment = fragments[fragmentDist(rng)];
+			if (asciiOnly && static_cast<unsigned char>(fragment[0]) >= 0x80) {
+				continue;
+			}
+
+			r += fragment;
+		}
+
+		return r;
+	}
+
+	void checkStringFuzz(CheckContext& ctx) {
+		// fixed, so a failure can be reproduced
+		constexpr std::uint32_t seed = 0x6c75;
+		constexpr int iterations = 5'000;
+
+		auto env = launcher_utils::jni::getEnv().unwrap();
+		std::mt19937 rng{seed};
+
+		int mismatches = 0;
+		for (int i = 0; i < iterations; i++) {
+			auto str = makeFuzzString(rng);
+
+			auto reference = toJStringReference(env, str);
+			auto result = launcher_utils::jni::toJString(env, str);
+
+			if (reference.isOk() != result.isOk()) {
+				mismatches++;
+				continue;
+			}
+
+			if (reference.isErr()) {
+				continue;
+			}
+
+			if (readJString(env, reference.unwrap().get<jstring>()) != readJString(env, result.unwrap().get<jstring>())) {
+				mismatches++;
+			}
+		}
+
+		ctx.expect(mismatches == 0, fmt::format("{} of {} strings mismatched (seed {:#x})", mismatches, iterations, seed));
+	}
+
+	void checkBatteryMonitor(CheckContext& ctx) {
+		auto& monitor = launcher_utils::BatteryMonitor::get();
+		monitor.setTTL({});
+
+		int notifications = 0;
+		auto listener = monitor.addListener([&](int, const launcher_utils::BatteryState&) {
+			notifications++;
+		});
+
+		ctx.vm.injectException(s_utilsClass, "deviceHasBattery", "unavailable");
+		auto failed = monitor.getState(7);
+
+		auto first = monitor.getState(7);
+		ctx.vm.devices[0].batteryCapacity = 0.5f;
+		auto changed = monitor.getState(7);
+
+		ctx.vm.injectException(s_utilsClass, "getDeviceBatteryCapacity", "unavailable");
+		auto kept = monitor.getState(7);
+
+		ctx.expect(failed.isErr() && failed.unwrapErr() == "unavailable", "error propagated");
+		ctx.expect(first.isOk() && first.unwrap().capacity == 0.75f, "first fetch");
+		ctx.expect(changed.isOk() && changed.unwrap().capacity == 0.5f && notifications == 1, "change notified");
+		ctx.expect(kept.isOk() && kept.unwrap().capacity == 0.5f && notifications == 1, "kept on error");
+
+		monitor.removeListener(listener);
+		monitor.forget(7);
+		monitor.setTTL(std::chrono::seconds(30));
+		ctx.vm.devices[0].batteryCapacity = 0.75f;
+	}
+
+	void checkThreadAttachment(CheckContext& ctx) {
+		auto before = launcher_utils::jni::getAttachStats();
+		std::thread([] {
+			(void)launcher_utils::jni::detail::attachCurrentThread();
+		}).join();
+
+		auto after = launcher_utils::jni::getAttachStats();
+		ctx.expect(after.attached == before.attached + 1 && after.detached == before.detached + 1, "detached on exit");
+	}
+
+	void checkInputDevice(CheckContext& ctx) {
+		auto device = launcher_utils::InputDevice::create(7);
+		ctx.expect(device.isOk(), "create");
+
+		if (device) {
+			auto& info = device.unwrap().snapshot();
+			ctx.expect(info.name == "Fake Controller" && info.vendorId == 0x054c && info.motorCount == 2, "snapshot");
+			ctx.expect(device.unwrap().getBatteryCapacity() == 0.75f, "battery");
+			ctx.expect(device.unwrap().vibrateDevice(100, 128, 1).isOk() && ctx.vm.devices[0].lastVibrationMotor == 1, "vibrate");
+
+			// a reconfigured device is fetched again, rather than read from the object fetched before the change
+			auto fetches = ctx.vm.callCount(s_utilsClass, "getDevice");
+			ctx.vm.devices[0].name = "Renamed Controller";
+			geode::AndroidInputDeviceEvent(7, geode::AndroidInputDeviceEvent::Status::Changed).post();
+
+			auto& changed = device.unwrap().snapshot();
+			ctx.expect(
+				changed.name == "Renamed Controller" && ctx.vm.callCount(s_utilsClass, "getDevice") == fetches + 1,
+				"refetched on change"
+			);
+
+			ctx.vm.devices[0].name = "Fake Controller";
+		}
+	}
+
+	void checkFields(CheckContext& ctx) {
+		struct MotionRange {
+			int axis;
+			float min;
+			float max;
+			float flat;
+		};
+
+		static launcher_utils::jni::StructMapper s_rangeMapper{
+			"android/view/InputDevice$MotionRange",
+			launcher_utils::jni::field<"mAxis">(&MotionRange::axis),
+			launcher_utils::jni::field<"mMin">(&MotionRange::min),
+			launcher_utils::jni::field<"mMax">(&MotionRange::max),
+			launcher_utils::jni::field<"mFlat">(&MotionRange::flat)
+		};
+
+		using launcher_utils::jni::Object;
+
+		auto env = launcher_utils::jni::getEnv().unwrap();
+		auto device = launcher_utils::jni::callStaticMethod<Object<"android/view/InputDevice">(jint), "com/geode/launcher/utils/GeodeUtils", "getDevice">(env, 7);
+		ctx.expect(device.isOk(), "get device");
+
+		if (device) {
+			auto range = launcher_utils::jni::callMethod<Object<"android/view/InputDevice$MotionRange">(jint), "android/view/InputDevice", "getMotionRange">(
+				env, device.unwrap().get(), 1
+			);
+			ctx.expect(range.isOk(), "motion range");
+
+			if (range) {
+				auto mapped = s_rangeMapper.read(env, range.unwrap().get());
+				ctx.expect(mapped.isOk() && mapped.unwrap().axis == 1 && mapped.unwrap().max == 1.0f && mapped.unwrap().flat == 0.05f, "struct mapper");
+
+				auto written = launcher_utils::jni::setField<jfloat, "android/view/InputDevice$MotionRange", "mFlat">(env, range.unwrap().get(), 0.25f);
+				auto flat = launcher_utils::jni::callMethod<jfloat(), "android/view/InputDevice$MotionRange", "getFlat">(env, range.unwrap().get());
+				ctx.expect(written.isOk() && flat.unwrapOrDefault() == 0.25f, "set field");
+			}
+		}
+
+		auto missing = launcher_utils::jni::getStaticField<jint, "android/view/InputDevice", "SOURCE_MISSING">(env);
+		ctx.expect(missing.isErr() && !env->ExceptionCheck(), "missing field");
+
+		// the miss is cached, so looking it up again doesn't throw
+		auto thrown = ctx.vm.refStats().exceptionsThrown;
+		missing = launcher_utils::jni::getStaticField<jint, "android/view/InputDevice", "SOURCE_MISSING">(env);
+		ctx.expect(missing.isErr() && ctx.vm.refStats().exceptionsThrown == thrown, "missing field cached");
+	}
+
+	void checkMethodLookups(CheckContext& ctx) {
+		auto env = launcher_utils::jni::getEnv().unwrap();
+
+		// the handle keeps the miss, and its error refers to the cached message
+		static launcher_utils::jni::StaticMethodHandle s_missingMethod{"com/geode/launcher/utils/GeodeUtils", "missingMethod", "()V"};
+		auto first = s_missingMethod.resolve(env);
+		auto second = s_missingMethod.resolve(env);
+		ctx.expect(
+			first.isErr() && second.isErr() && !second.unwrapErr().exception()
+				&& second.unwrapErr().message() == "Failed to find static method com/geode/launcher/utils/GeodeUtils.missingMethod()V",
+			"missing method kept in handle"
+		);
+
+		// runtime signatures are checked before the arguments are packed, against the types parsed at lookup
+		static_assert(launcher_utils::jni::detail::packParameterKinds("(IJ[ILjava/lang/String;)V") == launcher_utils::jni::detail::packArgumentKinds<jint, jlong, jintArray, jstring>());
+		static_assert(launcher_utils::jni::detail::packParameterKinds("(I)V") != launcher_utils::jni::detail::packArgumentKinds<jint, jint>());
+		auto lights = ctx.vm.callCount(s_utilsClass, "getDeviceLightsCount");
+		auto mismatched = launcher_utils::jni::callStaticMethod<int>(env, s_utilsClass, "getDeviceLightsCount", "(I)I", jlong{7});
+		auto matched = launcher_utils::jni::callStaticMethod<int>(env, s_utilsClass, "getDeviceLightsCount", "(I)I", jint{7});
+		ctx.expect(
+			mismatched.isErr() && matched.isOk() && ctx.vm.callCount(s_utilsClass, "getDeviceLightsCount") == lights + 1,
+			"runtime signature checked"
+		);
+	}
+
+	void checkConcurrentLookups(CheckContext& ctx) {
+		struct Lookup {
+			const char* className;
+			const char* methodName;
+			const char* signature;
+			bool isStatic;
+		};
+
+		static constexpr std::array s_lookups{
+			Lookup{"com/geode/launcher/utils/GeodeUtils", "getDevice", "(I)Landroid/view/InputDevice;", true},
+			Lookup{"com/geode/launcher/utils/GeodeUtils", "getDeviceBatteryCapacity", "(I)F", true},
+			Lookup{"com/geode/launcher/utils/GeodeUtils", "getDeviceHapticsCount", "(I)I", true},
+			Lookup{"com/geode/launcher/utils/GeodeUtils", "vibrateDevice", "(IJII)Z", true},
+			Lookup{"com/geode/launcher/utils/GeodeUtils", "controllersConnected", "()I", true},
+			Lookup{"android/view/InputDevice", "getName", "()Ljava/lang/String;", false},
+			Lookup{"android/view/InputDevice", "getSources", "()I", false},
+			Lookup{"android/view/InputDevice", "getMotionRange", "(I)Landroid/view/InputDevice$MotionRange;", false},
+			Lookup{"java/lang/Throwable", "getMessage", "()Ljava/lang/String;", false},
+		};
+
+		auto lookup = [](JNIEnv* env, const Lookup& method) -> launcher_utils::jni::MethodInfo* {
+			auto res = method.isStatic
+				? launcher_utils::jni::getStaticMethodInfo(env, method.className, method.methodName, method.signature)
+				: launcher_utils::jni::getMethodInfo(env, method.className, method.methodName, method.signature);
+
+			return res ? &res.unwrap() : nullptr;
+		};
+
+		constexpr int threadCount = 8;
+		constexpr int rounds = 2'000;
+
+		// installing the VM again starts with an empty cache, so every thread misses on the same keys at the same time
+		ctx.vm.install();
+
+		std::vector<std::vector<launcher_utils::jni::MethodInfo*>> results(threadCount);
+		std::atomic_int mismatches{0};
+		std::barrier start(threadCount);
+
+		std::vector<std::thread> threads{};
+		for (int i = 0; i < threadCount; i++) {
+			threads.emplace_back([&, i] {
+				auto env = ctx.vm.attachCurrentThread();
+				start.arrive_and_wait();
+
+				auto& found = results[i];
+				for (const auto& method : s_lookups) {
+					found.push_back(lookup(env, method));
+				}
+
+				for (int round = 0; round < rounds; round++) {
+					auto idx = static_cast<std::size_t>(round + i) % s_lookups.size();
+					if (lookup(env, s_lookups[idx]) != found[idx]) {
+						mismatches++;
+					}
+				}
+
+				ctx.vm.detachCurrentThread();
+			});
+		}
+
+		for (auto& thread : threads) {
+			thread.join();
+		}
+
+		auto agreed = std::ranges::all_of(results, [&](const auto& found) {
+			return found == results.front();
+		});
+
+		ctx.expect(std::ranges::find(results.front(), nullptr) == results.front().end(), "all resolved");
+		ctx.expect(mismatches == 0 && agreed, "same entry on every thread");
+	}
+
+	void checkLocalFrames(CheckContext& ctx) {
+		auto env = launcher_utils::jni::getEnv().unwrap();
+
+		// a reference adopted inside a frame may be older than the frame, so it is still deleted on its own
+		auto live = ctx.vm.refStats().liveLocalRefs;
+		auto outside = env->NewStringUTF("outside");
+		auto deletedInFrame = false;
+		{
+			auto frame = launcher_utils::jni::LocalFrame::push(env, 4);
+			auto deleted = ctx.vm.refStats().localRefsDeleted;
+			{
+				auto adopted = launcher_utils::jni::LocalRef(outside);
+				auto created = launcher_utils::jni::LocalRef::created(env->NewStringUTF("inside"));
+			}
+
+			deletedInFrame = ctx.vm.refStats().localRefsDeleted == deleted + 1;
+		}
+
+		ctx.expect(deletedInFrame && ctx.vm.refStats().liveLocalRefs == live, "adoption");
+	}
+
+	void checkCapabilities(CheckContext& ctx) {
+		ctx.expect(
+			launcher_utils::getCapabilities() == (1u << static_cast<std::uint32_t>(launcher_utils::Capability::Count)) - 1
+				&& launcher_utils::supports(launcher_utils::Capability::DeviceLights),
+			"all supported"
+		);
+
+		// installing the VM again starts a new epoch, which is probed first from a thread without an environment
+		ctx.vm.install();
+
+		std::uint32_t fromWorker = 1;
+		std::thread([&fromWorker] {
+			fromWorker = launcher_utils::getCapabilities();
+		}).join();
+
+		ctx.expect(
+			fromWorker == 0 && launcher_utils::supports(launcher_utils::Capability::DeviceLights),
+			"worker failure not kept"
+		);
+	}
+
+	void checkWarmup(CheckContext& ctx) {
+		launcher_utils::jni::addWarmupTargets({
+			launcher_utils::jni::WarmupTarget::staticMethod("com/geode/launcher/utils/GeodeUtils", "missingWarmupMethod", "()V")
+		});
+
+		// every default target exists in the fake launcher, so only the added one fails
+		auto report = launcher_utils::jni::warmUp();
+		ctx.expect(
+			report.isOk() && report.unwrap().failed == 1 && !report.unwrap().entries.back().error.empty()
+				&& report.unwrap().entries.front().target.key().kind == launcher_utils::jni::detail::EntryKind::Class,
+			"report"
+		);
+
+		auto background = launcher_utils::jni::warmUpAsync().get();
+		ctx.expect(
+			background.isOk() && report.isOk() && background.unwrap().resolved == report.unwrap().resolved
+				&& background.unwrap().blockingNanoseconds <= background.unwrap().totalNanoseconds,
+			"async"
+		);
+	}
+
+	void checkAsync(CheckContext& ctx) {
+		ctx.expect(launcher_utils::vibrateAsync(35).get().isOk() && ctx.vm.lastVibrationMs == 35, "vibrate");
+
+		auto sum = sumNextDeviceIds(geode::Ok(1), geode::Ok(2));
+		ctx.expect(sum.isReady() && sum.result().unwrapOr(0) == 5, "task");
+
+		// the launcher class is cached from this thread before the call is awaited, as the worker can't find it.
+		// installing the VM again starts with an empty cache
+		ctx.vm.install();
+		auto entries = launcher_utils::jni::getCacheStats().entries;
+		auto call = launcher_utils::jni::onExecutor([](JNIEnv*) -> geode::Result<> {
+			return geode::Ok();
+		});
+		ctx.expect(launcher_utils::jni::getCacheStats().entries == entries + 1, "launcher class cached");
+
+		launcher_utils::jni::Future<geode::Result<>> empty{};
+		auto taken = launcher_utils::vibrateAsync(35);
+		(void)taken.get();
+		ctx.expect(
+			!empty.valid() && !empty.isReady() && empty.get().isErr() && !taken.valid() && !taken.isReady() && taken.get().isErr(),
+			"future without state"
+		);
+
+		auto failed = sumNextDeviceIds(geode::Ok(1), geode::Err("no device"));
+		ctx.expect(failed.isReady() && failed.result().isErr() && failed.result().unwrapErr() == "no device", "task error");
+	}
+
+	void checkHaptics(CheckContext& ctx) {
+		auto& haptics = launcher_utils::HapticsScheduler::get();
+		auto& device = ctx.vm.devices[0];
+		haptics.resetStats();
+
+		haptics.vibrateDevice(7, 100, 50, 1);
+		haptics.vibrateDevice(7, 300, 20, 1);
+		haptics.vibrateDevice(7, 50, 200, 1);
+		haptics.flush();
+		launcher_utils::jni::Executor::get().drain();
+
+		ctx.expect(haptics.stats().calls == 1 && device.lastVibrationMs == 300 && device.lastVibrationIntensity == 200, "merge");
+
+		haptics.forget(7);
+
+		// a call for one motor would cancel the all-motors vibration, so it is sent to each motor instead
+		haptics.resetStats();
+		haptics.vibrateDevice(7, 200, 100, -1);
+		haptics.vibrateDevice(7, 100, 255, 1);
+
+		// the motor count is looked up with the request, so the flush itself doesn't call into Java
+		auto motorLookups = ctx.vm.callCount(s_utilsClass, "getDeviceHapticsCount");
+		auto deviceLookups = ctx.vm.callCount(s_utilsClass, "getDevice");
+		haptics.flush();
+		auto flushLookups = ctx.vm.callCount(s_utilsClass, "getDeviceHapticsCount") - motorLookups
+			+ ctx.vm.callCount(s_utilsClass, "getDevice") - deviceLookups;
+		launcher_utils::jni::Executor::get().drain();
+
+		ctx.expect(
+			haptics.stats().calls == 2 && device.lastVibrationMotor == 0 && device.lastVibrationMs == 200
+				&& device.lastVibrationIntensity == 100 && flushLookups == 0,
+			"all motors merged"
+		);
+
+		haptics.forget(7);
+		haptics.resetStats();
+	}
+
+	void checkDeviceRegistry(CheckContext& ctx) {
+		auto& registry = launcher_utils::DeviceRegistry::get();
+		registry.clear();
+
+		auto seeded = registry.size() == 1 && registry.controllerCount() == 1;
+		auto lookups = ctx.vm.callCount(s_utilsClass, "getDevice");
+
+		auto device = registry.find(7);
+		ctx.expect(
+			seeded && device != nullptr && device->snapshot().motorCount == 2 && registry.find(8) == nullptr
+				&& ctx.vm.callCount(s_utilsClass, "getDevice") == lookups,
+			"seeded"
+		);
+
+		ctx.expect(registry.update(8).isErr() && registry.size() == 1, "update");
+
+		// the registry's references belong to the fake JVM
+		registry.clear();
+	}
+
+	void checkFrameScheduler(CheckContext& ctx) {
+		auto& scheduler = launcher_utils::jni::FrameScheduler::get();
+		scheduler.resetStats();
+		scheduler.setBudget(std::chrono::microseconds(1));
+
+		ctx.vm.setLatency(s_utilsClass, "getDeviceBatteryCapacity", std::chrono::microseconds(20));
+
+		int batteries = 0;
+		for (int i = 0; i < 4; i++) {
+			scheduler.submit([](JNIEnv* env) {
+				return launcher_utils::jni::callStaticMethod<jfloat(jint), "com/geode/launcher/utils/GeodeUtils", "getDeviceBatteryCapacity">(env, 7);
+			}, [&batteries](geode::Result<jfloat> res) {
+				if (res) {
+					batteries++;
+				}
+			});
+		}
+
+		// once the call's cost is known, only the first task in line runs each frame
+		auto oneAtATime = true;
+		for (int frame = 1; frame <= 4; frame++) {
+			scheduler.runFrame();
+			auto stats = scheduler.stats();
+			oneAtATime = oneAtATime && stats.tasksRun == static_cast<std::uint64_t>(frame)
+				&& stats.lastFrameDeferred == static_cast<std::size_t>(4 - frame);
+		}
+
+		auto stats = scheduler.stats();
+		ctx.expect(
+			oneAtATime && batteries == 4 && stats.oversizedRuns == 3 && stats.maxDeferredInFrame == 3
+				&& stats.queueDepth == 0,
+			"budget"
+		);
+
+		// a cheap task submitted behind one that doesn't fit waits for it
+		std::vector<int> order{};
+		auto slow = [&order](JNIEnv* env) {
+			order.push_back(1);
+			(void)launcher_utils::jni::callStaticMethod<jfloat(jint), "com/geode/launcher/utils/GeodeUtils", "getDeviceBatteryCapacity">(env, 7);
+		};
+
+		scheduler.submit(slow);
+		scheduler.runFrame();
+		order.clear();
+
+		scheduler.submit(slow);
+		scheduler.submit([&order](JNIEnv*) {
+			order.push_back(2);
+		});
+
+		scheduler.runFrame();
+		auto overtaken = order != std::vector<int>{1};
+		while (scheduler.stats().queueDepth != 0) {
+			scheduler.runFrame();
+		}
+
+		ctx.expect(!overtaken && order == std::vector<int>{1, 2}, "order");
+
+		ctx.vm.setLatency(s_utilsClass, "getDeviceBatteryCapacity", {});
+		scheduler.setBudget(std::chrono::microseconds(500));
+		scheduler.resetStats();
+	}
+
+	void checkTracing(CheckContext& ctx) {
+		if constexpr (launcher_utils::jni::isTracingAvailable()) {
+			launcher_utils::jni::startTracing();
+			(void)launcher_utils::getConnectedControllerCount();
+			launcher_utils::jni::stopTracing();
+			auto traced = launcher_utils::jni::getTraceStats().events;
+
+			// starting again empties every buffer, including those of threads that haven't written since
+			launcher_utils::jni::startTracing();
+			auto restarted = launcher_utils::jni::getTraceStats().events;
+			(void)launcher_utils::getConnectedControllerCount();
+			launcher_utils::jni::stopTracing();
+
+			ctx.expect(traced > 0 && restarted == 0 && launcher_utils::jni::getTraceStats().events > 0, "restart");
+
+			// each short-lived thread takes over the buffer of the one before it
+			launcher_utils::jni::startTracing();
+			std::thread([] {
+				launcher_utils::jni::markTraceFrame();
+			}).join();
+
+			auto buffers = launcher_utils::jni::getTraceStats().threads;
+			for (int i = 0; i < 4; i++) {
+				std::thread([] {
+					launcher_utils::jni::markTraceFrame();
+				}).join();
+			}
+
+			launcher_utils::jni::stopTracing();
+			ctx.expect(launcher_utils::jni::getTraceStats().threads == buffers, "buffers reused");
+		}
+	}
+
+	void checkExceptions(CheckContext& ctx) {
+		auto env = launcher_utils::jni::getEnv().unwrap();
+
+		auto thrown = ctx.vm.refStats().exceptionsThrown;
+		ctx.vm.injectException(s_utilsClass, "vibrate", "injected");
+		auto injected = launcher_utils::vibrate(50);
+		ctx.expect(ctx.vm.refStats().exceptionsThrown == thrown + 1, "injection");
+		ctx.expect(injected.isErr() && injected.unwrapErr() == "injected", "error");
+		ctx.expect(!env->ExceptionCheck(), "cleared");
+
+		{
+			ctx.vm.injectException(s_utilsClass, "vibrate", "kept");
+			auto kept = launcher_utils::jni::invokeStaticMethod<void(jlong), "com/geode/launcher/utils/GeodeUtils", "vibrate">(jlong{50});
+			ctx.expect(
+				kept.isErr() && kept.unwrapErr().exception() && kept.unwrapErr().exception()->className() == "java.lang.RuntimeException"
+					&& kept.unwrapErr().message() == "kept",
+				"kept in call error"
+			);
+		}
+
+		ctx.vm.throwException("java/lang/RuntimeException", u"lazy");
+
+		auto caught = launcher_utils::jni::checkException(env);
+		ctx.expect(
+			caught.isErr() && !env->ExceptionCheck() && caught.unwrapErr().className() == "java.lang.RuntimeException"
+				&& caught.unwrapErr().message() == "lazy",
+			"details"
+		);
+	}
+
+	struct Check {
+		std::string_view name;
+		void (*run)(CheckContext& ctx);
+	};
+
+	constexpr Check s_checks[] = {
+		{"devices", checkDevices},
+		{"strings", checkStrings},
+		{"string fuzz", checkStringFuzz},
+		{"battery monitor", checkBatteryMonitor},
+		{"thread attachment", checkThreadAttachment},
+		{"input device", checkInputDevice},
+		{"fields", checkFields},
+		{"method lookups", checkMethodLookups},
+		{"concurrent lookups", checkConcurrentLookups},
+		{"local frames", checkLocalFrames},
+		{"capabilities", checkCapabilities},
+		{"warm-up", checkWarmup},
+		{"async", checkAsync},
+		{"haptics", checkHaptics},
+		{"device registry", checkDeviceRegistry},
+		{"frame scheduler", checkFrameScheduler},
+		{"tracing", checkTracing},
+		{"exceptions", checkExceptions}
+	};
+}
+
+FakeJvmCheckResults runFakeJvmChecks() {
+	fake_jvm::FakeJVM vm{};
+	vm.installLauncherClasses();
+	vm.devices.push_back({
+		.id = 7,
+		.name = "Fake Controller",
+		.descriptor = "fake-descriptor",
+		.vendorId = 0x054c,
+		.productId = 0x0ce6,
+		.sources = static_cast<int>(launcher_utils::InputDevice::Source::Gamepad),
+		.hasBattery = true,
+		.batteryCapacity = 0.75f,
+		.lightCount = 1,
+		.motorCount = 2,
+		.motionRanges = {{.axis = 1, .min = -1.0f, .max = 1.0f, .flat = 0.05f}}
+	});
+
+	vm.install();
+
+	CheckContext ctx{vm};
+	for (const auto& check : s_checks) {
+		ctx.check = check.name;
+		check.run(ctx);
+	}
+
+	launcher_utils::jni::Executor::get().shutdown();
+
+	auto refs = vm.refStats();
+
+	vm.uninstall();
+
+	return FakeJvmCheckResults{std::move(ctx.failures), refs};
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "fakejvm.hpp"
+
+struct FakeJvmCheckResults {
+	/** Names of the checks that failed. */
+	std::vector<std::string> failures{};
+
+	/** Reference counts of the fake JVM after the checks, to spot leaks. */
+	fake_jvm::RefStats refs{};
+};
+
+/**
+ * Runs the library's functional checks against a fake JVM, which is installed for the duration.
+ * Shared by the test mod and the host test executable.
+ */
+FakeJvmCheckResults runFakeJvmChecks();
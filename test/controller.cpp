@@ -2,7 +2,9 @@
 #include <Geode/modify/MenuLayer.hpp>
 #include <Geode/utils/AndroidEvent.hpp>
 
+#include <launcher-utils/async.hpp>
 #include <launcher-utils/geode.hpp>
+#include <launcher-utils/warmup.hpp>
 
 #include <chrono>
 #include <random>
@@ -11,6 +13,18 @@
 
 using namespace geode::prelude;
 
+$on_mod(Loaded) {
+	// the library warms up on its own once loaded; this one runs first, to log how long each lookup took
+	launcher_utils::jni::warmUpAsync([](geode::Result<launcher_utils::jni::WarmupReport> report) {
+		if (!report) {
+			log::warn("warm-up failed: {}", report.unwrapErr());
+			return;
+		}
+
+		log::info("{}", launcher_utils::jni::formatWarmupReport(report.unwrap()));
+	});
+}
+
 constexpr const char* source_name(launcher_utils::InputDevice::Source source) {
 	using namespace launcher_utils;
 
@@ -200,6 +214,7 @@ class ControllerTestLayer : public BaseTestLayer {
 	bool m_nextInputController{false};
 
 	int m_currentDeviceId{-1};
+	int m_loadingDeviceId{-1};
 	std::unique_ptr<launcher_utils::InputDevice> m_currentInputDevice{};
 
 	geode::MDTextArea* m_deviceInfoLabel{};
@@ -307,30 +322,45 @@ class ControllerTestLayer : public BaseTestLayer {
 
 		this->togglePage(0);
 
-		auto controllerCount = launcher_utils::getConnectedControllerCount();
+		logConnectedDevices();
+
+		return true;
+	}
+
+	launcher_utils::AsyncTask<> logConnectedDevices() {
+		geode::Ref<ControllerTestLayer> self = this;
+
+		auto controllerCount = co_await launcher_utils::coro::getConnectedControllerCount().asResult();
 		if (!controllerCount) {
 			geode::log::warn("failed to get controller count: {}", controllerCount.unwrapErr());
 		} else {
 			addLogLine(fmt::format("controllerCount: {}", controllerCount.unwrap()));
 		}
 
-		auto devices = launcher_utils::getConnectedDevices();
+		auto devices = co_await launcher_utils::coro::getConnectedDevices().asResult();
 		if (!devices) {
 			geode::log::warn("failed to get devices: {}", devices.unwrapErr());
 		} else {
 			addLogLine(fmt::format("devices: {}", devices.unwrap()));
 		}
 
-		return true;
+		co_return geode::Ok();
 	}
 
 	void updateInputDevice(int device, bool force = false) {
-		if (m_currentInputDevice && m_currentInputDevice->getDeviceId() == device && !force) {
-			return;
+		if (!force) {
+			if (m_loadingDeviceId == device && device != -1) {
+				return;
+			}
+
+			if (m_currentInputDevice && m_currentInputDevice->getDeviceId() == device) {
+				return;
+			}
 		}
 
 		m_currentInputDevice.reset();
 		m_currentDeviceId = -1;
+		m_loadingDeviceId = device;
 
 		if (device == -1) {
 			m_deviceInfoLabel->setString("# No device selected");
@@ -338,35 +368,64 @@ class ControllerTestLayer : public BaseTestLayer {
 			return;
 		}
 
-		auto res = launcher_utils::InputDevice::create(device);
+		m_deviceInfoLabel->setString("# Loading device...");
+		loadInputDevice(device);
+	}
+
+	/**
+	 * Loads the device without blocking the frame. If another device was selected in the meantime, the result is dropped.
+	 */
+	launcher_utils::AsyncTask<> loadInputDevice(int device) {
+		// keeps the layer alive until the device has loaded
+		geode::Ref<ControllerTestLayer> self = this;
+
+		auto res = co_await launcher_utils::coro::createInputDevice(device).asResult();
+		if (m_loadingDeviceId != device) {
+			co_return geode::Ok();
+		}
+
 		if (!res) {
+			m_loadingDeviceId = -1;
 			m_deviceInfoLabel->setString("# Failed to load device");
 			addLogLine(fmt::format("Failed to load device: {}", res.unwrapErr()));
 
-			return;
+			co_return geode::Ok();
 		}
 
-		auto&& inputDevice = res.unwrap();
+		auto inputDevice = std::move(res).unwrap();
 
-		auto descriptor = inputDevice.getDescriptor();
-		auto name = inputDevice.getName();
+		// the snapshot and battery state take several calls, so fetch them on the executor too
+		auto batteryString = co_await launcher_utils::jni::onExecutor([&inputDevice](JNIEnv*) -> geode::Result<std::string> {
+			auto& info = inputDevice.snapshot();
 
-		auto productId = inputDevice.getProductId();
-		auto vendorId = inputDevice.getVendorId();
+			auto hasBattery = (info.productId == 24833 && info.vendorId == 11720)
+				? false
+				: inputDevice.hasBattery();
 
-		auto hasBattery = (productId == 24833 && vendorId == 11720)
-			? false
-			: inputDevice.hasBattery();
+			return geode::Ok(hasBattery
+				? fmt::format(
+						"battery={}-{}%",
+						static_cast<int>(inputDevice.getBatteryStatus()),
+						inputDevice.getBatteryCapacity() * 100.0f
+					)
+				: "battery=none");
+		});
+
+		if (m_loadingDeviceId != device) {
+			co_return geode::Ok();
+		}
+
+		m_loadingDeviceId = -1;
 
-		auto batteryString = hasBattery
-			? fmt::format(
-					"battery={}-{}%",
-					static_cast<int>(inputDevice.getBatteryStatus()),
-					inputDevice.getBatteryCapacity() * 100.0f
-				)
-			: "battery=none";
+		auto& info = inputDevice.snapshot();
 
-		auto sources = split_sources(inputDevice.getSources());
+		auto& descriptor = info.descriptor;
+		auto& name = info.name;
+
+		auto productId = info.productId;
+		auto vendorId = info.vendorId;
+
+		auto sources = split_sources(info.sources);
 
 		std::vector<std::string> sourceStr{};
 		sourceStr.reserve(sources.size());
@@ -375,10 +434,10 @@ class ControllerTestLayer : public BaseTestLayer {
 			sourceStr.push_back(source_name(x));
 		}
 
-		auto lightCount = inputDevice.getLightCount();
-		auto lightType = inputDevice.getLightType();
+		auto lightCount = info.lightCount;
+		auto lightType = info.lightType;
 
-		auto motorCount = inputDevice.getMotorCount();
+		auto motorCount = info.motorCount;
 
 		auto deviceId = inputDevice.getDeviceId();
 
@@ -401,6 +460,8 @@ lights={} ({}) motors={})*",
 
 		m_currentInputDevice = std::make_unique<launcher_utils::InputDevice>(std::move(inputDevice));
 		m_currentDeviceId = deviceId;
+
+		co_return geode::Ok();
 	}
 
 	void onVibrateBtn(enumKeyCodes key) {
@@ -408,7 +469,7 @@ lights={} ({}) motors={})*",
 			return;
 		}
 
-		auto motorCount = m_currentInputDevice->getMotorCount();
+		auto motorCount = m_currentInputDevice->snapshot().motorCount;
 		if (motorCount == 0) {
 			addLogLine("no motors to vibrate!");
 			return;
@@ -456,7 +517,7 @@ lights={} ({}) motors={})*",
 			return;
 		}
 
-		auto lightsCount = m_currentInputDevice->getLightCount();
+		auto lightsCount = m_currentInputDevice->snapshot().lightCount;
 		if (lightsCount == 0) {
 			addLogLine("no lights to set!");
 			return;
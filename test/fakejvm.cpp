@@ -0,0 +1,1522 @@
+#include "fakejvm.hpp"
+
+#include <launcher-utils/jni.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdarg>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <tuple>
+
+using namespace fake_jvm;
+
+namespace fake_jvm {
+	struct FakeEnv : JNIEnv {
+		FakeJVM* vm{};
+		FakeObject* pendingException{};
+
+		std::deque<Ref> refs{};
+		std::vector<Ref*> freeRefs{};
+		std::size_t liveLocalRefs{};
+
+		/** References created in each local frame, with the serial they were created with. */
+		std::vector<std::vector<std::pair<Ref*, std::uint32_t>>> frames{1};
+	};
+
+	struct FakeVMHandle : JavaVM {
+		FakeJVM* owner{};
+	};
+}
+
+namespace {
+	thread_local FakeEnv* t_env = nullptr;
+	FakeJVM* s_installed = nullptr;
+
+	FakeEnv* fakeEnv(JNIEnv* env) {
+		return static_cast<FakeEnv*>(env);
+	}
+
+	FakeJVM& vmOf(JNIEnv* env) {
+		return *fakeEnv(env)->vm;
+	}
+
+	FakeClass* classOf(jclass cls) {
+		auto obj = FakeJVM::deref(cls);
+		return obj ? obj->classValue : nullptr;
+	}
+
+	std::u16string widen(std::string_view str) {
+		return {str.begin(), str.end()};
+	}
+
+	std::string javaClassName(const FakeClass* cls) {
+		if (!cls) {
+			return {};
+		}
+
+		auto name = cls->name;
+		std::ranges::replace(name, '/', '.');
+
+		return name;
+	}
+
+	/**
+	 * Formats a throwable like Throwable.toString.
+	 */
+	std::u16string describeThrowable(const FakeObject* throwable) {
+		auto description = widen(javaClassName(throwable->cls));
+		if (!throwable->string.empty()) {
+			description += u": ";
+			description += throwable->string;
+		}
+
+		return description;
+	}
+
+	/**
+	 * Decodes modified UTF-8, accepting standard four byte sequences as well.
+	 */
+	std::u16string decodeModifiedUtf8(const char* str) {
+		std::u16string r{};
+		auto s = reinterpret_cast<const std::uint8_t*>(str);
+
+		while (*s) {
+			auto c = *s;
+			if (c < 0x80) {
+				r.push_back(c);
+				s += 1;
+			} else if ((c & 0xe0) == 0xc0 && s[1]) {
+				r.push_back(static_cast<char16_t>(((c & 0x1f) << 6) | (s[1] & 0x3f)));
+				s += 2;
+			} else if ((c & 0xf0) == 0xe0 && s[1] && s[2]) {
+				r.push_back(static_cast<char16_t>(((c & 0x0f) << 12) | ((s[1] & 0x3f) << 6) | (s[2] & 0x3f)));
+				s += 3;
+			} else if ((c & 0xf8) == 0xf0 && s[1] && s[2] && s[3]) {
+				auto cp = ((c & 0x07) << 18) | ((s[1] & 0x3f) << 12) | ((s[2] & 0x3f) << 6) | (s[3] & 0x3f);
+				cp -= 0x10000;
+				r.push_back(static_cast<char16_t>(0xd800 + (cp >> 10)));
+				r.push_back(static_cast<char16_t>(0xdc00 + (cp & 0x3ff)));
+				s += 4;
+			} else {
+				r.push_back(u'�');
+				s += 1;
+			}
+		}
+
+		return r;
+	}
+
+	std::string encodeModifiedUtf8(std::u16string_view str) {
+		std::string r{};
+
+		for (auto c : str) {
+			if (c != 0 && c < 0x80) {
+				r.push_back(static_cast<char>(c));
+			} else if (c < 0x800) {
+				r.push_back(static_cast<char>(0xc0 | (c >> 6)));
+				r.push_back(static_cast<char>(0x80 | (c & 0x3f)));
+			} else {
+				r.push_back(static_cast<char>(0xe0 | (c >> 12)));
+				r.push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3f)));
+				r.push_back(static_cast<char>(0x80 | (c & 0x3f)));
+			}
+		}
+
+		return r;
+	}
+
+	/** Implementations of the function tables. */
+	namespace impl {
+		// references
+
+		jint getVersion(JNIEnv*) {
+			return JNI_VERSION_1_6;
+		}
+
+		jobject newGlobalRef(JNIEnv* env, jobject obj) {
+			return vmOf(env).newGlobalRef(FakeJVM::deref(obj));
+		}
+
+		void deleteGlobalRef(JNIEnv* env, jobject obj) {
+			vmOf(env).deleteGlobalRef(obj);
+		}
+
+		void deleteLocalRef(JNIEnv* env, jobject obj) {
+			vmOf(env).deleteLocalRef(fakeEnv(env), obj);
+		}
+
+		jobject newLocalRef(JNIEnv* env, jobject obj) {
+			return vmOf(env).newLocalRef(fakeEnv(env), FakeJVM::deref(obj));
+		}
+
+		jboolean isSameObject(JNIEnv*, jobject a, jobject b) {
+			return FakeJVM::deref(a) == FakeJVM::deref(b);
+		}
+
+		jint ensureLocalCapacity(JNIEnv*, jint) {
+			return JNI_OK;
+		}
+
+		jint pushLocalFrame(JNIEnv* env, jint) {
+			fakeEnv(env)->frames.emplace_back();
+			return JNI_OK;
+		}
+
+		jobject popLocalFrame(JNIEnv* env, jobject result) {
+			auto fake = fakeEnv(env);
+			auto resultObj = FakeJVM::deref(result);
+
+			if (fake->frames.size() <= 1) {
+				env->FatalError("PopLocalFrame: no frame to pop");
+			}
+
+			auto frame = std::move(fake->frames.back());
+			fake->frames.pop_back();
+
+			for (auto [ref, serial] : frame) {
+				if (ref->live && ref->serial == serial) {
+					fake->vm->deleteLocalRef(fake, reinterpret_cast<jobject>(ref));
+				}
+			}
+
+			return fake->vm->newLocalRef(fake, resultObj);
+		}
+
+		jobjectRefType getObjectRefType(JNIEnv*, jobject obj) {
+			auto ref = reinterpret_cast<Ref*>(obj);
+			return ref && ref->live ? ref->type : JNIInvalidRefType;
+		}
+
+		// exceptions
+
+		jint throwObject(JNIEnv* env, jthrowable obj) {
+			vmOf(env).setPendingException(fakeEnv(env), FakeJVM::deref(obj));
+			return JNI_OK;
+		}
+
+		jint throwNew(JNIEnv* env, jclass cls, const char* message) {
+			auto& vm = vmOf(env);
+
+			auto exception = vm.newObject(*classOf(cls));
+			exception->string = decodeModifiedUtf8(message ? message : "");
+
+			vm.setPendingException(fakeEnv(env), exception);
+			return JNI_OK;
+		}
+
+		jthrowable exceptionOccurred(JNIEnv* env) {
+			auto fake = fakeEnv(env);
+			return static_cast<jthrowable>(fake->vm->newLocalRef(fake, fake->pendingException));
+		}
+
+		void exceptionDescribe(JNIEnv*) {}
+
+		void exceptionClear(JNIEnv* env) {
+			vmOf(env).setPendingException(fakeEnv(env), nullptr);
+		}
+
+		jboolean exceptionCheck(JNIEnv* env) {
+			return fakeEnv(env)->pendingException != nullptr;
+		}
+
+		void fatalError(JNIEnv*, const char*) {
+			std::abort();
+		}
+
+		// classes and methods
+
+		jclass findClass(JNIEnv* env, const char* name) {
+			auto& vm = vmOf(env);
+
+			auto cls = vm.findClass(name);
+			if (!cls) {
+				vm.throwException("java/lang/NoClassDefFoundError", widen(name));
+				return nullptr;
+			}
+
+			return static_cast<jclass>(vm.newLocalRef(fakeEnv(env), cls->object));
+		}
+
+		jclass getObjectClass(JNIEnv* env, jobject obj) {
+			auto object = FakeJVM::deref(obj);
+			return static_cast<jclass>(vmOf(env).newLocalRef(fakeEnv(env), object->cls->object));
+		}
+
+		jboolean isInstanceOf(JNIEnv*, jobject obj, jclass cls) {
+			auto object = FakeJVM::deref(obj);
+			if (!object) {
+				return JNI_TRUE;
+			}
+
+			auto target = classOf(cls);
+			for (auto c = object->cls; c != nullptr; c = c->superclass) {
+				if (c == target) {
+					return JNI_TRUE;
+				}
+			}
+
+			return JNI_FALSE;
+		}
+
+		template <bool IsStatic>
+		jmethodID getMethodId(JNIEnv* env, jclass cls, const char* name, const char* signature) {
+			for (auto c = classOf(cls); c != nullptr; c = c->superclass) {
+				if (auto method = c->findMethod(name, signature, IsStatic)) {
+					return reinterpret_cast<jmethodID>(method);
+				}
+			}
+
+			vmOf(env).throwException("java/lang/NoSuchMethodError", widen(name));
+			return nullptr;
+		}
+
+		template <bool IsStatic>
+		jfieldID getFieldId(JNIEnv* env, jclass cls, const char* name, const char* signature) {
+			if (auto field = classOf(cls)->findField(name, signature, IsStatic)) {
+				return reinterpret_cast<jfieldID>(field);
+			}
+
+			vmOf(env).throwException("java/lang/NoSuchFieldError", widen(name));
+			return nullptr;
+		}
+
+		// calls
+
+		using ArgArray = std::array<jvalue, 32>;
+
+		ArgArray readArgs(jmethodID id, va_list args) {
+			std::string_view sig = reinterpret_cast<FakeMethod*>(id)->signature;
+
+			ArgArray values{};
+			std::size_t idx = 0;
+
+			for (std::size_t i = 1; i < sig.size() && sig[i] != ')'; i++) {
+				auto& value = values[idx++];
+
+				switch (sig[i]) {
+					case 'Z': value.z = static_cast<jboolean>(va_arg(args, int)); break;
+					case 'B': value.b = static_cast<jbyte>(va_arg(args, int)); break;
+					case 'C': value.c = static_cast<jchar>(va_arg(args, int)); break;
+					case 'S': value.s = static_cast<jshort>(va_arg(args, int)); break;
+					case 'I': value.i = va_arg(args, jint); break;
+					case 'J': value.j = va_arg(args, jlong); break;
+					case 'F': value.f = static_cast<jfloat>(va_arg(args, double)); break;
+					case 'D': value.d = va_arg(args, double); break;
+					case '[':
+						while (sig[i] == '[') {
+							i++;
+						}
+						if (sig[i] == 'L') {
+							i = sig.find(';', i);
+						}
+						value.l = va_arg(args, jobject);
+						break;
+					case 'L':
+						i = sig.find(';', i);
+						value.l = va_arg(args, jobject);
+						break;
+				}
+			}
+
+			return values;
+		}
+
+		jvalue invoke(JNIEnv* env, FakeObject* self, jmethodID id, const jvalue* args) {
+			auto method = reinterpret_cast<FakeMethod*>(id);
+			auto& vm = vmOf(env);
+
+			method->callCount.fetch_add(1, std::memory_order_relaxed);
+
+			if (!method->injectedException.empty()) {
+				auto message = std::exchange(method->injectedException, {});
+				vm.throwException("java/lang/RuntimeException", widen(message));
+
+				return jvalue{};
+			}
+
+			if (method->latency.count() > 0) {
+				std::this_thread::sleep_for(method->latency);
+			}
+
+			CallContext ctx{vm, env, self, args};
+			return method->impl(ctx);
+		}
+
+		template <typename T>
+		T fromValue(JNIEnv* env, jvalue value) {
+			if constexpr (std::is_same_v<T, jobject>) {
+				return vmOf(env).newLocalRef(fakeEnv(env), reinterpret_cast<FakeObject*>(value.l));
+			} else if constexpr (std::is_same_v<T, jboolean>) {
+				return value.z;
+			} else if constexpr (std::is_same_v<T, jbyte>) {
+				return value.b;
+			} else if constexpr (std::is_same_v<T, jchar>) {
+				return value.c;
+			} else if constexpr (std::is_same_v<T, jshort>) {
+				return value.s;
+			} else if constexpr (std::is_same_v<T, jint>) {
+				return value.i;
+			} else if constexpr (std::is_same_v<T, jlong>) {
+				return value.j;
+			} else if constexpr (std::is_same_v<T, jfloat>) {
+				return value.f;
+			} else if constexpr (std::is_same_v<T, jdouble>) {
+				return value.d;
+			}
+		}
+
+		template <typename T>
+		T callMethodA(JNIEnv* env, jobject obj, jmethodID id, const jvalue* args) {
+			auto value = invoke(env, FakeJVM::deref(obj), id, args);
+			if constexpr (!std::is_void_v<T>) {
+				return fromValue<T>(env, value);
+			}
+		}
+
+		template <typename T>
+		T callMethodV(JNIEnv* env, jobject obj, jmethodID id, va_list args) {
+			auto values = readArgs(id, args);
+			return callMethodA<T>(env, obj, id, values.data());
+		}
+
+		template <typename T>
+		T callMethod(JNIEnv* env, jobject obj, jmethodID id, ...) {
+			va_list args;
+			va_start(args, id);
+			auto values = readArgs(id, args);
+			va_end(args);
+
+			return callMethodA<T>(env, obj, id, values.data());
+		}
+
+		template <typename T>
+		T callStaticMethodA(JNIEnv* env, jclass, jmethodID id, const jvalue* args) {
+			auto value = invoke(env, nullptr, id, args);
+			if constexpr (!std::is_void_v<T>) {
+				return fromValue<T>(env, value);
+			}
+		}
+
+		template <typename T>
+		T callStaticMethodV(JNIEnv* env, jclass cls, jmethodID id, va_list args) {
+			auto values = readArgs(id, args);
+			return callStaticMethodA<T>(env, cls, id, values.data());
+		}
+
+		template <typename T>
+		T callStaticMethod(JNIEnv* env, jclass cls, jmethodID id, ...) {
+			va_list args;
+			va_start(args, id);
+			auto values = readArgs(id, args);
+			va_end(args);
+
+			return callStaticMethodA<T>(env, cls, id, values.data());
+		}
+
+		// fields
+
+		template <typename T>
+		void toValue(JNIEnv* env, jvalue& slot, T value) {
+			if constexpr (std::is_same_v<T, jobject>) {
+				vmOf(env).storeObject(slot, FakeJVM::deref(value));
+			} else if constexpr (std::is_same_v<T, jboolean>) {
+				slot.z = value;
+			} else if constexpr (std::is_same_v<T, jbyte>) {
+				slot.b = value;
+			} else if constexpr (std::is_same_v<T, jchar>) {
+				slot.c = value;
+			} else if constexpr (std::is_same_v<T, jshort>) {
+				slot.s = value;
+			} else if constexpr (std::is_same_v<T, jint>) {
+				slot.i = value;
+			} else if constexpr (std::is_same_v<T, jlong>) {
+				slot.j = value;
+			} else if constexpr (std::is_same_v<T, jfloat>) {
+				slot.f = value;
+			} else if constexpr (std::is_same_v<T, jdouble>) {
+				slot.d = value;
+			}
+		}
+
+		jvalue& fieldSlot(jobject obj, jfieldID id) {
+			return FakeJVM::deref(obj)->fields[reinterpret_cast<FakeField*>(id)];
+		}
+
+		template <typename T>
+		T getField(JNIEnv* env, jobject obj, jfieldID id) {
+			return fromValue<T>(env, fieldSlot(obj, id));
+		}
+
+		template <typename T>
+		void setField(JNIEnv* env, jobject obj, jfieldID id, T value) {
+			toValue(env, fieldSlot(obj, id), value);
+		}
+
+		template <typename T>
+		T getStaticField(JNIEnv* env, jclass, jfieldID id) {
+			return fromValue<T>(env, reinterpret_cast<FakeField*>(id)->staticValue);
+		}
+
+		template <typename T>
+		void setStaticField(JNIEnv* env, jclass, jfieldID id, T value) {
+			toValue(env, reinterpret_cast<FakeField*>(id)->staticValue, value);
+		}
+
+		// strings
+
+		FakeObject* stringOf(jstring str) {
+			return FakeJVM::deref(str);
+		}
+
+		jstring newString(JNIEnv* env, const jchar* chars, jsize len) {
+			auto& vm = vmOf(env);
+			auto str = vm.newString(std::u16string_view(reinterpret_cast<const char16_t*>(chars), len));
+
+			return static_cast<jstring>(vm.newLocalRef(fakeEnv(env), str));
+		}
+
+		jstring newStringUTF(JNIEnv* env, const char* chars) {
+			auto& vm = vmOf(env);
+			auto str = vm.newString(decodeModifiedUtf8(chars));
+
+			return static_cast<jstring>(vm.newLocalRef(fakeEnv(env), str));
+		}
+
+		jsize getStringLength(JNIEnv*, jstring str) {
+			return static_cast<jsize>(stringOf(str)->string.size());
+		}
+
+		const jchar* getStringChars(JNIEnv*, jstring str, jboolean* isCopy) {
+			if (isCopy) {
+				*isCopy = JNI_FALSE;
+			}
+
+			return reinterpret_cast<const jchar*>(stringOf(str)->string.data());
+		}
+
+		void releaseStringChars(JNIEnv*, jstring, const jchar*) {}
+
+		jsize getStringUTFLength(JNIEnv*, jstring str) {
+			return static_cast<jsize>(encodeModifiedUtf8(stringOf(str)->string).size());
+		}
+
+		const char* getStringUTFChars(JNIEnv*, jstring str, jboolean* isCopy) {
+			if (isCopy) {
+				*isCopy = JNI_TRUE;
+			}
+
+			auto utf = encodeModifiedUtf8(stringOf(str)->string);
+			auto r = new char[utf.size() + 1];
+			std::memcpy(r, utf.c_str(), utf.size() + 1);
+
+			return r;
+		}
+
+		void releaseStringUTFChars(JNIEnv*, jstring, const char* chars) {
+			delete[] chars;
+		}
+
+		void getStringRegion(JNIEnv* env, jstring str, jsize start, jsize len, jchar* buf) {
+			auto& string = stringOf(str)->string;
+			if (start < 0 || len < 0 || static_cast<std::size_t>(start + len) > string.size()) {
+				vmOf(env).throwException("java/lang/StringIndexOutOfBoundsException", u"");
+				return;
+			}
+
+			std::memcpy(buf, string.data() + start, len * sizeof(jchar));
+		}
+
+		void getStringUTFRegion(JNIEnv* env, jstring str, jsize start, jsize len, char* buf) {
+			auto& string = stringOf(str)->string;
+			if (start < 0 || len < 0 || static_cast<std::size_t>(start + len) > string.size()) {
+				vmOf(env).throwException("java/lang/StringIndexOutOfBoundsException", u"");
+				return;
+			}
+
+			auto utf = encodeModifiedUtf8(std::u16string_view(string).substr(start, len));
+			std::memcpy(buf, utf.c_str(), utf.size() + 1);
+		}
+
+		const jchar* getStringCritical(JNIEnv* env, jstring str, jboolean* isCopy) {
+			return getStringChars(env, str, isCopy);
+		}
+
+		void releaseStringCritical(JNIEnv*, jstring, const jchar*) {}
+
+		// arrays
+
+		jsize getArrayLength(JNIEnv*, jarray array) {
+			return static_cast<jsize>(FakeJVM::deref(array)->length);
+		}
+
+		template <typename T, char Signature>
+		auto newArray(JNIEnv* env, jsize len) {
+			auto& vm = vmOf(env);
+			auto array = vm.newArray(Signature, len, sizeof(T));
+
+			return static_cast<launcher_utils::jni::ArrayType<T>>(vm.newLocalRef(fakeEnv(env), array));
+		}
+
+		template <typename T>
+		T* getArrayElements(JNIEnv*, launcher_utils::jni::ArrayType<T> array, jboolean* isCopy) {
+			if (isCopy) {
+				*isCopy = JNI_FALSE;
+			}
+
+			return reinterpret_cast<T*>(FakeJVM::deref(array)->elements.data());
+		}
+
+		template <typename T>
+		void releaseArrayElements(JNIEnv*, launcher_utils::jni::ArrayType<T>, T*, jint) {}
+
+		template <typename T>
+		void getArrayRegion(JNIEnv* env, launcher_utils::jni::ArrayType<T> array, jsize start, jsize len, T* buf) {
+			auto object = FakeJVM::deref(array);
+			if (start < 0 || len < 0 || static_cast<std::size_t>(start + len) > object->length) {
+				vmOf(env).throwException("java/lang/ArrayIndexOutOfBoundsException", u"");
+				return;
+			}
+
+			std::memcpy(buf, object->elements.data() + start * sizeof(T), len * sizeof(T));
+		}
+
+		template <typename T>
+		void setArrayRegion(JNIEnv* env, launcher_utils::jni::ArrayType<T> array, jsize start, jsize len, const T* buf) {
+			auto object = FakeJVM::deref(array);
+			if (start < 0 || len < 0 || static_cast<std::size_t>(start + len) > object->length) {
+				vmOf(env).throwException("java/lang/ArrayIndexOutOfBoundsException", u"");
+				return;
+			}
+
+			std::memcpy(object->elements.data() + start * sizeof(T), buf, len * sizeof(T));
+		}
+
+		void* getPrimitiveArrayCritical(JNIEnv*, jarray array, jboolean* isCopy) {
+			if (isCopy) {
+				*isCopy = JNI_FALSE;
+			}
+
+			return FakeJVM::deref(array)->elements.data();
+		}
+
+		void releasePrimitiveArrayCritical(JNIEnv*, jarray, void*, jint) {}
+
+		// invocation interface
+
+		jint destroyJavaVM(JavaVM*) {
+			return JNI_ERR;
+		}
+
+		template <typename EnvOut>
+		jint attachCurrentThread(JavaVM* vm, EnvOut penv, void*) {
+			*penv = static_cast<FakeVMHandle*>(vm)->owner->attachCurrentThread();
+			return JNI_OK;
+		}
+
+		jint detachCurrentThread(JavaVM* vm) {
+			static_cast<FakeVMHandle*>(vm)->owner->detachCurrentThread();
+			return JNI_OK;
+		}
+
+		jint getEnv(JavaVM* vm, void** penv, jint) {
+			auto owner = static_cast<FakeVMHandle*>(vm)->owner;
+			if (auto env = owner->currentEnv()) {
+				*penv = static_cast<JNIEnv*>(env);
+				return JNI_OK;
+			}
+
+			*penv = nullptr;
+			return JNI_EDETACHED;
+		}
+
+	}
+
+	JavaVM* provideInstalledVM() {
+		return s_installed ? s_installed->javaVM() : nullptr;
+	}
+}
+
+FakeObject* CallContext::objectArg(std::size_t idx) const {
+	return FakeJVM::deref(args[idx].l);
+}
+
+FakeMethod& FakeClass::addMethod(std::string_view name, std::string_view signature, MethodImpl impl) {
+	auto& method = methods.emplace_back();
+	method.owner = this;
+	method.name = name;
+	method.signature = signature;
+	method.isStatic = false;
+	method.impl = std::move(impl);
+
+	return method;
+}
+
+FakeMethod& FakeClass::addStaticMethod(std::string_view name, std::string_view signature, MethodImpl impl) {
+	auto& method = addMethod(name, signature, std::move(impl));
+	method.isStatic = true;
+
+	return method;
+}
+
+FakeMethod* FakeClass::findMethod(std::string_view name, std::string_view signature, bool isStatic) {
+	for (auto& method : methods) {
+		if (method.isStatic == isStatic && method.name == name && method.signature == signature) {
+			return &method;
+		}
+	}
+
+	return nullptr;
+}
+
+FakeField& FakeClass::addField(std::string_view name, std::string_view signature) {
+	auto& field = fields.emplace_back();
+	field.owner = this;
+	field.name = name;
+	field.signature = signature;
+	field.isStatic = false;
+
+	return field;
+}
+
+FakeField& FakeClass::addStaticField(std::string_view name, std::string_view signature) {
+	auto& field = addField(name, signature);
+	field.isStatic = true;
+
+	return field;
+}
+
+FakeField* FakeClass::findField(std::string_view name, std::string_view signature, bool isStatic) {
+	for (auto c = this; c != nullptr; c = c->superclass) {
+		for (auto& field : c->fields) {
+			if (field.isStatic == isStatic && field.name == name && field.signature == signature) {
+				return &field;
+			}
+		}
+	}
+
+	return nullptr;
+}
+
+FakeJVM::FakeJVM() : m_vm(std::make_unique<FakeVMHandle>()) {
+	buildInterfaces();
+
+	m_vm->functions = &m_invokeInterface;
+	m_vm->owner = this;
+
+	defineBaseClasses();
+}
+
+FakeJVM::~FakeJVM() {
+	if (s_installed == this) {
+		uninstall();
+	}
+
+	if (t_env && t_env->vm == this) {
+		t_env = nullptr;
+	}
+}
+
+void FakeJVM::buildInterfaces() {
+	m_nativeInterface.GetVersion = &impl::getVersion;
+
+	m_nativeInterface.FindClass = &impl::findClass;
+	m_nativeInterface.Throw = &impl::throwObject;
+	m_nativeInterface.ThrowNew = &impl::throwNew;
+	m_nativeInterface.ExceptionOccurred = &impl::exceptionOccurred;
+	m_nativeInterface.ExceptionDescribe = &impl::exceptionDescribe;
+	m_nativeInterface.ExceptionClear = &impl::exceptionClear;
+	m_nativeInterface.ExceptionCheck = &impl::exceptionCheck;
+	m_nativeInterface.FatalError = &impl::fatalError;
+
+	m_nativeInterface.PushLocalFrame = &impl::pushLocalFrame;
+	m_nativeInterface.PopLocalFrame = &impl::popLocalFrame;
+	m_nativeInterface.NewGlobalRef = &impl::newGlobalRef;
+	m_nativeInterface.DeleteGlobalRef = &impl::deleteGlobalRef;
+	m_nativeInterface.DeleteLocalRef = &impl::deleteLocalRef;
+	m_nativeInterface.IsSameObject = &impl::isSameObject;
+	m_nativeInterface.NewLocalRef = &impl::newLocalRef;
+	m_nativeInterface.EnsureLocalCapacity = &impl::ensureLocalCapacity;
+	m_nativeInterface.NewWeakGlobalRef = &impl::newGlobalRef;
+	m_nativeInterface.DeleteWeakGlobalRef = &impl::deleteGlobalRef;
+	m_nativeInterface.GetObjectRefType = &impl::getObjectRefType;
+
+	m_nativeInterface.GetObjectClass = &impl::getObjectClass;
+	m_nativeInterface.IsInstanceOf = &impl::isInstanceOf;
+	m_nativeInterface.GetMethodID = &impl::getMethodId<false>;
+	m_nativeInterface.GetStaticMethodID = &impl::getMethodId<true>;
+
+	m_nativeInterface.GetFieldID = &impl::getFieldId<false>;
+	m_nativeInterface.GetStaticFieldID = &impl::getFieldId<true>;
+
+#define FAKE_JVM_CALLS(Name, Type) \
+	m_nativeInterface.Call##Name##Method = &impl::callMethod<Type>; \
+	m_nativeInterface.Call##Name##MethodV = &impl::callMethodV<Type>; \
+	m_nativeInterface.Call##Name##MethodA = &impl::callMethodA<Type>; \
+	m_nativeInterface.CallStatic##Name##Method = &impl::callStaticMethod<Type>; \
+	m_nativeInterface.CallStatic##Name##MethodV = &impl::callStaticMethodV<Type>; \
+	m_nativeInterface.CallStatic##Name##MethodA = &impl::callStaticMethodA<Type>;
+
+	FAKE_JVM_CALLS(Object, jobject)
+	FAKE_JVM_CALLS(Boolean, jboolean)
+	FAKE_JVM_CALLS(Byte, jbyte)
+	FAKE_JVM_CALLS(Char, jchar)
+	FAKE_JVM_CALLS(Short, jshort)
+	FAKE_JVM_CALLS(Int, jint)
+	FAKE_JVM_CALLS(Long, jlong)
+	FAKE_JVM_CALLS(Float, jfloat)
+	FAKE_JVM_CALLS(Double, jdouble)
+	FAKE_JVM_CALLS(Void, void)
+
+#undef FAKE_JVM_CALLS
+
+#define FAKE_JVM_FIELDS(Name, Type) \
+	m_nativeInterface.Get##Name##Field = &impl::getField<Type>; \
+	m_nativeInterface.Set##Name##Field = &impl::setField<Type>; \
+	m_nativeInterface.GetStatic##Name##Field = &impl::getStaticField<Type>; \
+	m_nativeInterface.SetStatic##Name##Field = &impl::setStaticField<Type>;
+
+	FAKE_JVM_FIELDS(Object, jobject)
+	FAKE_JVM_FIELDS(Boolean, jboolean)
+	FAKE_JVM_FIELDS(Byte, jbyte)
+	FAKE_JVM_FIELDS(Char, jchar)
+	FAKE_JVM_FIELDS(Short, jshort)
+	FAKE_JVM_FIELDS(Int, jint)
+	FAKE_JVM_FIELDS(Long, jlong)
+	FAKE_JVM_FIELDS(Float, jfloat)
+	FAKE_JVM_FIELDS(Double, jdouble)
+
+#undef FAKE_JVM_FIELDS
+
+	m_nativeInterface.NewString = &impl::newString;
+	m_nativeInterface.NewStringUTF = &impl::newStringUTF;
+	m_nativeInterface.GetStringLength = &impl::getStringLength;
+	m_nativeInterface.GetStringChars = &impl::getStringChars;
+	m_nativeInterface.ReleaseStringChars = &impl::releaseStringChars;
+	m_nativeInterface.GetStringUTFLength = &impl::getStringUTFLength;
+	m_nativeInterface.GetStringUTFChars = &impl::getStringUTFChars;
+	m_nativeInterface.ReleaseStringUTFChars = &impl::releaseStringUTFChars;
+	m_nativeInterface.GetStringRegion = &impl::getStringRegion;
+	m_nativeInterface.GetStringUTFRegion = &impl::getStringUTFRegion;
+	m_nativeInterface.GetStringCritical = &impl::getStringCritical;
+	m_nativeInterface.ReleaseStringCritical = &impl::releaseStringCritical;
+
+	m_nativeInterface.GetArrayLength = &impl::getArrayLength;
+	m_nativeInterface.GetPrimitiveArrayCritical = &impl::getPrimitiveArrayCritical;
+	m_nativeInterface.ReleasePrimitiveArrayCritical = &impl::releasePrimitiveArrayCritical;
+
+#define FAKE_JVM_ARRAYS(Name, Type, Signature) \
+	m_nativeInterface.New##Name##Array = &impl::newArray<Type, Signature>; \
+	m_nativeInterface.Get##Name##ArrayElements = &impl::getArrayElements<Type>; \
+	m_nativeInterface.Release##Name##ArrayElements = &impl::releaseArrayElements<Type>; \
+	m_nativeInterface.Get##Name##ArrayRegion = &impl::getArrayRegion<Type>; \
+	m_nativeInterface.Set##Name##ArrayRegion = &impl::setArrayRegion<Type>;
+
+	FAKE_JVM_ARRAYS(Boolean, jboolean, 'Z')
+	FAKE_JVM_ARRAYS(Byte, jbyte, 'B')
+	FAKE_JVM_ARRAYS(Char, jchar, 'C')
+	FAKE_JVM_ARRAYS(Short, jshort, 'S')
+	FAKE_JVM_ARRAYS(Int, jint, 'I')
+	FAKE_JVM_ARRAYS(Long, jlong, 'J')
+	FAKE_JVM_ARRAYS(Float, jfloat, 'F')
+	FAKE_JVM_ARRAYS(Double, jdouble, 'D')
+
+#undef FAKE_JVM_ARRAYS
+
+	m_invokeInterface.DestroyJavaVM = &impl::destroyJavaVM;
+	m_invokeInterface.AttachCurrentThread = &impl::attachCurrentThread;
+	m_invokeInterface.AttachCurrentThreadAsDaemon = &impl::attachCurrentThread;
+	m_invokeInterface.DetachCurrentThread = &impl::detachCurrentThread;
+	m_invokeInterface.GetEnv = &impl::getEnv;
+}
+
+void FakeJVM::defineBaseClasses() {
+	auto& object = defineClass("java/lang/Object");
+	defineClass("java/lang/String", &object);
+
+	auto& classClass = defineClass("java/lang/Class", &object);
+	classClass.addMethod("getName", "()Ljava/lang/String;", [](CallContext& ctx) {
+		jvalue r{};
+		r.l = reinterpret_cast<jobject>(ctx.vm.newString(std::string_view(javaClassName(ctx.self->classValue))));
+		return r;
+	});
+
+	auto& throwable = defineClass("java/lang/Throwable", &object);
+	throwable.addMethod("getMessage", "()Ljava/lang/String;", [](CallContext& ctx) {
+		jvalue r{};
+		r.l = reinterpret_cast<jobject>(ctx.vm.newString(std::u16string_view(ctx.self->string)));
+		return r;
+	});
+
+	throwable.addMethod("toString", "()Ljava/lang/String;", [](CallContext& ctx) {
+		jvalue r{};
+		r.l = reinterpret_cast<jobject>(ctx.vm.newString(describeThrowable(ctx.self)));
+		return r;
+	});
+
+	// used by the library to format stack traces
+	auto& log = defineClass("android/util/Log", &object);
+	log.addStaticMethod("getStackTraceString", "(Ljava/lang/Throwable;)Ljava/lang/String;", [](CallContext& ctx) {
+		auto throwable = ctx.objectArg(0);
+
+		jvalue r{};
+		r.l = reinterpret_cast<jobject>(ctx.vm.newString(
+			throwable ? describeThrowable(throwable) + u"\n\tat fake_jvm.FakeJVM.call(Native Method)\n" : u""
+		));
+		return r;
+	});
+
+	auto& exception = defineClass("java/lang/Exception", &throwable);
+	auto& runtimeException = defineClass("java/lang/RuntimeException", &exception);
+	defineClass("java/lang/IndexOutOfBoundsException", &runtimeException);
+	defineClass("java/lang/ArrayIndexOutOfBoundsException", findClass("java/lang/IndexOutOfBoundsException"));
+	defineClass("java/lang/StringIndexOutOfBoundsException", findClass("java/lang/IndexOutOfBoundsException"));
+
+	auto& error = defineClass("java/lang/Error", &throwable);
+	auto& linkageError = defineClass("java/lang/LinkageError", &error);
+	defineClass("java/lang/NoClassDefFoundError", &linkageError);
+	defineClass("java/lang/NoSuchMethodError", &linkageError);
+	defineClass("java/lang/NoSuchFieldError", &linkageError);
+}
+
+JavaVM* FakeJVM::javaVM() {
+	return m_vm.get();
+}
+
+void FakeJVM::install() {
+	s_installed = this;
+	launcher_utils::jni::setJavaVMProvider(&provideInstalledVM);
+
+	attachCurrentThread();
+}
+
+void FakeJVM::uninstall() {
+	if (s_installed != this) {
+		return;
+	}
+
+	launcher_utils::jni::setJavaVMProvider(nullptr);
+	s_installed = nullptr;
+}
+
+JNIEnv* FakeJVM::attachCurrentThread() {
+	if (auto env = currentEnv()) {
+		return env;
+	}
+
+	std::scoped_lock lock(m_mutex);
+
+	auto& env = m_envs.emplace_back(std::make_unique<FakeEnv>());
+	env->functions = &m_nativeInterface;
+	env->vm = this;
+
+	t_env = env.get();
+
+	return env.get();
+}
+
+void FakeJVM::detachCurrentThread() {
+	auto env = currentEnv();
+	if (!env) {
+		return;
+	}
+
+	t_env = nullptr;
+
+	setPendingException(env, nullptr);
+	for (auto& ref : env->refs) {
+		if (ref.live) {
+			ref.live = false;
+			release(ref.object);
+		}
+	}
+
+	std::scoped_lock lock(m_mutex);
+	std::erase_if(m_envs, [env](const auto& x) {
+		return x.get() == env;
+	});
+}
+
+FakeEnv* FakeJVM::currentEnv() const {
+	return t_env && t_env->vm == this ? t_env : nullptr;
+}
+
+FakeClass& FakeJVM::defineClass(std::string_view name, FakeClass* superclass) {
+	std::scoped_lock lock(m_mutex);
+
+	auto& cls = m_classes.emplace_back();
+	cls.name = name;
+	cls.superclass = superclass;
+
+	auto classClass = findClass("java/lang/Class");
+	cls.object = newObject(classClass ? *classClass : cls);
+	cls.object->kind = ObjectKind::Class;
+	cls.object->classValue = &cls;
+	cls.object->pinned = true;
+
+	return cls;
+}
+
+FakeClass* FakeJVM::findClass(std::string_view name) {
+	std::scoped_lock lock(m_mutex);
+
+	for (auto& cls : m_classes) {
+		if (cls.name == name) {
+			return &cls;
+		}
+	}
+
+	return nullptr;
+}
+
+FakeObject* FakeJVM::newObject(FakeClass& cls, std::int64_t userData) {
+	std::scoped_lock lock(m_mutex);
+
+	auto owned = std::make_unique<FakeObject>();
+	auto object = owned.get();
+	m_objects.emplace(object, std::move(owned));
+
+	object->cls = &cls;
+	object->kind = ObjectKind::Instance;
+	object->userData = userData;
+
+	return object;
+}
+
+FakeObject* FakeJVM::newString(std::u16string_view str) {
+	auto object = newObject(*findClass("java/lang/String"));
+	object->kind = ObjectKind::String;
+	object->string = str;
+
+	return object;
+}
+
+FakeObject* FakeJVM::newString(std::string_view ascii) {
+	return newString(widen(ascii));
+}
+
+FakeObject* FakeJVM::newArray(char elementType, std::size_t length, std::size_t elementSize) {
+	auto object = newObject(*findClass("java/lang/Object"));
+	object->kind = ObjectKind::Array;
+	object->elementType = elementType;
+	object->length = length;
+	object->elements.resize(length * elementSize);
+
+	return object;
+}
+
+void FakeJVM::throwException(std::string_view className, std::u16string_view message) {
+	auto env = currentEnv();
+	if (!env) {
+		return;
+	}
+
+	auto cls = findClass(className);
+	auto exception = newObject(cls ? *cls : *findClass("java/lang/RuntimeException"));
+	exception->string = message;
+
+	setPendingException(env, exception);
+	m_exceptionsThrown++;
+}
+
+bool FakeJVM::injectException(std::string_view className, std::string_view methodName, std::string_view message) {
+	auto cls = findClass(className);
+	if (!cls) {
+		return false;
+	}
+
+	for (auto& method : cls->methods) {
+		if (method.name == methodName) {
+			method.injectedException = message;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool FakeJVM::setLatency(std::string_view className, std::string_view methodName, std::chrono::nanoseconds latency) {
+	auto cls = findClass(className);
+	if (!cls) {
+		return false;
+	}
+
+	auto found = false;
+	for (auto& method : cls->methods) {
+		if (method.name == methodName) {
+			method.latency = latency;
+			found = true;
+		}
+	}
+
+	return found;
+}
+
+std::uint64_t FakeJVM::callCount(std::string_view className, std::string_view methodName) {
+	auto cls = findClass(className);
+	if (!cls) {
+		return 0;
+	}
+
+	std::uint64_t count = 0;
+	for (auto& method : cls->methods) {
+		if (method.name == methodName) {
+			count += method.callCount.load(std::memory_order_relaxed);
+		}
+	}
+
+	return count;
+}
+
+RefStats FakeJVM::refStats() const {
+	RefStats stats{};
+
+	if (auto env = currentEnv()) {
+		stats.liveLocalRefs = env->liveLocalRefs;
+	}
+
+	{
+		std::scoped_lock lock(m_mutex);
+		stats.liveObjects = m_objects.size();
+		stats.liveGlobalRefs = m_liveGlobalRefs;
+	}
+
+	stats.localRefsCreated = m_localRefsCreated.load(std::memory_order_relaxed);
+	stats.localRefsDeleted = m_localRefsDeleted.load(std::memory_order_relaxed);
+	stats.globalRefsCreated = m_globalRefsCreated.load(std::memory_order_relaxed);
+	stats.globalRefsDeleted = m_globalRefsDeleted.load(std::memory_order_relaxed);
+	stats.exceptionsThrown = m_exceptionsThrown.load(std::memory_order_relaxed);
+
+	return stats;
+}
+
+jobject FakeJVM::newLocalRef(FakeEnv* env, FakeObject* object) {
+	if (!object) {
+		return nullptr;
+	}
+
+	Ref* ref{};
+	if (!env->freeRefs.empty()) {
+		ref = env->freeRefs.back();
+		env->freeRefs.pop_back();
+	} else {
+		ref = &env->refs.emplace_back();
+	}
+
+	retain(object);
+
+	ref->object = object;
+	ref->type = JNILocalRefType;
+	ref->live = true;
+	ref->serial++;
+
+	auto& frame = env->frames.back();
+	frame.emplace_back(ref, ref->serial);
+
+	// drop entries of deleted references once in a while, so out of order deletes can't grow the frame forever
+	if (frame.size() >= 1024 && (frame.size() & (frame.size() - 1)) == 0) {
+		std::erase_if(frame, [](const auto& entry) {
+			return !entry.first->live || entry.first->serial != entry.second;
+		});
+	}
+
+	env->liveLocalRefs++;
+	m_localRefsCreated.fetch_add(1, std::memory_order_relaxed);
+
+	return reinterpret_cast<jobject>(ref);
+}
+
+void FakeJVM::deleteLocalRef(FakeEnv* env, jobject obj) {
+	auto ref = reinterpret_cast<Ref*>(obj);
+	if (!ref || !ref->live || ref->type != JNILocalRefType) {
+		return;
+	}
+
+	ref->live = false;
+	release(ref->object);
+	env->freeRefs.push_back(ref);
+	env->liveLocalRefs--;
+	m_localRefsDeleted.fetch_add(1, std::memory_order_relaxed);
+
+	// references are usually deleted in reverse order of creation, keep the frame short in that case
+	auto& frame = env->frames.back();
+	while (!frame.empty() && (!frame.back().first->live || frame.back().first->serial != frame.back().second)) {
+		frame.pop_back();
+	}
+}
+
+jobject FakeJVM::newGlobalRef(FakeObject* object) {
+	if (!object) {
+		return nullptr;
+	}
+
+	std::scoped_lock lock(m_mutex);
+
+	Ref* ref{};
+	if (!m_freeGlobalRefs.empty()) {
+		ref = m_freeGlobalRefs.back();
+		m_freeGlobalRefs.pop_back();
+	} else {
+		ref = &m_globalRefs.emplace_back();
+	}
+
+	retain(object);
+
+	ref->object = object;
+	ref->type = JNIGlobalRefType;
+	ref->live = true;
+	ref->serial++;
+
+	m_liveGlobalRefs++;
+	m_globalRefsCreated.fetch_add(1, std::memory_order_relaxed);
+
+	return reinterpret_cast<jobject>(ref);
+}
+
+void FakeJVM::deleteGlobalRef(jobject obj) {
+	auto ref = reinterpret_cast<Ref*>(obj);
+	if (!ref) {
+		return;
+	}
+
+	std::scoped_lock lock(m_mutex);
+
+	if (!ref->live || ref->type != JNIGlobalRefType) {
+		return;
+	}
+
+	ref->live = false;
+	release(ref->object);
+	m_freeGlobalRefs.push_back(ref);
+
+	m_liveGlobalRefs--;
+	m_globalRefsDeleted.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FakeJVM::setPendingException(FakeEnv* env, FakeObject* exception) {
+	if (exception) {
+		retain(exception);
+	}
+
+	if (auto previous = std::exchange(env->pendingException, exception)) {
+		release(previous);
+	}
+}
+
+void FakeJVM::storeObject(jvalue& slot, FakeObject* object) {
+	if (object) {
+		retain(object);
+	}
+
+	if (auto previous = reinterpret_cast<FakeObject*>(std::exchange(slot.l, reinterpret_cast<jobject>(object)))) {
+		release(previous);
+	}
+}
+
+bool FakeJVM::setField(FakeObject* object, std::string_view name, jvalue value) {
+	auto isStatic = object->kind == ObjectKind::Class;
+	auto cls = isStatic ? object->classValue : object->cls;
+
+	for (auto c = cls; c != nullptr; c = c->superclass) {
+		for (auto& field : c->fields) {
+			if (field.isStatic != isStatic || field.name != name) {
+				continue;
+			}
+
+			auto& slot = isStatic ? field.staticValue : object->fields[&field];
+			if (field.isObject()) {
+				storeObject(slot, reinterpret_cast<FakeObject*>(value.l));
+			} else {
+				slot = value;
+			}
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+jvalue FakeJVM::getField(FakeObject* object, std::string_view name) {
+	auto isStatic = object->kind == ObjectKind::Class;
+	auto cls = isStatic ? object->classValue : object->cls;
+
+	for (auto c = cls; c != nullptr; c = c->superclass) {
+		for (auto& field : c->fields) {
+			if (field.isStatic == isStatic && field.name == name) {
+				return isStatic ? field.staticValue : object->fields[&field];
+			}
+		}
+	}
+
+	return jvalue{};
+}
+
+void FakeJVM::retain(FakeObject* object) {
+	object->refCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FakeJVM::release(FakeObject* object) {
+	if (object->refCount.fetch_sub(1, std::memory_order_acq_rel) != 1 || object->pinned) {
+		return;
+	}
+
+	std::unique_ptr<FakeObject> owned{};
+	{
+		std::scoped_lock lock(m_mutex);
+
+		auto it = m_objects.find(object);
+		if (it == m_objects.end()) {
+			return;
+		}
+
+		owned = std::move(it->second);
+		m_objects.erase(it);
+	}
+
+	// objects stored in fields are only released once the holder is gone
+	for (auto& [field, value] : owned->fields) {
+		if (field->isObject() && value.l != nullptr) {
+			release(reinterpret_cast<FakeObject*>(value.l));
+		}
+	}
+}
+
+FakeObject* FakeJVM::deref(jobject obj) {
+	auto ref = reinterpret_cast<Ref*>(obj);
+	return ref && ref->live ? ref->object : nullptr;
+}
+
+FakeDevice* FakeJVM::findDevice(int id) {
+	for (auto& device : devices) {
+		if (device.id == id) {
+			return &device;
+		}
+	}
+
+	return nullptr;
+}
+
+void FakeJVM::installLauncherClasses() {
+	auto& object = *findClass("java/lang/Object");
+	auto& inputDevice = defineClass("android/view/InputDevice", &object);
+	auto& utils = defineClass("com/geode/launcher/utils/GeodeUtils", &object);
+
+	auto deviceOf = [this](CallContext& ctx) {
+		return findDevice(static_cast<int>(ctx.self->userData));
+	};
+
+	auto deviceArg = [this](CallContext& ctx) {
+		return findDevice(ctx.args[0].i);
+	};
+
+	inputDevice.addMethod("getDescriptor", "()Ljava/lang/String;", [this, deviceOf](CallContext& ctx) {
+		jvalue r{};
+		if (auto device = deviceOf(ctx)) {
+			r.l = reinterpret_cast<jobject>(newString(std::string_view(device->descriptor)));
+		}
+		return r;
+	});
+
+	inputDevice.addMethod("getName", "()Ljava/lang/String;", [this, deviceOf](CallContext& ctx) {
+		jvalue r{};
+		if (auto device = deviceOf(ctx)) {
+			r.l = reinterpret_cast<jobject>(newString(std::string_view(device->name)));
+		}
+		return r;
+	});
+
+	inputDevice.addMethod("getVendorId", "()I", [deviceOf](CallContext& ctx) {
+		jvalue r{};
+		if (auto device = deviceOf(ctx)) {
+			r.i = device->vendorId;
+		}
+		return r;
+	});
+
+	inputDevice.addMethod("getProductId", "()I", [deviceOf](CallContext& ctx) {
+		jvalue r{};
+		if (auto device = deviceOf(ctx)) {
+			r.i = device->productId;
+		}
+		return r;
+	});
+
+	inputDevice.addMethod("getSources", "()I", [deviceOf](CallContext& ctx) {
+		jvalue r{};
+		if (auto device = deviceOf(ctx)) {
+			r.i = device->sources;
+		}
+		return r;
+	});
+
+	auto& motionRange = defineClass("android/view/InputDevice$MotionRange", &object);
+
+	// the platform class keeps the values in private fields, each with a public getter
+	for (auto [getter, name, signature] : {
+		std::tuple{"getAxis", "mAxis", "I"},
+		std::tuple{"getSource", "mSource", "I"},
+		std::tuple{"getMin", "mMin", "F"},
+		std::tuple{"getMax", "mMax", "F"},
+		std::tuple{"getFlat", "mFlat", "F"},
+		std::tuple{"getFuzz", "mFuzz", "F"},
+		std::tuple{"getResolution", "mResolution", "F"}
+	}) {
+		auto field = &motionRange.addField(name, signature);
+		motionRange.addMethod(getter, std::string("()") + signature, [field](CallContext& ctx) {
+			return ctx.self->fields[field];
+		});
+	}
+
+	inputDevice.addMethod("getMotionRange", "(I)Landroid/view/InputDevice$MotionRange;", [this, deviceOf, &motionRange](CallContext& ctx) {
+		jvalue r{};
+
+		auto device = deviceOf(ctx);
+		if (!device) {
+			return r;
+		}
+
+		for (const auto& range : device->motionRanges) {
+			if (range.axis != ctx.args[0].i) {
+				continue;
+			}
+
+			auto obj = newObject(motionRange);
+			auto set = [this, obj](std::string_view name, jvalue value) {
+				setField(obj, name, value);
+			};
+
+			set("mAxis", jvalue{.i = range.axis});
+			set("mSource", jvalue{.i = range.source});
+			set("mMin", jvalue{.f = range.min});
+			set("mMax", jvalue{.f = range.max});
+			set("mFlat", jvalue{.f = range.flat});
+			set("mFuzz", jvalue{.f = range.fuzz});
+			set("mResolution", jvalue{.f = range.resolution});
+
+			r.l = reinterpret_cast<jobject>(obj);
+			break;
+		}
+
+		return r;
+	});
+
+	utils.addStaticMethod("controllersConnected", "()I", [this](CallContext&) {
+		constexpr int controllerSources = 0x00000401 | 0x01000010;
+
+		jvalue r{};
+		r.i = static_cast<jint>(std::count_if(devices.begin(), devices.end(), [](const FakeDevice& device) {
+			return (device.sources & controllerSources) != 0;
+		}));
+		return r;
+	});
+
+	utils.addStaticMethod("getConnectedDevices", "()[I", [this](CallContext&) {
+		std::vector<jint> ids{};
+		for (const auto& device : devices) {
+			ids.push_back(device.id);
+		}
+
+		jvalue r{};
+		r.l = reinterpret_cast<jobject>(newArray('I', ids));
+		return r;
+	});
+
+	utils.addStaticMethod("vibrateSupported", "()Z", [this](CallContext&) {
+		jvalue r{};
+		r.z = vibrateSupported;
+		return r;
+	});
+
+	utils.addStaticMethod("vibrate", "(J)V", [this](CallContext& ctx) {
+		lastVibrationMs = ctx.args[0].j;
+		return jvalue{};
+	});
+
+	utils.addStaticMethod("vibratePattern", "([JI)V", [this](CallContext& ctx) {
+		auto pattern = ctx.objectArg(0);
+
+		lastVibrationPattern.resize(pattern->length);
+		std::memcpy(lastVibrationPattern.data(), pattern->elements.data(), pattern->length * sizeof(std::int64_t));
+
+		return jvalue{};
+	});
+
+	utils.addStaticMethod("getDevice", "(I)Landroid/view/InputDevice;", [this, deviceArg, &inputDevice](CallContext& ctx) {
+		jvalue r{};
+		if (auto device = deviceArg(ctx)) {
+			r.l = reinterpret_cast<jobject>(newObject(inputDevice, device->id));
+		}
+		return r;
+	});
+
+	utils.addStaticMethod("getDeviceBatteryCapacity", "(I)F", [deviceArg](CallContext& ctx) {
+		jvalue r{};
+		if (auto device = deviceArg(ctx)) {
+			r.f = device->batteryCapacity;
+		}
+		return r;
+	});
+
+	utils.addStaticMethod("getDeviceBatteryStatus", "(I)I", [deviceArg](CallContext& ctx) {
+		jvalue r{};
+		r.i = 1;
+		if (auto device = deviceArg(ctx)) {
+			r.i = device->batteryStatus;
+		}
+		return r;
+	});
+
+	utils.addStaticMethod("deviceHasBattery", "(I)Z", [deviceArg](CallContext& ctx) {
+		jvalue r{};
+		if (auto device = deviceArg(ctx)) {
+			r.z = device->hasBattery;
+		}
+		return r;
+	});
+
+	utils.addStaticMethod("getDeviceLightsCount", "(I)I", [deviceArg](CallContext& ctx) {
+		jvalue r{};
+		if (auto device = deviceArg(ctx)) {
+			r.i = device->lightCount;
+		}
+		return r;
+	});
+
+	utils.addStaticMethod("getLightType", "(I)I", [deviceArg](CallContext& ctx) {
+		jvalue r{};
+		if (auto device = deviceArg(ctx)) {
+			r.i = device->lightType;
+		}
+		return r;
+	});
+
+	utils.addStaticMethod("setDeviceLightColor", "(III)Z", [deviceArg](CallContext& ctx) {
+		jvalue r{};
+		if (auto device = deviceArg(ctx); device && device->lightCount > 0) {
+			device->lightColor = static_cast<std::uint32_t>(ctx.args[1].i);
+			r.z = JNI_TRUE;
+		}
+		return r;
+	});
+
+	utils.addStaticMethod("getDeviceHapticsCount", "(I)I", [deviceArg](CallContext& ctx) {
+		jvalue r{};
+		if (auto device = deviceArg(ctx)) {
+			r.i = device->motorCount;
+		}
+		return r;
+	});
+
+	utils.addStaticMethod("vibrateDevice", "(IJII)Z", [deviceArg](CallContext& ctx) {
+		jvalue r{};
+		if (auto device = deviceArg(ctx); device && device->motorCount > 0) {
+			device->lastVibrationMs = ctx.args[1].j;
+			device->lastVibrationIntensity = ctx.args[2].i;
+			device->lastVibrationMotor = ctx.args[3].i;
+			r.z = JNI_TRUE;
+		}
+		return r;
+	});
+}
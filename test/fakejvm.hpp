@@ -0,0 +1,319 @@
+#pragma once
+
+#include <jni.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * An in-process stand-in for the JVM, implementing the JNI function table on top of plain C++ objects.
+ * It only depends on jni.h, so it can run anywhere the library builds, and gives reproducible timings
+ * for the library's own overhead, independent of ART.
+ */
+namespace fake_jvm {
+	using NativeInterface = std::remove_const_t<std::remove_pointer_t<decltype(JNIEnv::functions)>>;
+	using InvokeInterface = std::remove_const_t<std::remove_pointer_t<decltype(JavaVM::functions)>>;
+
+	class FakeJVM;
+	struct FakeClass;
+	struct FakeField;
+
+	enum class ObjectKind {
+		Instance,
+		Class,
+		String,
+		Array
+	};
+
+	struct FakeObject {
+		FakeClass* cls{};
+		ObjectKind kind{};
+
+		/** Contents of strings, or the message of a throwable. */
+		std::u16string string{};
+
+		/** Signature character of an array's element type. */
+		char elementType{};
+		std::size_t length{};
+		std::vector<std::byte> elements{};
+
+		/** Free for use by method implementations, for example the id of an InputDevice. */
+		std::int64_t userData{};
+
+		/** The class represented by a class object. */
+		FakeClass* classValue{};
+
+		/** Values of instance fields. Objects are stored as FakeObject pointers in `jvalue::l`, and hold a reference. */
+		std::unordered_map<const FakeField*, jvalue> fields{};
+
+		/** References and pending exceptions pointing at this object. It is freed once this drops back to zero. */
+		std::atomic_uint32_t refCount{0};
+
+		/** Pinned objects, such as class objects, are never freed. */
+		bool pinned{};
+	};
+
+	struct CallContext {
+		FakeJVM& vm;
+		JNIEnv* env;
+		FakeObject* self;
+		const jvalue* args;
+
+		FakeObject* objectArg(std::size_t idx) const;
+	};
+
+	/**
+	 * Implementation of a fake method.
+	 * Object results are returned as FakeObject pointers in `jvalue::l`; the VM turns them into local references.
+	 */
+	using MethodImpl = std::function<jvalue(CallContext&)>;
+
+	struct FakeMethod {
+		FakeClass* owner{};
+		std::string name{};
+		std::string signature{};
+		bool isStatic{};
+		MethodImpl impl{};
+
+		std::atomic_uint64_t callCount{0};
+
+		/** When set, the next call throws a RuntimeException with this message instead of running. */
+		std::string injectedException{};
+
+		/** Time every call sleeps for, standing in for the platform work behind the method. */
+		std::chrono::nanoseconds latency{};
+	};
+
+	struct FakeField {
+		FakeClass* owner{};
+		std::string name{};
+		std::string signature{};
+		bool isStatic{};
+
+		/** Value of a static field, stored like instance field values. */
+		jvalue staticValue{};
+
+		bool isObject() const {
+			return signature.starts_with('L') || signature.starts_with('[');
+		}
+	};
+
+	struct FakeClass {
+		std::string name{};
+		FakeClass* superclass{};
+		FakeObject* object{};
+		std::deque<FakeMethod> methods{};
+		std::deque<FakeField> fields{};
+
+		FakeMethod& addMethod(std::string_view name, std::string_view signature, MethodImpl impl);
+		FakeMethod& addStaticMethod(std::string_view name, std::string_view signature, MethodImpl impl);
+		FakeMethod* findMethod(std::string_view name, std::string_view signature, bool isStatic);
+
+		FakeField& addField(std::string_view name, std::string_view signature);
+		FakeField& addStaticField(std::string_view name, std::string_view signature);
+
+		/**
+		 * Finds a field of this class or one of its superclasses.
+		 */
+		FakeField* findField(std::string_view name, std::string_view signature, bool isStatic);
+	};
+
+	struct RefStats {
+		std::size_t liveObjects{};
+		std::size_t liveLocalRefs{};
+		std::size_t liveGlobalRefs{};
+		std::uint64_t localRefsCreated{};
+		std::uint64_t localRefsDeleted{};
+		std::uint64_t globalRefsCreated{};
+		std::uint64_t globalRefsDeleted{};
+		std::uint64_t exceptionsThrown{};
+	};
+
+	struct FakeMotionRange {
+		int axis{};
+		int source{};
+		float min{};
+		float max{};
+		float flat{};
+		float fuzz{};
+		float resolution{};
+	};
+
+	/**
+	 * State backing the fake `com/geode/launcher/utils/GeodeUtils` and `android/view/InputDevice` classes.
+	 */
+	struct FakeDevice {
+		int id{};
+		std::string name{};
+		std::string descriptor{};
+		int vendorId{};
+		int productId{};
+		int sources{};
+
+		bool hasBattery{};
+		float batteryCapacity{};
+		int batteryStatus{1};
+
+		int lightCount{};
+		int lightType{};
+		std::uint32_t lightColor{};
+
+		int motorCount{};
+		std::int64_t lastVibrationMs{};
+		int lastVibrationIntensity{};
+		int lastVibrationMotor{};
+
+		std::vector<FakeMotionRange> motionRanges{};
+	};
+
+	/** Backing storage of a local or global reference; a `jobject` points at one of these. */
+	struct Ref {
+		FakeObject* object{};
+		jobjectRefType type{};
+		bool live{};
+		std::uint32_t serial{};
+	};
+
+	struct FakeEnv;
+	struct FakeVMHandle;
+
+	class FakeJVM final {
+		NativeInterface m_nativeInterface{};
+		InvokeInterface m_invokeInterface{};
+		std::unique_ptr<FakeVMHandle> m_vm;
+
+		mutable std::recursive_mutex m_mutex{};
+		std::deque<FakeClass> m_classes{};
+		std::unordered_map<FakeObject*, std::unique_ptr<FakeObject>> m_objects{};
+		std::deque<std::unique_ptr<FakeEnv>> m_envs{};
+		std::deque<Ref> m_globalRefs{};
+		std::vector<Ref*> m_freeGlobalRefs{};
+		std::size_t m_liveGlobalRefs{};
+
+		std::atomic_uint64_t m_localRefsCreated{0};
+		std::atomic_uint64_t m_localRefsDeleted{0};
+		std::atomic_uint64_t m_globalRefsCreated{0};
+		std::atomic_uint64_t m_globalRefsDeleted{0};
+		std::atomic_uint64_t m_exceptionsThrown{0};
+
+		void buildInterfaces();
+		void defineBaseClasses();
+
+	public:
+		std::vector<FakeDevice> devices{};
+		bool vibrateSupported{true};
+		std::int64_t lastVibrationMs{};
+		std::vector<std::int64_t> lastVibrationPattern{};
+
+		FakeJVM();
+		~FakeJVM();
+
+		FakeJVM(const FakeJVM&) = delete;
+		FakeJVM& operator=(const FakeJVM&) = delete;
+
+		JavaVM* javaVM();
+
+		/**
+		 * Makes this VM the one returned to launcher_utils::jni::getEnv, and attaches the calling thread.
+		 * Only one fake VM can be installed at a time.
+		 */
+		void install();
+
+		/**
+		 * Restores the launcher's JavaVM.
+		 */
+		void uninstall();
+
+		JNIEnv* attachCurrentThread();
+		void detachCurrentThread();
+
+		/**
+		 * Returns the environment of the calling thread, or nullptr if it isn't attached.
+		 */
+		FakeEnv* currentEnv() const;
+
+		FakeClass& defineClass(std::string_view name, FakeClass* superclass = nullptr);
+		FakeClass* findClass(std::string_view name);
+
+		/**
+		 * Creates an object. It is freed after the last reference to it is deleted; objects that are never referenced live as long as the VM.
+		 */
+		FakeObject* newObject(FakeClass& cls, std::int64_t userData = 0);
+		FakeObject* newString(std::u16string_view str);
+		FakeObject* newString(std::string_view ascii);
+		FakeObject* newArray(char elementType, std::size_t length, std::size_t elementSize);
+
+		template <typename T>
+		FakeObject* newArray(char elementType, const std::vector<T>& values) {
+			auto array = newArray(elementType, values.size(), sizeof(T));
+			std::memcpy(array->elements.data(), values.data(), values.size() * sizeof(T));
+			return array;
+		}
+
+		/**
+		 * Sets a field of an object, or a static field if `object` is a class object. Objects are passed as FakeObject pointers.
+		 */
+		bool setField(FakeObject* object, std::string_view name, jvalue value);
+
+		/**
+		 * Reads a field of an object, or a static field if `object` is a class object. Objects are returned as FakeObject pointers.
+		 */
+		jvalue getField(FakeObject* object, std::string_view name);
+
+		/**
+		 * Sets a pending exception of the given class on the calling thread.
+		 */
+		void throwException(std::string_view className, std::u16string_view message);
+
+		/**
+		 * Makes the next call of the given method throw a RuntimeException.
+		 */
+		bool injectException(std::string_view className, std::string_view methodName, std::string_view message);
+
+		/**
+		 * Makes every call of the given method take at least `latency`, like a call into a system service would.
+		 */
+		bool setLatency(std::string_view className, std::string_view methodName, std::chrono::nanoseconds latency);
+
+		/**
+		 * Returns how often a method was called, or 0 if it doesn't exist.
+		 */
+		std::uint64_t callCount(std::string_view className, std::string_view methodName);
+
+		/**
+		 * Reference counts. Local references are counted for the calling thread only.
+		 */
+		RefStats refStats() const;
+
+		/**
+		 * Defines `com/geode/launcher/utils/GeodeUtils`, `android/view/InputDevice` and `android/view/InputDevice$MotionRange`,
+		 * backed by `devices`.
+		 */
+		void installLauncherClasses();
+
+		FakeDevice* findDevice(int id);
+
+		// internal, used by the function table
+		jobject newLocalRef(FakeEnv* env, FakeObject* object);
+		jobject newGlobalRef(FakeObject* object);
+		void deleteLocalRef(FakeEnv* env, jobject ref);
+		void deleteGlobalRef(jobject ref);
+		void setPendingException(FakeEnv* env, FakeObject* exception);
+		void storeObject(jvalue& slot, FakeObject* object);
+		void retain(FakeObject* object);
+		void release(FakeObject* object);
+		static FakeObject* deref(jobject ref);
+	};
+}
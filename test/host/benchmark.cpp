@@ -0,0 +1,39 @@
+#include <fmt/format.h>
+
+#include "../benchmarks.hpp"
+
+#include <cstdio>
+
+/**
+ * Runs the benchmark suite on the host, writing the JSON results to the path given as the first argument, or stdout.
+ * Summary lines go to stderr, so stdout stays valid JSON.
+ */
+int main(int argc, char** argv) {
+	auto report = runBenchmarks();
+
+	for (const auto& result : report.results) {
+		fmt::print(stderr, "{}: {:.1f}ns (min {:.1f}ns)\n", result.name, result.medianNs, result.minNs);
+	}
+
+	for (const auto& note : report.notes) {
+		fmt::print(stderr, "{}\n", note);
+	}
+
+	auto json = report.toJson();
+
+	if (argc < 2) {
+		fmt::print("{}\n", json);
+		return 0;
+	}
+
+	auto file = std::fopen(argv[1], "w");
+	if (!file) {
+		fmt::print(stderr, "failed to open {}\n", argv[1]);
+		return 1;
+	}
+
+	fmt::print(file, "{}\n", json);
+	std::fclose(file);
+
+	return 0;
+}
@@ -0,0 +1,187 @@
+#pragma once
+
+// Host stand-in for the subset of geode::Result used by the library and its tests.
+
+#include <functional>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace geode {
+	template <typename T>
+	struct OkValue {
+		T value;
+	};
+
+	template <>
+	struct OkValue<void> {};
+
+	template <typename E>
+	struct ErrValue {
+		E value;
+	};
+
+	/**
+	 * An lvalue is passed on by reference, so a Result<T&> can be built from it and a Result<T> copies it.
+	 */
+	template <typename T>
+	OkValue<T> Ok(T&& value) {
+		return {std::forward<T>(value)};
+	}
+
+	inline OkValue<void> Ok() {
+		return {};
+	}
+
+	template <typename E>
+	ErrValue<std::remove_cvref_t<E>> Err(E&& error) {
+		return {std::forward<E>(error)};
+	}
+
+	inline ErrValue<std::string> Err(const char* error) {
+		return {error};
+	}
+
+	template <typename T = void, typename E = std::string>
+	class Result {
+		using Stored = std::conditional_t<std::is_reference_v<T>, std::reference_wrapper<std::remove_reference_t<T>>, T>;
+
+		std::variant<Stored, E> m_value;
+
+	public:
+		template <typename U>
+		requires std::is_constructible_v<Stored, U&&>
+		Result(OkValue<U>&& ok) : m_value(std::in_place_index<0>, std::forward<U>(ok.value)) {}
+
+		template <typename U>
+		Result(ErrValue<U>&& err) : m_value(std::in_place_index<1>, std::move(err.value)) {}
+
+		bool isOk() const {
+			return m_value.index() == 0;
+		}
+
+		bool isErr() const {
+			return m_value.index() == 1;
+		}
+
+		explicit operator bool() const {
+			return isOk();
+		}
+
+		decltype(auto) unwrap() & {
+			if constexpr (std::is_reference_v<T>) {
+				return std::get<0>(m_value).get();
+			} else {
+				return (std::get<0>(m_value));
+			}
+		}
+
+		decltype(auto) unwrap() && {
+			if constexpr (std::is_reference_v<T>) {
+				return std::get<0>(m_value).get();
+			} else {
+				return std::move(std::get<0>(m_value));
+			}
+		}
+
+		decltype(auto) operator*() {
+			return unwrap();
+		}
+
+		auto operator->() {
+			return &unwrap();
+		}
+
+		E& unwrapErr() & {
+			return std::get<1>(m_value);
+		}
+
+		E unwrapErr() && {
+			return std::move(std::get<1>(m_value));
+		}
+
+		T unwrapOrDefault() requires (!std::is_reference_v<T>) {
+			return isOk() ? std::get<0>(m_value) : T{};
+		}
+
+		template <typename U>
+		T unwrapOr(U&& fallback) requires (!std::is_reference_v<T>) {
+			return isOk() ? std::get<0>(m_value) : T(std::forward<U>(fallback));
+		}
+
+		template <typename F>
+		auto mapErr(F&& f) && -> Result<T, std::invoke_result_t<F, E&&>> {
+			if (isOk()) {
+				if constexpr (std::is_reference_v<T>) {
+					return Ok(std::get<0>(m_value).get());
+				} else {
+					return Ok(std::move(std::get<0>(m_value)));
+				}
+			}
+
+			return Err(f(std::move(std::get<1>(m_value))));
+		}
+	};
+
+	template <typename E>
+	class Result<void, E> {
+		std::optional<E> m_error{};
+
+	public:
+		Result(OkValue<void>&&) {}
+
+		template <typename U>
+		Result(ErrValue<U>&& err) : m_error(std::move(err.value)) {}
+
+		bool isOk() const {
+			return !m_error.has_value();
+		}
+
+		bool isErr() const {
+			return m_error.has_value();
+		}
+
+		explicit operator bool() const {
+			return isOk();
+		}
+
+		void unwrap() {}
+
+		E& unwrapErr() & {
+			return *m_error;
+		}
+
+		E unwrapErr() && {
+			return std::move(*m_error);
+		}
+
+		template <typename F>
+		auto mapErr(F&& f) && -> Result<void, std::invoke_result_t<F, E&&>> {
+			if (isOk()) {
+				return Ok();
+			}
+
+			return Err(f(std::move(*m_error)));
+		}
+	};
+}
+
+#define GEODE_RESULT_CONCAT2(a, b) a##b
+#define GEODE_RESULT_CONCAT(a, b) GEODE_RESULT_CONCAT2(a, b)
+
+#define GEODE_UNWRAP(...) \
+	do { \
+		auto GEODE_RESULT_CONCAT(res_, __LINE__) = __VA_ARGS__; \
+		if (GEODE_RESULT_CONCAT(res_, __LINE__).isErr()) { \
+			return geode::Err(std::move(GEODE_RESULT_CONCAT(res_, __LINE__)).unwrapErr()); \
+		} \
+	} while (false)
+
+#define GEODE_UNWRAP_INTO(variable, ...) \
+	auto GEODE_RESULT_CONCAT(res_, __LINE__) = __VA_ARGS__; \
+	if (GEODE_RESULT_CONCAT(res_, __LINE__).isErr()) { \
+		return geode::Err(std::move(GEODE_RESULT_CONCAT(res_, __LINE__)).unwrapErr()); \
+	} \
+	variable = std::move(GEODE_RESULT_CONCAT(res_, __LINE__)).unwrap()
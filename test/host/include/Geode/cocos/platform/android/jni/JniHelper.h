@@ -0,0 +1,12 @@
+#pragma once
+
+// Host stand-in for cocos2d's JniHelper. There is no JavaVM on the host, tests install one with setJavaVMProvider.
+
+#include <jni.h>
+
+namespace cocos2d {
+	class JniHelper {
+	public:
+		static JavaVM* getJavaVM();
+	};
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+// Host stand-in for the Geode loader. Functions queued for the main thread run when the test calls runMainThreadQueue.
+
+#include <cstddef>
+#include <functional>
+
+namespace geode {
+	class Loader {
+	public:
+		static Loader* get();
+
+		void queueInMainThread(std::function<void()> func);
+	};
+}
+
+namespace host {
+	/**
+	 * Runs every function queued for the main thread so far, including ones queued while running, and returns how many ran.
+	 */
+	std::size_t runMainThreadQueue();
+}
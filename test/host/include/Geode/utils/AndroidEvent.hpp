@@ -0,0 +1,72 @@
+#pragma once
+
+// Host stand-in for Geode's Android input device events. Events are posted by tests with post or postInputDeviceEvent.
+
+#include <functional>
+
+namespace geode {
+	enum class ListenerResult {
+		Propagate,
+		Stop
+	};
+
+	class AndroidInputDeviceEvent {
+	public:
+		enum class Status {
+			Added,
+			Changed,
+			Removed
+		};
+
+	private:
+		int m_deviceId;
+		Status m_status;
+
+	public:
+		AndroidInputDeviceEvent(int deviceId, Status status) : m_deviceId(deviceId), m_status(status) {}
+
+		int deviceId() const {
+			return m_deviceId;
+		}
+
+		Status status() const {
+			return m_status;
+		}
+
+		/**
+		 * Delivers the event to every listener, like Geode's Event::post.
+		 */
+		ListenerResult post();
+	};
+
+	class AndroidInputDeviceFilter {
+	public:
+		using Callback = ListenerResult(AndroidInputDeviceEvent*);
+	};
+
+	template <typename Filter>
+	class EventListener;
+
+	template <>
+	class EventListener<AndroidInputDeviceFilter> {
+		std::function<AndroidInputDeviceFilter::Callback> m_callback;
+
+	public:
+		EventListener(std::function<AndroidInputDeviceFilter::Callback> callback, AndroidInputDeviceFilter filter = {});
+		~EventListener();
+
+		EventListener(const EventListener&) = delete;
+		EventListener& operator=(const EventListener&) = delete;
+
+		ListenerResult handle(AndroidInputDeviceEvent* event) {
+			return m_callback(event);
+		}
+	};
+}
+
+namespace host {
+	/**
+	 * Delivers an input device event to every listener, like Geode does from the launcher's callbacks.
+	 */
+	void postInputDeviceEvent(int deviceId, geode::AndroidInputDeviceEvent::Status status);
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+// Host stand-in for the string conversions from Geode's utilities.
+
+#include <Geode/Result.hpp>
+
+#include <string>
+#include <string_view>
+
+namespace geode::utils::string {
+	Result<std::string> utf16ToUtf8(std::u16string_view str);
+	Result<std::u16string> utf8ToUtf16(std::string_view str);
+}
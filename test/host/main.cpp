@@ -0,0 +1,54 @@
+#include <Geode/loader/Loader.hpp>
+#include <Geode/utils/AndroidEvent.hpp>
+#include <launcher-utils/geode.hpp>
+#include <launcher-utils/warmup.hpp>
+
+#include <fmt/format.h>
+
+#include "../checks.hpp"
+
+/**
+ * Runs the fake JVM checks on the host, failing if any check fails or a local reference is left behind.
+ */
+int main() {
+	// posted before anything has asked for a device, like a controller connected while the game starts
+	host::postInputDeviceEvent(99, geode::AndroidInputDeviceEvent::Status::Added);
+	auto changedEarly = launcher_utils::detail::getDeviceGeneration(99) != 0;
+
+	// runs what the library queued for the main thread as it was loaded. The VM outlives the checks,
+	// as the executor's worker stays attached to it until the checks install their own
+	fake_jvm::FakeJVM loadVM{};
+	loadVM.installLauncherClasses();
+	loadVM.install();
+
+	host::runMainThreadQueue();
+	launcher_utils::jni::Executor::get().drain();
+	host::runMainThreadQueue();
+
+	// everything a warm-up would resolve is already cached
+	auto warmedEntries = launcher_utils::jni::getCacheStats().entries;
+	auto warmup = launcher_utils::jni::warmUp();
+	auto warmedAtLoad = warmedEntries != 0 && warmup.isOk() && launcher_utils::jni::getCacheStats().entries == warmedEntries;
+
+	loadVM.uninstall();
+
+	auto results = runFakeJvmChecks();
+	if (!changedEarly) {
+		results.failures.push_back("device change before first snapshot");
+	}
+
+	if (!warmedAtLoad) {
+		results.failures.push_back("warm-up at load");
+	}
+
+	for (const auto& failure : results.failures) {
+		fmt::print(stderr, "FAILED: {}\n", failure);
+	}
+
+	fmt::print(
+		"fake jvm: {} failures, live local refs={}, local refs created={}, live global refs={}\n",
+		results.failures.size(), results.refs.liveLocalRefs, results.refs.localRefsCreated, results.refs.liveGlobalRefs
+	);
+
+	return results.failures.empty() && results.refs.liveLocalRefs == 0 ? 0 : 1;
+}
@@ -0,0 +1,180 @@
+#include <Geode/cocos/platform/android/jni/JniHelper.h>
+#include <Geode/loader/Loader.hpp>
+#include <Geode/utils/AndroidEvent.hpp>
+#include <Geode/utils/string.hpp>
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+namespace {
+	std::mutex s_mainQueueMutex{};
+	std::vector<std::function<void()>> s_mainQueue{};
+
+	std::mutex s_listenersMutex{};
+	std::vector<geode::EventListener<geode::AndroidInputDeviceFilter>*> s_listeners{};
+}
+
+JavaVM* cocos2d::JniHelper::getJavaVM() {
+	return nullptr;
+}
+
+geode::Loader* geode::Loader::get() {
+	static Loader s_loader{};
+	return &s_loader;
+}
+
+void geode::Loader::queueInMainThread(std::function<void()> func) {
+	std::scoped_lock lock(s_mainQueueMutex);
+	s_mainQueue.push_back(std::move(func));
+}
+
+std::size_t host::runMainThreadQueue() {
+	std::size_t count = 0;
+
+	while (true) {
+		std::vector<std::function<void()>> queue{};
+		{
+			std::scoped_lock lock(s_mainQueueMutex);
+			queue.swap(s_mainQueue);
+		}
+
+		if (queue.empty()) {
+			return count;
+		}
+
+		for (auto& func : queue) {
+			func();
+		}
+
+		count += queue.size();
+	}
+}
+
+geode::EventListener<geode::AndroidInputDeviceFilter>::EventListener(std::function<AndroidInputDeviceFilter::Callback> callback, AndroidInputDeviceFilter)
+	: m_callback(std::move(callback)) {
+	std::scoped_lock lock(s_listenersMutex);
+	s_listeners.push_back(this);
+}
+
+geode::EventListener<geode::AndroidInputDeviceFilter>::~EventListener() {
+	std::scoped_lock lock(s_listenersMutex);
+	std::erase(s_listeners, this);
+}
+
+geode::ListenerResult geode::AndroidInputDeviceEvent::post() {
+	std::vector<geode::EventListener<geode::AndroidInputDeviceFilter>*> listeners{};
+	{
+		std::scoped_lock lock(s_listenersMutex);
+		listeners = s_listeners;
+	}
+
+	for (auto listener : listeners) {
+		if (listener->handle(this) == geode::ListenerResult::Stop) {
+			return geode::ListenerResult::Stop;
+		}
+	}
+
+	return geode::ListenerResult::Propagate;
+}
+
+void host::postInputDeviceEvent(int deviceId, geode::AndroidInputDeviceEvent::Status status) {
+	geode::AndroidInputDeviceEvent(deviceId, status).post();
+}
+
+geode::Result<std::string> geode::utils::string::utf16ToUtf8(std::u16string_view str) {
+	std::string r{};
+	r.reserve(str.size());
+
+	for (std::size_t i = 0; i < str.size(); i++) {
+		std::uint32_t c = str[i];
+
+		if (c >= 0xd800 && c < 0xdc00) {
+			if (i + 1 >= str.size() || str[i + 1] < 0xdc00 || str[i + 1] >= 0xe000) {
+				return Err("utf16ToUtf8: unpaired surrogate");
+			}
+
+			c = 0x10000 + ((c - 0xd800) << 10) + (str[++i] - 0xdc00);
+		} else if (c >= 0xdc00 && c < 0xe000) {
+			return Err("utf16ToUtf8: unpaired surrogate");
+		}
+
+		if (c < 0x80) {
+			r += static_cast<char>(c);
+		} else if (c < 0x800) {
+			r += static_cast<char>(0xc0 | (c >> 6));
+			r += static_cast<char>(0x80 | (c & 0x3f));
+		} else if (c < 0x10000) {
+			r += static_cast<char>(0xe0 | (c >> 12));
+			r += static_cast<char>(0x80 | ((c >> 6) & 0x3f));
+			r += static_cast<char>(0x80 | (c & 0x3f));
+		} else {
+			r += static_cast<char>(0xf0 | (c >> 18));
+			r += static_cast<char>(0x80 | ((c >> 12) & 0x3f));
+			r += static_cast<char>(0x80 | ((c >> 6) & 0x3f));
+			r += static_cast<char>(0x80 | (c & 0x3f));
+		}
+	}
+
+	return Ok(std::move(r));
+}
+
+geode::Result<std::u16string> geode::utils::string::utf8ToUtf16(std::string_view str) {
+	std::u16string r{};
+	r.reserve(str.size());
+
+	auto bytes = reinterpret_cast<const unsigned char*>(str.data());
+	std::size_t i = 0;
+
+	while (i < str.size()) {
+		std::uint32_t c = bytes[i];
+		std::size_t length = 1;
+		std::uint32_t min = 0;
+
+		if (c < 0x80) {
+			length = 1;
+		} else if ((c & 0xe0) == 0xc0) {
+			length = 2;
+			c &= 0x1f;
+			min = 0x80;
+		} else if ((c & 0xf0) == 0xe0) {
+			length = 3;
+			c &= 0x0f;
+			min = 0x800;
+		} else if ((c & 0xf8) == 0xf0) {
+			length = 4;
+			c &= 0x07;
+			min = 0x10000;
+		} else {
+			return Err("utf8ToUtf16: invalid lead byte");
+		}
+
+		if (i + length > str.size()) {
+			return Err("utf8ToUtf16: truncated sequence");
+		}
+
+		for (std::size_t j = 1; j < length; j++) {
+			if ((bytes[i + j] & 0xc0) != 0x80) {
+				return Err("utf8ToUtf16: invalid continuation byte");
+			}
+
+			c = (c << 6) | (bytes[i + j] & 0x3f);
+		}
+
+		if (c < min || c > 0x10ffff || (c >= 0xd800 && c < 0xe000)) {
+			return Err("utf8ToUtf16: invalid code point");
+		}
+
+		if (c >= 0x10000) {
+			c -= 0x10000;
+			r += static_cast<char16_t>(0xd800 + (c >> 10));
+			r += static_cast<char16_t>(0xdc00 + (c & 0x3ff));
+		} else {
+			r += static_cast<char16_t>(c);
+		}
+
+		i += length;
+	}
+
+	return Ok(std::move(r));
+}
@@ -0,0 +1,393 @@
+#include <Geode/Geode.hpp>
+#include <Geode/modify/MenuLayer.hpp>
+
+#include <launcher-utils/geode.hpp>
+
+#include "base.hpp"
+#include "checks.hpp"
+
+#include <array>
+#include <barrier>
+#include <chrono>
+#include <random>
+#include <thread>
+
+namespace {
+	struct TestMethod {
+		const char* className;
+		const char* methodName;
+		const char* signature;
+		bool isStatic;
+	};
+
+	// only system classes can be found from natively attached threads
+	constexpr std::array s_testMethods = {
+		TestMethod{"java/lang/Math", "abs", "(I)I", true},
+		TestMethod{"java/lang/Integer", "valueOf", "(I)Ljava/lang/Integer;", true},
+		TestMethod{"java/lang/Long", "valueOf", "(J)Ljava/lang/Long;", true},
+		TestMethod{"java/lang/Boolean", "valueOf", "(Z)Ljava/lang/Boolean;", true},
+		TestMethod{"java/lang/System", "currentTimeMillis", "()J", true},
+		TestMethod{"java/lang/System", "nanoTime", "()J", true},
+		TestMethod{"java/lang/String", "valueOf", "(I)Ljava/lang/String;", true},
+		TestMethod{"java/lang/Thread", "currentThread", "()Ljava/lang/Thread;", true},
+		TestMethod{"java/lang/String", "length", "()I", false},
+		TestMethod{"java/lang/Object", "hashCode", "()I", false},
+		TestMethod{"java/lang/Throwable", "getMessage", "()Ljava/lang/String;", false},
+		TestMethod{"java/lang/Thread", "getName", "()Ljava/lang/String;", false},
+	};
+
+	launcher_utils::jni::MethodInfo* lookupMethod(JNIEnv* env, const TestMethod& method) {
+		auto res = method.isStatic
+			? launcher_utils::jni::getStaticMethodInfo(env, method.className, method.methodName, method.signature)
+			: launcher_utils::jni::getMethodInfo(env, method.className, method.methodName, method.signature);
+
+		return res ? &res.unwrap() : nullptr;
+	}
+
+	/**
+	 * The jstring conversion used before the ASCII fast path, kept for comparison.
+	 */
+	geode::Result<std::string> toStringReference(JNIEnv* env, jstring string) {
+		auto chars = env->GetStringChars(string, nullptr);
+		std::u16string_view strData{
+			reinterpret_cast<const char16_t*>(chars),
+			static_cast<std::size_t>(env->GetStringLength(string))
+		};
+
+		auto r = geode::utils::string::utf16ToUtf8(strData);
+		env->ReleaseStringChars(string, chars);
+
+		return r;
+	}
+
+	/**
+	 * Builds a string of the given length where roughly `nonAsciiRatio` of the characters are not ASCII.
+	 */
+	std::u16string makeTestString(std::size_t length, double nonAsciiRatio, std::mt19937& rng) {
+		std::uniform_real_distribution<> chanceDist{0.0, 1.0};
+		std::uniform_int_distribution<int> asciiDist{0x20, 0x7e};
+		std::uniform_int_distribution<int> otherDist{0xa0, 0x7ff};
+
+		std::u16string str(length, u' ');
+		for (auto& c : str) {
+			c = static_cast<char16_t>(chanceDist(rng) < nonAsciiRatio ? otherDist(rng) : asciiDist(rng));
+		}
+
+		return str;
+	}
+
+	/**
+	 * Runs the callback on `count` threads attached to the JVM, all starting at the same time.
+	 */
+	template <typename F>
+	void runAttached(int count, F&& callback) {
+		auto vm = cocos2d::JniHelper::getJavaVM();
+		std::barrier start(count);
+
+		std::vector<std::thread> threads{};
+		for (int i = 0; i < count; i++) {
+			threads.emplace_back([&, i]() {
+				JNIEnv* env = nullptr;
+				vm->AttachCurrentThread(&env, nullptr);
+
+				start.arrive_and_wait();
+				callback(env, i);
+
+				vm->DetachCurrentThread();
+			});
+		}
+
+		for (auto& thread : threads) {
+			thread.join();
+		}
+	}
+}
+
+class JniTestLayer : public BaseTestLayer {
+	void onStress() {
+		constexpr int threadCount = 8;
+		constexpr int rounds = 10'000;
+
+		std::vector<std::vector<launcher_utils::jni::MethodInfo*>> results(threadCount);
+		std::atomic_int failures{0};
+
+		// every thread misses on the same keys at the same time, then keeps looking them up
+		runAttached(threadCount, [&](JNIEnv* env, int idx) {
+			auto& found = results[idx];
+			for (const auto& method : s_testMethods) {
+				found.push_back(lookupMethod(env, method));
+			}
+
+			for (int i = 0; i < rounds; i++) {
+				auto& method = s_testMethods[(i + idx) % s_testMethods.size()];
+				if (lookupMethod(env, method) != found[(i + idx) % s_testMethods.size()]) {
+					failures++;
+				}
+			}
+		});
+
+		for (int i = 1; i < threadCount; i++) {
+			if (results[i] != results[0]) {
+				failures++;
+			}
+		}
+
+		if (std::find(results[0].begin(), results[0].end(), nullptr) != results[0].end()) {
+			addLogLine("stress: some methods failed to resolve");
+		}
+
+		auto stats = launcher_utils::jni::getCacheStats();
+		addLogLine(fmt::format(
+			"stress: {} threads, {} mismatches, cache entries={} capacity={} maxProbe={}",
+			threadCount, failures.load(), stats.entries, stats.capacity, stats.maxProbeLength
+		));
+	}
+
+	void onBenchmark() {
+		constexpr int lookupsPerThread = 200'000;
+
+		for (int threadCount : {1, 2, 4, 8}) {
+			auto begin = std::chrono::steady_clock::now();
+
+			runAttached(threadCount, [&](JNIEnv* env, int idx) {
+				for (int i = 0; i < lookupsPerThread; i++) {
+					lookupMethod(env, s_testMethods[(i + idx) % s_testMethods.size()]);
+				}
+			});
+
+			auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+			auto total = static_cast<double>(lookupsPerThread) * threadCount;
+
+			addLogLine(fmt::format(
+				"lookup: {} threads, {:.2f}M lookups/s ({:.1f}ns/lookup/thread)",
+				threadCount, total / elapsed / 1'000'000.0, elapsed * 1'000'000'000.0 / lookupsPerThread
+			));
+		}
+	}
+
+	void onAttach() {
+		launcher_utils::jni::setAutoAttach(true);
+
+		std::atomic_int failures{0};
+		std::vector<std::thread> threads{};
+		for (int i = 0; i < 4; i++) {
+			threads.emplace_back([&]() {
+				// the second call should reuse the environment from the first
+				auto first = launcher_utils::jni::getEnv();
+				auto second = launcher_utils::jni::getEnv();
+				if (!first || !second || first.unwrap() != second.unwrap()) {
+					failures++;
+					return;
+				}
+
+				if (!launcher_utils::jni::callStaticMethod<jint(jint), "java/lang/Math", "abs">(-5)) {
+					failures++;
+				}
+			});
+		}
+
+		for (auto& thread : threads) {
+			thread.join();
+		}
+
+		launcher_utils::jni::setAutoAttach(false);
+
+		auto stats = launcher_utils::jni::getAttachStats();
+		addLogLine(fmt::format(
+			"attach: {} failures, attached={} detached={}",
+			failures.load(), stats.attached, stats.detached
+		));
+	}
+
+	void onFrame() {
+		auto devices = launcher_utils::getConnectedDevices();
+		if (!devices) {
+			addLogLine(fmt::format("frame: failed to get devices: {}", devices.unwrapErr()));
+			return;
+		}
+
+		auto env = launcher_utils::jni::getEnv().unwrap();
+		auto& ids = devices.unwrap();
+
+		auto frame = launcher_utils::jni::LocalFrame::push(env, static_cast<jint>(ids.size() * 2));
+		if (!frame) {
+			addLogLine(fmt::format("frame: {}", frame.unwrapErr()));
+			return;
+		}
+
+		std::vector<std::string> names{};
+		for (auto id : ids) {
+			auto device = launcher_utils::jni::callStaticMethod<jobject, "com/geode/launcher/utils/GeodeUtils", "getDevice", "(I)Landroid/view/InputDevice;">(env, id);
+			if (!device) {
+				continue;
+			}
+
+			auto name = launcher_utils::jni::callMethod<std::string, "android/view/InputDevice", "getName", "()Ljava/lang/String;">(env, *device.unwrap());
+			names.push_back(name.unwrapOr("?"));
+		}
+
+		frame.unwrap().pop();
+
+		addLogLine(fmt::format("frame: {}", names));
+	}
+
+	void onStringBenchmark() {
+		auto env = launcher_utils::jni::getEnv().unwrap();
+		std::mt19937 rng{1234};
+
+		constexpr int iterations = 20'000;
+
+		for (std::size_t length : {8, 32, 128, 512, 4096}) {
+			for (double ratio : {0.0, 0.01, 0.5}) {
+				auto str = makeTestString(length, ratio, rng);
+				auto jstr = launcher_utils::jni::LocalRef(
+					env->NewString(reinterpret_cast<const jchar*>(str.data()), static_cast<jsize>(str.size()))
+				);
+
+				auto referenceBegin = std::chrono::steady_clock::now();
+				for (int i = 0; i < iterations; i++) {
+					(void)toStringReference(env, jstr.get<jstring>());
+				}
+				auto referenceTime = std::chrono::steady_clock::now() - referenceBegin;
+
+				std::string out{};
+				auto fastBegin = std::chrono::steady_clock::now();
+				for (int i = 0; i < iterations; i++) {
+					(void)launcher_utils::jni::toString(env, jstr.get<jstring>(), out);
+				}
+				auto fastTime = std::chrono::steady_clock::now() - fastBegin;
+
+				auto matches = toStringReference(env, jstr.get<jstring>()).unwrapOrDefault() == out;
+
+				addLogLine(fmt::format(
+					"toString len={} nonAscii={}: {:.1f}ns -> {:.1f}ns{}",
+					length, ratio,
+					std::chrono::duration<double, std::nano>(referenceTime).count() / iterations,
+					std::chrono::duration<double, std::nano>(fastTime).count() / iterations,
+					matches ? "" : " (MISMATCH)"
+				));
+			}
+		}
+	}
+
+	void onFakeJvm() {
+		auto results = runFakeJvmChecks();
+
+		addLogLine(fmt::format(
+			"fake jvm: {} failures {}, live local refs={}, local refs created={}, live global refs={}",
+			results.failures.size(), results.failures,
+			results.refs.liveLocalRefs, results.refs.localRefsCreated, results.refs.liveGlobalRefs
+		));
+	}
+
+	virtual bool init() override {
+		if (!BaseTestLayer::init()) {
+			return false;
+		}
+
+		auto winSize = cocos2d::CCDirector::sharedDirector()->getWinSize();
+
+		auto testMenu = cocos2d::CCMenu::create();
+
+		auto stressButton = geode::cocos::CCMenuItemExt::createSpriteExtra(
+			ButtonSprite::create("Cache Stress"),
+			[this](auto) {
+				onStress();
+			}
+		);
+		testMenu->addChild(stressButton);
+
+		auto benchmarkButton = geode::cocos::CCMenuItemExt::createSpriteExtra(
+			ButtonSprite::create("Cache Bench"),
+			[this](auto) {
+				onBenchmark();
+			}
+		);
+		testMenu->addChild(benchmarkButton);
+
+		auto attachButton = geode::cocos::CCMenuItemExt::createSpriteExtra(
+			ButtonSprite::create("Attach"),
+			[this](auto) {
+				onAttach();
+			}
+		);
+		testMenu->addChild(attachButton);
+
+		auto frameButton = geode::cocos::CCMenuItemExt::createSpriteExtra(
+			ButtonSprite::create("Local Frame"),
+			[this](auto) {
+				onFrame();
+			}
+		);
+		testMenu->addChild(frameButton);
+
+		auto stringButton = geode::cocos::CCMenuItemExt::createSpriteExtra(
+			ButtonSprite::create("String Bench"),
+			[this](auto) {
+				onStringBenchmark();
+			}
+		);
+		testMenu->addChild(stringButton);
+
+		auto fakeButton = geode::cocos::CCMenuItemExt::createSpriteExtra(
+			ButtonSprite::create("Fake JVM"),
+			[this](auto) {
+				onFakeJvm();
+			}
+		);
+		testMenu->addChild(fakeButton);
+
+		testMenu->setLayout(
+			geode::SimpleColumnLayout::create()
+				->setGap(5.0f)
+		);
+		this->addChild(testMenu);
+		testMenu->setPosition(winSize/2);
+
+		return true;
+	}
+
+public:
+	static JniTestLayer* create() {
+		auto pRet = new JniTestLayer();
+		if (!pRet->init()) {
+			delete pRet;
+			return nullptr;
+		}
+
+		pRet->autorelease();
+		return pRet;
+	}
+};
+
+struct JniMenuLayer : geode::Modify<JniMenuLayer, MenuLayer> {
+	virtual bool init() override {
+		if (!MenuLayer::init()) {
+			return false;
+		}
+
+		auto jniSprite = cocos2d::CCSprite::createWithSpriteFrameName("GJ_optionsBtn02_001.png");
+		auto jniButton = CCMenuItemSpriteExtra::create(
+			jniSprite,
+			this,
+			menu_selector(JniMenuLayer::onJni)
+		);
+
+		auto menu = this->getChildByID("bottom-menu");
+		menu->addChild(jniButton);
+
+		jniButton->setID("jni-btn"_spr);
+		menu->updateLayout();
+
+		return true;
+	}
+
+	void onJni(CCObject*) {
+		auto scene = cocos2d::CCScene::create();
+		scene->addChild(JniTestLayer::create());
+
+		cocos2d::CCDirector::sharedDirector()->pushScene(
+			cocos2d::CCTransitionFade::create(0.5f, scene)
+		);
+	}
+};
@@ -2,9 +2,11 @@
 #include <Geode/modify/MenuLayer.hpp>
 
 #include <launcher-utils/geode.hpp>
+#include <launcher-utils/haptics.hpp>
 
 #include "base.hpp"
 
+#include <chrono>
 #include <random>
 
 namespace {
@@ -38,6 +40,29 @@ class VibrationTestLayer : public BaseTestLayer {
 
 			vibrateMenu->addChild(vibrateButton);
 
+			auto asyncButton = geode::cocos::CCMenuItemExt::createSpriteExtra(
+				ButtonSprite::create("Vibrate (async)"),
+				[this](auto) {
+					static std::uniform_int_distribution<> lengthDist{0, 1000};
+
+					auto len = lengthDist(rng);
+					auto queued = std::chrono::steady_clock::now();
+					addLogLine(fmt::format("queueing vibration for {}ms", len));
+
+					// keep the layer alive until the result arrives
+					launcher_utils::vibrateAsync(len, [self = geode::Ref(this), queued](geode::Result<> res) {
+						auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - queued);
+						if (!res) {
+							self->addLogLine(fmt::format("async vibrate failed: {}", res.unwrapErr()));
+							return;
+						}
+
+						self->addLogLine(fmt::format("async vibrate finished after {}us", elapsed.count()));
+					});
+				}
+			);
+			vibrateMenu->addChild(asyncButton);
+
 			auto patternButton = geode::cocos::CCMenuItemExt::createSpriteExtra(
 				ButtonSprite::create("Pattern"),
 				[this](auto) {
@@ -61,6 +86,22 @@ class VibrationTestLayer : public BaseTestLayer {
 			);
 			vibrateMenu->addChild(patternButton);
 
+			auto burstButton = geode::cocos::CCMenuItemExt::createSpriteExtra(
+				ButtonSprite::create("Burst (scheduled)"),
+				[this](auto) {
+					static std::uniform_int_distribution<> lengthDist{10, 200};
+
+					// like a hit effect firing for every collision in a frame, this becomes a single call
+					for (int i = 0; i < 10; i++) {
+						launcher_utils::HapticsScheduler::get().vibrate(lengthDist(rng));
+					}
+
+					auto stats = launcher_utils::HapticsScheduler::get().stats();
+					addLogLine(fmt::format("queued 10 vibrations ({} requests, {} calls so far)", stats.requests, stats.calls));
+				}
+			);
+			vibrateMenu->addChild(burstButton);
+
 			auto cancelButton = geode::cocos::CCMenuItemExt::createSpriteExtra(
 				ButtonSprite::create("Cancel"),
 				[this](auto) {